@@ -0,0 +1,23 @@
+// Benchmark entry point. Adds the library's build and CPU details to the context block of
+// every report, so JSON results from different machines or builds are never compared blind.
+
+#include "camera_interface/convert.hpp"
+
+#include <benchmark/benchmark.h>
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::AddCustomContext("camera_interface_simd", camera_interface::to_string(
+                                                              camera_interface::detected_simd_level()));
+#ifdef NDEBUG
+    benchmark::AddCustomContext("camera_interface_build", "release");
+#else
+    benchmark::AddCustomContext("camera_interface_build", "debug");
+#endif
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
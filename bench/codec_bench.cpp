@@ -0,0 +1,83 @@
+// Recording codec: encode and decode throughput of a 1080p RGGB frame per predictor, with
+// the compression ratio as a counter. The frame is a smooth gradient plus sensor-like
+// noise, so the ratio is representative of real footage rather than of a test pattern.
+//
+//   camera_interface_bench --benchmark_filter=Codec
+
+#include "camera_interface/frame_codec.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+using namespace camera_interface;
+
+const StreamFormat kFormat = StreamFormat::packed(1920, 1080, PixelFormat::bayer_rggb8);
+
+std::vector<std::byte> noisy_frame()
+{
+    std::vector<std::byte> frame(kFormat.frame_size());
+    std::mt19937 rng(7);
+    std::normal_distribution<float> noise(0.0f, 2.0f);
+    for (std::uint32_t y = 0; y < kFormat.height; ++y)
+        for (std::uint32_t x = 0; x < kFormat.width; ++x) {
+            const float value = 64.0f + 0.05f * x + 0.08f * y + 24.0f * ((x ^ y) & 1) + noise(rng);
+            frame[std::size_t{y} * kFormat.stride + x] = static_cast<std::byte>(static_cast<std::uint8_t>(value));
+        }
+    return frame;
+}
+
+FrameCodecConfig config_for(const benchmark::State& state)
+{
+    FrameCodecConfig config;
+    config.codec = FrameCodec::delta_lz4;
+    config.predictor = static_cast<DeltaPredictor>(state.range(0));
+    return config;
+}
+
+void BM_CodecEncode(benchmark::State& state)
+{
+    const std::vector<std::byte> frame = noisy_frame();
+    FrameEncoder encoder(kFormat, config_for(state));
+    std::vector<std::byte> encoded(encoder.max_encoded_size());
+    std::size_t size = 0;
+    for (auto _ : state) {
+        size = encoder.encode(frame.data(), frame.size(), encoded.data());
+        benchmark::DoNotOptimize(size);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(frame.size()));
+    state.counters["ratio"] = static_cast<double>(frame.size()) / static_cast<double>(size);
+}
+
+void BM_CodecDecode(benchmark::State& state)
+{
+    const std::vector<std::byte> frame = noisy_frame();
+    FrameEncoder encoder(kFormat, config_for(state));
+    std::vector<std::byte> encoded(encoder.max_encoded_size());
+    encoded.resize(encoder.encode(frame.data(), frame.size(), encoded.data()));
+    std::vector<std::byte> decoded(frame.size());
+    for (auto _ : state) {
+        if (!decode_frame(encoded, decoded.data(), decoded.size())) {
+            state.SkipWithError("decode failed");
+            return;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(frame.size()));
+}
+
+void predictors(benchmark::internal::Benchmark* b)
+{
+    b->ArgName("predictor");
+    for (DeltaPredictor predictor : {DeltaPredictor::none, DeltaPredictor::left, DeltaPredictor::up})
+        b->Arg(static_cast<int>(predictor));
+}
+
+BENCHMARK(BM_CodecEncode)->Apply(predictors)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CodecDecode)->Apply(predictors)->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,79 @@
+// Every pixel conversion kernel at VGA, 1080p and 4K, once per instruction set the CPU
+// supports, e.g. `BM_Convert/yuyv->rgb8/1920x1080/avx2`.
+//
+//   camera_interface_bench --benchmark_filter=Convert
+
+#include "camera_interface/convert.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace camera_interface;
+
+struct Resolution {
+    std::uint32_t width;
+    std::uint32_t height;
+};
+
+constexpr Resolution kResolutions[] = {{640, 480}, {1920, 1080}, {3840, 2160}};
+
+constexpr std::pair<PixelFormat, PixelFormat> kConversions[] = {
+    {PixelFormat::bayer_rggb8, PixelFormat::rgb8},
+    {PixelFormat::yuyv, PixelFormat::rgb8},
+    {PixelFormat::uyvy, PixelFormat::rgb8},
+    {PixelFormat::nv12, PixelFormat::rgb8},
+    {PixelFormat::i420, PixelFormat::rgb8},
+    {PixelFormat::mono16, PixelFormat::mono8},
+};
+
+void run(benchmark::State& state, PixelFormat from, PixelFormat to, Resolution size, SimdLevel level)
+{
+    const StreamFormat src_format = StreamFormat::packed(size.width, size.height, from);
+    const StreamFormat dst_format = StreamFormat::packed(size.width, size.height, to);
+    // Fixed contents so runs are comparable; the kernels are data-independent anyway.
+    std::vector<std::byte> src(src_format.frame_size());
+    for (std::size_t i = 0; i < src.size(); ++i)
+        src[i] = static_cast<std::byte>(i * 31 + (i >> 11));
+    std::vector<std::byte> dst(dst_format.frame_size());
+
+    const SimdLevel previous = active_simd_level();
+    set_simd_level(level);
+    for (auto _ : state) {
+        convert(ConstImageView{src.data(), src_format}, ImageView{dst.data(), dst_format});
+        benchmark::ClobberMemory();
+    }
+    set_simd_level(previous);
+
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(src.size()));
+    state.counters["pixels"] = benchmark::Counter(
+        static_cast<double>(state.iterations()) * size.width * size.height, benchmark::Counter::kIsRate);
+}
+
+bool register_benchmarks()
+{
+    std::vector<SimdLevel> levels{SimdLevel::scalar};
+    if (detected_simd_level() >= SimdLevel::sse42)
+        levels.push_back(SimdLevel::sse42);
+    if (detected_simd_level() >= SimdLevel::avx2)
+        levels.push_back(SimdLevel::avx2);
+
+    for (const auto& [from, to] : kConversions)
+        for (const Resolution size : kResolutions)
+            for (const SimdLevel level : levels) {
+                const std::string name = std::string("BM_Convert/") + to_string(from) + "->" + to_string(to) + "/"
+                                       + std::to_string(size.width) + "x" + std::to_string(size.height) + "/"
+                                       + to_string(level);
+                benchmark::RegisterBenchmark(name.c_str(), run, from, to, size, level)
+                    ->Unit(benchmark::kMicrosecond);
+            }
+    return true;
+}
+
+const bool registered = register_benchmarks();
+
+} // namespace
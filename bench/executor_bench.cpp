@@ -0,0 +1,90 @@
+// Scaling of the tiled executor with worker count on a 20 MP Bayer frame.
+//
+//   camera_interface_bench --benchmark_filter=Executor
+
+#include "camera_interface/frame_executor.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+namespace {
+
+using namespace camera_interface;
+
+constexpr std::uint32_t kWidth = 5472;
+constexpr std::uint32_t kHeight = 3648;
+
+/// Worker counts 1, 2, 4, ... up to the machine's hardware threads.
+void worker_counts(benchmark::internal::Benchmark* b)
+{
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned n = 1; n < cores; n *= 2)
+        b->Arg(n);
+    b->Arg(cores);
+}
+
+FrameHandle make_input(FrameBufferPool& pool, const StreamFormat& format)
+{
+    FrameHandle frame = pool.acquire();
+    frame.info().format = format;
+    frame.info().bytes_used = format.frame_size();
+    for (std::size_t i = 0; i < format.frame_size(); ++i)
+        frame.data()[i] = static_cast<std::byte>(i * 7);
+    return frame;
+}
+
+void run(benchmark::State& state, ExecutionMode mode, FrameTransform transform)
+{
+    const StreamFormat input = StreamFormat::packed(kWidth, kHeight, PixelFormat::bayer_rggb8);
+    FrameBufferPool source(FrameBufferPool::Config{1, input.frame_size()});
+    const FrameHandle frame = make_input(source, input);
+
+    FrameExecutorConfig config;
+    config.input = input;
+    config.transform = transform;
+    config.mode = mode;
+    config.pool_capacity = 4;
+    FrameExecutor executor(std::make_shared<ThreadPool>(static_cast<unsigned>(state.range(0))), config);
+
+    for (auto _ : state) {
+        if (mode == ExecutionMode::latency) {
+            benchmark::DoNotOptimize(executor.process(frame));
+        } else {
+            // Keep every output frame busy; results are dropped as soon as they are popped.
+            while (!executor.submit(frame))
+                executor.results().pop(std::chrono::milliseconds(100));
+            executor.results().try_pop();
+        }
+    }
+    executor.wait_idle();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["pixels"] = benchmark::Counter(static_cast<double>(state.iterations()) * kWidth * kHeight,
+                                                  benchmark::Counter::kIsRate);
+}
+
+void BM_ExecutorConvertLatency(benchmark::State& state)
+{
+    run(state, ExecutionMode::latency, FrameTransform{});
+}
+
+void BM_ExecutorConvertThroughput(benchmark::State& state)
+{
+    run(state, ExecutionMode::throughput, FrameTransform{});
+}
+
+void BM_ExecutorCropDownscale(benchmark::State& state)
+{
+    FrameTransform transform;
+    transform.crop = Rect{736, 504, 4000, 2640};
+    transform.downscale = 2;
+    run(state, ExecutionMode::latency, transform);
+}
+
+} // namespace
+
+BENCHMARK(BM_ExecutorConvertLatency)->Apply(worker_counts)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ExecutorConvertThroughput)->Apply(worker_counts)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ExecutorCropDownscale)->Apply(worker_counts)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,64 @@
+// Frame statistics of a 1080p frame at grid steps 1, 2 and 4, once per instruction set the
+// CPU supports, e.g. `BM_FrameStats/bayer_rggb8/step4/avx2`. Bytes processed count the whole
+// frame, so the rate is comparable with the capture bandwidth it has to keep up with.
+//
+//   camera_interface_bench --benchmark_filter=FrameStats
+
+#include "camera_interface/frame_stats.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace camera_interface;
+
+constexpr PixelFormat kFormats[] = {PixelFormat::mono8, PixelFormat::bayer_rggb8, PixelFormat::yuyv};
+constexpr std::uint32_t kSteps[] = {1, 2, 4};
+
+void run(benchmark::State& state, PixelFormat pixel_format, std::uint32_t step, SimdLevel level)
+{
+    const StreamFormat format = StreamFormat::packed(1920, 1080, pixel_format);
+    std::vector<std::byte> frame(format.frame_size());
+    for (std::size_t i = 0; i < frame.size(); ++i)
+        frame[i] = static_cast<std::byte>(i * 31 + (i >> 11));
+
+    FrameStatsConfig config;
+    config.step = step;
+    FrameStatsCollector collector(config);
+    FrameStats stats;
+    const SimdLevel previous = active_simd_level();
+    set_simd_level(level);
+    for (auto _ : state) {
+        collector.collect(ConstImageView{frame.data(), format}, stats);
+        benchmark::DoNotOptimize(stats);
+    }
+    set_simd_level(previous);
+
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(frame.size()));
+    state.counters["samples"] = stats.samples;
+}
+
+bool register_benchmarks()
+{
+    std::vector<SimdLevel> levels{SimdLevel::scalar};
+    if (detected_simd_level() >= SimdLevel::sse42)
+        levels.push_back(SimdLevel::sse42);
+    if (detected_simd_level() >= SimdLevel::avx2)
+        levels.push_back(SimdLevel::avx2);
+
+    for (const PixelFormat format : kFormats)
+        for (const std::uint32_t step : kSteps)
+            for (const SimdLevel level : levels) {
+                const std::string name = std::string("BM_FrameStats/") + to_string(format) + "/step"
+                                       + std::to_string(step) + "/" + to_string(level);
+                benchmark::RegisterBenchmark(name.c_str(), run, format, step, level)->Unit(benchmark::kMicrosecond);
+            }
+    return true;
+}
+
+const bool registered = register_benchmarks();
+
+} // namespace
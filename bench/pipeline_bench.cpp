@@ -0,0 +1,99 @@
+// End to end: a simulated 1080p camera delivering to a consumer thread, with and without a
+// conversion to RGB on the way. Latency benchmarks report the time from the frame's sensor
+// timestamp to the consumer as iteration time, plus percentiles.
+//
+//   camera_interface_bench --benchmark_filter=Camera
+
+#include "camera_interface/clock.hpp"
+#include "camera_interface/frame_executor.hpp"
+#include "camera_interface/metrics.hpp"
+#include "camera_interface/simulated_camera.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <memory>
+
+namespace {
+
+using namespace camera_interface;
+
+SimulatedCameraConfig camera_config(double frame_rate, bool realtime)
+{
+    SimulatedCameraConfig config;
+    config.format = StreamFormat::packed(1920, 1080, PixelFormat::bayer_rggb8);
+    config.frame_rate = frame_rate;
+    config.realtime = realtime;
+    config.pattern = TestPattern::none;
+    config.seed = 1;
+    return config;
+}
+
+void report(benchmark::State& state, const LatencyHistogram& latency)
+{
+    const HistogramSnapshot snapshot = latency.snapshot();
+    state.counters["p50_us"] = static_cast<double>(snapshot.percentile(50)) / 1e3;
+    state.counters["p99_us"] = static_cast<double>(snapshot.percentile(99)) / 1e3;
+    state.counters["max_us"] = static_cast<double>(snapshot.max) / 1e3;
+}
+
+void BM_CameraToConsumerLatency(benchmark::State& state)
+{
+    SimulatedCamera camera(camera_config(static_cast<double>(state.range(0)), true));
+    LatencyHistogram latency;
+    camera.start();
+    for (auto _ : state) {
+        const FrameHandle frame = camera.grab(std::chrono::seconds(1));
+        if (!frame) {
+            state.SkipWithError("camera stalled");
+            break;
+        }
+        const std::int64_t elapsed = monotonic_now_ns() - frame.info().timestamp_ns;
+        latency.record(elapsed);
+        state.SetIterationTime(static_cast<double>(elapsed) / 1e9);
+    }
+    camera.stop();
+    report(state, latency);
+}
+
+void BM_CameraConvertToConsumerLatency(benchmark::State& state)
+{
+    const SimulatedCameraConfig config = camera_config(static_cast<double>(state.range(0)), true);
+    SimulatedCamera camera(config);
+    FrameExecutorConfig executor_config;
+    executor_config.input = config.format;
+    FrameExecutor executor(nullptr, executor_config);
+    LatencyHistogram latency;
+    camera.start();
+    for (auto _ : state) {
+        const FrameHandle frame = camera.grab(std::chrono::seconds(1));
+        const FrameHandle rgb = frame ? executor.process(frame) : FrameHandle{};
+        if (!rgb) {
+            state.SkipWithError("camera stalled");
+            break;
+        }
+        const std::int64_t elapsed = monotonic_now_ns() - rgb.info().timestamp_ns;
+        latency.record(elapsed);
+        state.SetIterationTime(static_cast<double>(elapsed) / 1e9);
+    }
+    camera.stop();
+    report(state, latency);
+}
+
+void BM_CameraToConsumerThroughput(benchmark::State& state)
+{
+    // Free-running: frames are produced as fast as the consumer releases buffers.
+    SimulatedCamera camera(camera_config(1000.0, false));
+    camera.start();
+    for (auto _ : state)
+        benchmark::DoNotOptimize(camera.grab(std::chrono::seconds(1)));
+    camera.stop();
+    state.SetItemsProcessed(state.iterations());
+    state.counters["source_drops"] = static_cast<double>(camera.source_drops());
+}
+
+} // namespace
+
+BENCHMARK(BM_CameraToConsumerLatency)->Arg(120)->Iterations(600)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CameraConvertToConsumerLatency)->Arg(30)->Iterations(150)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CameraToConsumerThroughput)->UseRealTime()->Unit(benchmark::kMicrosecond);
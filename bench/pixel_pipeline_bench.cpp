@@ -0,0 +1,89 @@
+// Demosaic, crop and bilinear resize of a Bayer frame, fused into one `Pipeline` pass versus
+// the same stages run one after another through full-frame intermediates, e.g.
+// `BM_PixelPipeline/fused/3840x2160`.
+//
+//   camera_interface_bench --benchmark_filter=PixelPipeline
+
+#include "camera_interface/pixel_pipeline.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace camera_interface;
+
+struct Resolution {
+    std::uint32_t width;
+    std::uint32_t height;
+};
+
+constexpr Resolution kResolutions[] = {{1920, 1080}, {3840, 2160}};
+
+/// Central three quarters of the frame, scaled to half the frame size.
+struct Setup {
+    StreamFormat src_format;
+    Rect roi;
+    StreamFormat dst_format;
+    std::vector<std::byte> src;
+    std::vector<std::byte> dst;
+
+    explicit Setup(Resolution size)
+        : src_format(StreamFormat::packed(size.width, size.height, PixelFormat::bayer_rggb8)),
+          roi{size.width / 8, size.height / 8, size.width * 3 / 4, size.height * 3 / 4},
+          dst_format(StreamFormat::packed(size.width / 2, size.height / 2, PixelFormat::rgb8)),
+          src(src_format.frame_size()), dst(dst_format.frame_size())
+    {
+        for (std::size_t i = 0; i < src.size(); ++i)
+            src[i] = static_cast<std::byte>(i * 31 + (i >> 11));
+    }
+};
+
+void fused(benchmark::State& state, Resolution size)
+{
+    Setup s(size);
+    Pipeline pipeline{Demosaic<PixelFormat::bayer_rggb8>{}, Crop{s.roi},
+                      Resize<Bilinear>{s.dst_format.width, s.dst_format.height}};
+    for (auto _ : state) {
+        pipeline.run(ConstImageView{s.src.data(), s.src_format}, ImageView{s.dst.data(), s.dst_format});
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(s.src.size()));
+}
+
+void staged(benchmark::State& state, Resolution size)
+{
+    Setup s(size);
+    const StreamFormat rgb_format = StreamFormat::packed(size.width, size.height, PixelFormat::rgb8);
+    const StreamFormat crop_format = StreamFormat::packed(s.roi.width, s.roi.height, PixelFormat::rgb8);
+    std::vector<std::byte> rgb(rgb_format.frame_size());
+    std::vector<std::byte> cropped(crop_format.frame_size());
+    Pipeline<Demosaic<PixelFormat::bayer_rggb8>> demosaic;
+    Pipeline crop{Input<PixelFormat::rgb8>{}, Crop{s.roi}};
+    Pipeline resize{Input<PixelFormat::rgb8>{}, Resize<Bilinear>{s.dst_format.width, s.dst_format.height}};
+    for (auto _ : state) {
+        demosaic.run(ConstImageView{s.src.data(), s.src_format}, ImageView{rgb.data(), rgb_format});
+        crop.run(ConstImageView{rgb.data(), rgb_format}, ImageView{cropped.data(), crop_format});
+        resize.run(ConstImageView{cropped.data(), crop_format}, ImageView{s.dst.data(), s.dst_format});
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(s.src.size()));
+}
+
+bool register_benchmarks()
+{
+    for (const Resolution size : kResolutions) {
+        const std::string suffix = "/" + std::to_string(size.width) + "x" + std::to_string(size.height);
+        benchmark::RegisterBenchmark(("BM_PixelPipeline/fused" + suffix).c_str(), fused, size)
+            ->Unit(benchmark::kMicrosecond);
+        benchmark::RegisterBenchmark(("BM_PixelPipeline/staged" + suffix).c_str(), staged, size)
+            ->Unit(benchmark::kMicrosecond);
+    }
+    return true;
+}
+
+const bool registered = register_benchmarks();
+
+} // namespace
@@ -0,0 +1,97 @@
+// Capture-thread placement: sensor-to-consumer latency of a simulated 1080p camera whose
+// consumer reads every frame, with the threads left to the scheduler, pinned to cores of
+// one node with the buffers there too, and pinned with the buffers on another node. The
+// tail percentiles are the interesting part; compare runs on an otherwise busy host.
+//
+//   camera_interface_bench --benchmark_filter=Placement
+
+#include "camera_interface/clock.hpp"
+#include "camera_interface/metrics.hpp"
+#include "camera_interface/placement.hpp"
+#include "camera_interface/simulated_camera.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+
+#include <sched.h>
+
+namespace {
+
+using namespace camera_interface;
+
+enum Mode : std::int64_t { unpinned, pinned, remote_buffers };
+
+/// Reads one byte per cache line, as a consumer scanning the frame would.
+std::uint64_t touch(const FrameHandle& frame)
+{
+    const auto* data = reinterpret_cast<const std::uint8_t*>(frame.data());
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < frame.info().bytes_used; i += 64)
+        sum += data[i];
+    return sum;
+}
+
+void BM_PlacementLatency(benchmark::State& state)
+{
+    const auto mode = static_cast<Mode>(state.range(0));
+    if (mode == remote_buffers && numa_node_count() < 2) {
+        state.SkipWithError("needs two NUMA nodes");
+        return;
+    }
+
+    SimulatedCameraConfig config;
+    config.format = StreamFormat::packed(1920, 1080, PixelFormat::bayer_rggb8);
+    config.frame_rate = 240.0;
+    config.pattern = TestPattern::none;
+
+    // Capture and consumer get neighbouring cores of node 0; with a single core they share it.
+    PlacementPlanner planner;
+    const Placement consumer = planner.place(0);
+    if (mode != unpinned) {
+        config.placement = planner.place(0);
+        if (mode == remote_buffers)
+            config.placement.numa_node = numa_node_count() - 1;
+    }
+
+    cpu_set_t original;
+    ::sched_getaffinity(0, sizeof original, &original);
+    if (mode != unpinned)
+        pin_current_thread(consumer.cpu);
+
+    SimulatedCamera camera(config);
+    LatencyHistogram latency;
+    camera.start();
+    for (auto _ : state) {
+        const FrameHandle frame = camera.grab(std::chrono::seconds(1));
+        if (!frame) {
+            state.SkipWithError("camera stalled");
+            break;
+        }
+        benchmark::DoNotOptimize(touch(frame));
+        const std::int64_t elapsed = monotonic_now_ns() - frame.info().timestamp_ns;
+        latency.record(elapsed);
+        state.SetIterationTime(static_cast<double>(elapsed) / 1e9);
+    }
+    camera.stop();
+    ::sched_setaffinity(0, sizeof original, &original);
+
+    const HistogramSnapshot snapshot = latency.snapshot();
+    state.counters["p50_us"] = static_cast<double>(snapshot.percentile(50)) / 1e3;
+    state.counters["p99_us"] = static_cast<double>(snapshot.percentile(99)) / 1e3;
+    state.counters["p99.9_us"] = static_cast<double>(snapshot.percentile(99.9)) / 1e3;
+    state.counters["max_us"] = static_cast<double>(snapshot.max) / 1e3;
+    state.counters["pool_node"] = camera.pool().numa_node();
+}
+
+} // namespace
+
+BENCHMARK(BM_PlacementLatency)
+    ->ArgName("mode")
+    ->Arg(unpinned)
+    ->Arg(pinned)
+    ->Arg(remote_buffers)
+    ->Iterations(2400)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
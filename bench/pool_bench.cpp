@@ -0,0 +1,64 @@
+// Frame buffer pool: acquire/release round trips and handle copies, alone and with every
+// thread hammering one pool.
+//
+//   camera_interface_bench --benchmark_filter=Pool
+
+#include "camera_interface/frame_buffer_pool.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace camera_interface;
+
+FrameBufferPool& shared_pool()
+{
+    // Enough slots that contended threads never see the pool run dry.
+    static FrameBufferPool pool(FrameBufferPool::Config{256, 4096});
+    return pool;
+}
+
+void BM_PoolAcquireRelease(benchmark::State& state)
+{
+    FrameBufferPool& pool = shared_pool();
+    for (auto _ : state) {
+        FrameHandle frame = pool.acquire();
+        benchmark::DoNotOptimize(frame);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_PoolAcquireBatch(benchmark::State& state)
+{
+    // Holding several frames at once walks the free list instead of reusing the head slot.
+    FrameBufferPool& pool = shared_pool();
+    const auto batch = static_cast<std::size_t>(state.range(0));
+    std::vector<FrameHandle> held(batch);
+    for (auto _ : state) {
+        for (FrameHandle& frame : held)
+            frame = pool.acquire();
+        for (FrameHandle& frame : held)
+            frame.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(batch));
+}
+
+void BM_HandleCopy(benchmark::State& state)
+{
+    const FrameHandle frame = shared_pool().acquire();
+    for (auto _ : state) {
+        FrameHandle copy = frame;
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_PoolAcquireRelease)->ThreadRange(1, std::max(1u, std::thread::hardware_concurrency()))->UseRealTime();
+BENCHMARK(BM_PoolAcquireBatch)->Arg(4)->Arg(32);
+BENCHMARK(BM_HandleCopy)->ThreadRange(1, std::max(1u, std::thread::hardware_concurrency()))->UseRealTime();
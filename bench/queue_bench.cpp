@@ -0,0 +1,60 @@
+// Frame delivery queue: uncontended push/pop and a single consumer draining 1..N producer
+// threads.
+//
+//   camera_interface_bench --benchmark_filter=Queue
+
+#include "camera_interface/frame_queue.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace camera_interface;
+
+template <typename Queue>
+void BM_QueuePushPop(benchmark::State& state)
+{
+    FrameBufferPool pool(FrameBufferPool::Config{1, 64});
+    const FrameHandle frame = pool.acquire();
+    Queue queue(16);
+    for (auto _ : state) {
+        queue.push(frame);
+        benchmark::DoNotOptimize(queue.try_pop());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_QueueContended(benchmark::State& state)
+{
+    const auto producers = static_cast<std::size_t>(state.range(0));
+    FrameBufferPool pool(FrameBufferPool::Config{1, 64});
+    const FrameHandle frame = pool.acquire();
+    FrameQueue queue(64, OverflowPolicy::block);
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < producers; ++i)
+        threads.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed) && queue.push(frame)) {
+            }
+        });
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(queue.pop());
+
+    stop.store(true, std::memory_order_relaxed);
+    queue.close();
+    for (std::thread& thread : threads)
+        thread.join();
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_QueuePushPop<FrameQueue>);
+BENCHMARK(BM_QueuePushPop<SpscFrameQueue>);
+BENCHMARK(BM_QueueContended)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
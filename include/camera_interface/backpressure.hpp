@@ -0,0 +1,125 @@
+#pragma once
+
+#include "camera_interface/convert.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace camera_interface {
+
+class Camera;
+
+/// Reduced sensor readout: an optional crop followed by `binning` x `binning` binning.
+struct SensorWindow {
+    std::uint32_t binning = 1;
+    std::optional<Rect> roi;
+
+    bool operator==(const SensorWindow&) const = default;
+};
+
+/// Ways a stream can shed load, in the order a `BackpressurePolicy` lists them.
+enum class BackpressureAction {
+    decimate,          ///< Deliver only every Nth frame; always available.
+    reduce_frame_rate, ///< Ask the camera for a lower frame rate (`Camera::set_frame_rate()`).
+    reduce_window,     ///< Switch the camera to `BackpressurePolicy::window` (`Camera::set_window()`).
+};
+
+const char* to_string(BackpressureAction action) noexcept;
+
+/// When and how a camera sheds load for a slow consumer. Configured per stream through
+/// `DeliveryConfig::backpressure`.
+struct BackpressurePolicy {
+    /// Escalation order. Decimation and frame-rate reduction step by powers of two up to
+    /// their limits before the next action is tried; actions the camera rejects are skipped.
+    std::vector<BackpressureAction> actions{BackpressureAction::decimate};
+    /// Congested when the delivery queue reaches this fraction of its capacity...
+    double high_watermark = 0.75;
+    /// ...and clear again once it stays at or below this fraction.
+    double low_watermark = 0.25;
+    /// Also congested when a frame waits longer than this between dequeue and consumer;
+    /// 0 watches queue depth only.
+    std::chrono::nanoseconds max_latency{0};
+    /// How often the state is evaluated, measured on the delivery path.
+    std::chrono::milliseconds interval{100};
+    /// Consecutive congested intervals before shedding more load.
+    unsigned escalate_after = 2;
+    /// Consecutive clear intervals before restoring one step; a restore the camera refuses is
+    /// retried after as many again.
+    unsigned relax_after = 10;
+    std::uint32_t max_decimation = 8;
+    /// Lowest frame rate as a fraction of the camera's nominal one.
+    double min_frame_rate_scale = 0.25;
+    SensorWindow window{2, std::nullopt};
+};
+
+/// Where a stream currently sits on its policy's escalation ladder.
+struct BackpressureState {
+    unsigned level = 0; ///< Steps applied; 0 is full service.
+    std::uint32_t decimation = 1;
+    double frame_rate_scale = 1.0;
+    bool reduced_window = false;
+    std::uint64_t escalations = 0;
+    std::uint64_t relaxations = 0;
+    /// Frames withheld by decimation.
+    std::uint64_t decimated = 0;
+};
+
+/// Per-camera policy engine behind `DeliveryConfig::backpressure`.
+///
+/// Runs inline on the delivery path: every frame costs a counter check, and once per
+/// `interval` the peak queue depth and consumer latency seen since the last evaluation
+/// decide whether to move one step up or down the ladder. Camera controls are applied from
+/// the acquisition thread.
+class Backpressure {
+public:
+    Backpressure(Camera& camera, const BackpressurePolicy& policy, std::size_t queue_capacity);
+
+    /// Called by `Camera::deliver()` before queuing; false means the frame is decimated.
+    bool admit(std::size_t queue_size, std::int64_t now_ns) noexcept;
+    /// Called by the consumer path with the frame's dequeue-to-consumer latency.
+    void consumed(std::int64_t latency_ns) noexcept;
+
+    BackpressureState state() const noexcept;
+    const BackpressurePolicy& policy() const noexcept { return policy_; }
+
+private:
+    struct Step {
+        BackpressureAction action;
+        double value; ///< Decimation factor, frame-rate scale, or unused.
+    };
+
+    void evaluate(std::int64_t now_ns) noexcept;
+    /// Moves the camera and decimator to `level`; false if the camera rejected the change.
+    bool apply(unsigned level) noexcept;
+
+    Camera& camera_;
+    BackpressurePolicy policy_;
+    std::vector<Step> steps_;
+    std::size_t high_depth_ = 0;
+    std::size_t low_depth_ = 0;
+    double nominal_rate_ = 0.0;
+
+    // Acquisition thread only.
+    std::int64_t next_evaluation_ns_ = 0;
+    std::size_t peak_depth_ = 0;
+    unsigned congested_ = 0;
+    unsigned clear_ = 0;
+    std::uint64_t frame_counter_ = 0;
+    double applied_rate_scale_ = 1.0;
+    bool applied_window_ = false;
+
+    std::atomic<std::int64_t> peak_latency_ns_{0};
+    std::atomic<unsigned> level_{0};
+    std::atomic<std::uint32_t> decimation_{1};
+    std::atomic<double> frame_rate_scale_{1.0};
+    std::atomic<bool> reduced_window_{false};
+    std::atomic<std::uint64_t> escalations_{0};
+    std::atomic<std::uint64_t> relaxations_{0};
+    std::atomic<std::uint64_t> decimated_{0};
+};
+
+} // namespace camera_interface
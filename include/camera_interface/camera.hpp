@@ -0,0 +1,167 @@
+#pragma once
+
+#include "camera_interface/backpressure.hpp"
+#include "camera_interface/frame_buffer_pool.hpp"
+#include "camera_interface/frame_queue.hpp"
+#include "camera_interface/frame_stats.hpp"
+#include "camera_interface/metadata_log.hpp"
+#include "camera_interface/metrics.hpp"
+#include "camera_interface/pixel_format.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace camera_interface {
+
+class Camera;
+class FrameReactor;
+
+/// Awaitable returned by `Camera::next_frame()`.
+class NextFrame {
+public:
+    bool await_ready();
+    /// Throws std::logic_error if another coroutine is already waiting on the camera.
+    bool await_suspend(std::coroutine_handle<> waiter);
+    FrameHandle await_resume();
+
+private:
+    friend class Camera;
+    explicit NextFrame(Camera& camera) noexcept : camera_(&camera) {}
+
+    Camera* camera_;
+    FrameHandle frame_;
+};
+
+/// How a camera hands frames from its acquisition thread to the consumer.
+struct DeliveryConfig {
+    std::size_t queue_depth = 4; ///< Power of two.
+    OverflowPolicy overflow = OverflowPolicy::drop_oldest;
+    /// Record per-frame latency and queue-depth histograms (see `Camera::stats()`).
+    bool metrics = true;
+    /// Entries in the per-stream `MetadataLog` (power of two); 0 disables it.
+    std::size_t metadata_depth = 1024;
+    /// Shed load in a controlled way when the consumer falls behind; off when empty.
+    std::optional<BackpressurePolicy> backpressure;
+    /// Compute luminance statistics of every delivered frame on the acquisition thread (see
+    /// `FrameInfo::luma` and `Camera::frame_stats()`); off when empty.
+    std::optional<FrameStatsConfig> frame_stats;
+};
+
+/// Common interface implemented by every camera backend.
+///
+/// Backends hand out frames as `FrameHandle`s drawn from their own `FrameBufferPool` and
+/// publish them through `deliver()` into a lock-free `FrameQueue`, which `grab()` drains.
+/// A frame's memory is recycled when the consumer drops the last handle, so holding on to
+/// frames for too long starves acquisition.
+class Camera {
+public:
+    virtual ~Camera();
+
+    Camera(const Camera&) = delete;
+    Camera& operator=(const Camera&) = delete;
+
+    virtual void start() = 0;
+    virtual void stop() = 0;
+    virtual bool is_streaming() const noexcept = 0;
+
+    /// Format of the frames the camera delivers while streaming.
+    virtual StreamFormat format() const = 0;
+
+    virtual const FrameBufferPool& pool() const noexcept = 0;
+
+    /// Waits up to `timeout` for the next frame; returns an empty handle on timeout or
+    /// once the camera has stopped and its queue is drained.
+    FrameHandle grab(std::chrono::nanoseconds timeout);
+
+    /// Returns the next frame if one is ready, otherwise an empty handle.
+    FrameHandle try_grab();
+
+    /// `co_await camera.next_frame()` suspends the calling coroutine until a frame arrives
+    /// and resumes it on the thread running the camera's `FrameReactor`. Yields an empty
+    /// handle once the camera has stopped (or was never started) and its queue is drained.
+    /// Throws std::logic_error unless the camera is attached to a reactor.
+    NextFrame next_frame();
+
+    /// The delivery queue itself, for consumers that want to pop in bulk or inspect depth.
+    FrameQueue& frames() noexcept { return frames_; }
+    const FrameQueue& frames() const noexcept { return frames_; }
+
+    /// Live counters; null when `DeliveryConfig::metrics` was off.
+    const CameraMetrics* metrics() const noexcept { return metrics_.get(); }
+
+    /// Snapshot of the delivery metrics and drop counters. Histograms are empty when
+    /// metrics are off.
+    CameraStats stats() const;
+
+    /// Metadata of recently delivered frames; null when `DeliveryConfig::metadata_depth` is 0.
+    const MetadataLog* metadata() const noexcept { return metadata_.get(); }
+
+    /// Statistics of the latest delivered frame, histogram included; null unless
+    /// `DeliveryConfig::frame_stats` was set.
+    const LatestFrameStats* frame_stats() const noexcept { return latest_stats_.get(); }
+
+    /// Frames the backend lost before they reached the delivery queue.
+    virtual std::uint64_t source_drops() const noexcept { return 0; }
+
+    /// Nominal frame rate currently requested from the source; 0 when unknown.
+    virtual double frame_rate() const noexcept { return 0.0; }
+    /// Changes the frame rate while streaming. Returns false when the backend cannot.
+    virtual bool set_frame_rate(double) noexcept { return false; }
+    /// Switches to a cropped and/or binned readout while streaming, after which `format()`
+    /// and the frames' formats shrink accordingly; `SensorWindow{}` restores the full frame.
+    /// Returns false when the backend cannot.
+    virtual bool set_window(const SensorWindow&) noexcept { return false; }
+
+    /// Policy engine state; null unless `DeliveryConfig::backpressure` was set.
+    const Backpressure* backpressure() const noexcept { return backpressure_.get(); }
+
+protected:
+    explicit Camera(const DeliveryConfig& delivery = {});
+
+    /// Publishes a frame to consumers. Called from the acquisition thread. Stamps
+    /// `FrameInfo::host_timestamp_ns` unless the backend already did, fills in
+    /// `FrameInfo::drops` and, when enabled, `FrameInfo::luma`, and logs the frame's metadata.
+    /// Returns false for frames that were decimated by the backpressure policy or refused by
+    /// the queue.
+    bool deliver(FrameHandle frame);
+
+    /// Backends call these from `start()` / `stop()`; closing wakes blocked producers and consumers.
+    void open_delivery() noexcept { frames_.reopen(); }
+    void close_delivery() noexcept
+    {
+        frames_.close();
+        signal_waiter();
+    }
+
+private:
+    friend class FrameReactor;
+    friend class NextFrame;
+
+    FrameHandle consumed(std::optional<FrameHandle> frame) noexcept;
+
+    /// True when a frame (or end of stream) is ready; otherwise leaves a wake-up armed.
+    bool arm_waiter() noexcept;
+    void signal_waiter() noexcept;
+
+    FrameQueue frames_;
+    std::unique_ptr<CameraMetrics> metrics_;
+    std::unique_ptr<MetadataLog> metadata_;
+    std::unique_ptr<Backpressure> backpressure_;
+    std::unique_ptr<FrameStatsCollector> stats_collector_;
+    std::unique_ptr<LatestFrameStats> latest_stats_;
+    FrameStats stats_; ///< Scratch for the acquisition thread.
+
+    // Coroutine delivery, see `FrameReactor`. The waiter is only touched on the reactor
+    // thread; producers just flip `signal_armed_` and write the eventfd.
+    FrameReactor* reactor_ = nullptr;
+    int signal_fd_ = -1;
+    std::coroutine_handle<> waiter_;
+    std::atomic<bool> signal_armed_{false};
+};
+
+} // namespace camera_interface
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+
+namespace camera_interface {
+
+/// CLOCK_MONOTONIC in nanoseconds; the time base used for every frame timestamp.
+inline std::int64_t monotonic_now_ns() noexcept
+{
+    timespec ts{};
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+} // namespace camera_interface
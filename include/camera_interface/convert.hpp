@@ -0,0 +1,107 @@
+#pragma once
+
+#include "camera_interface/frame_buffer_pool.hpp"
+#include "camera_interface/pixel_format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace camera_interface {
+
+/// Non-owning view of a writable image.
+struct ImageView {
+    std::byte* data = nullptr;
+    StreamFormat format;
+};
+
+/// Non-owning view of a read-only image.
+struct ConstImageView {
+    const std::byte* data = nullptr;
+    StreamFormat format;
+
+    ConstImageView() = default;
+    ConstImageView(const std::byte* data, const StreamFormat& format) : data(data), format(format) {}
+    ConstImageView(const ImageView& view) : data(view.data), format(view.format) {}
+};
+
+/// Views of a frame's pixels as described by its `FrameInfo`.
+inline ImageView image_view(FrameHandle& frame) noexcept
+{
+    return ImageView{frame.data(), frame.info().format};
+}
+inline ConstImageView image_view(const FrameHandle& frame) noexcept
+{
+    return ConstImageView{frame.data(), frame.info().format};
+}
+
+/// Rectangle in pixel coordinates.
+struct Rect {
+    std::uint32_t x = 0;
+    std::uint32_t y = 0;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+
+    bool operator==(const Rect&) const = default;
+};
+
+/// Instruction set used by the conversion and frame statistics kernels.
+enum class SimdLevel { scalar, sse42, avx2 };
+
+const char* to_string(SimdLevel level) noexcept;
+
+/// Best level the CPU (and OS) supports.
+SimdLevel detected_simd_level() noexcept;
+/// Level currently in use; defaults to `detected_simd_level()`.
+SimdLevel active_simd_level() noexcept;
+/// Forces a level, clamped to what the CPU supports; meant for benchmarks and comparisons.
+void set_simd_level(SimdLevel level) noexcept;
+
+struct ConvertOptions {
+    /// Right shift applied by mono16 -> mono8 (8 keeps the top byte; 4 suits 12-bit sensors).
+    unsigned mono16_shift = 8;
+};
+
+/// True when `convert()` supports `from` -> `to`:
+/// Bayer (bilinear demosaic), YUYV, UYVY, NV12 and I420 to rgb8, and mono16 to mono8.
+/// `from == to` copies and is supported for every non-planar format.
+bool can_convert(PixelFormat from, PixelFormat to) noexcept;
+
+/// Converts a whole image. `dst` must have the same width and height as `src` and a
+/// format accepted by `can_convert()`; throws std::invalid_argument otherwise.
+void convert(const ConstImageView& src, const ImageView& dst, const ConvertOptions& options = {});
+
+/// Converts output rows [row_begin, row_end) only, reading whatever source rows they depend
+/// on. Disjoint row ranges can be converted concurrently.
+void convert_rows(const ConstImageView& src, const ImageView& dst, std::uint32_t row_begin,
+                  std::uint32_t row_end, const ConvertOptions& options = {});
+
+/// Crops and converts in one pass: output rows [row_begin, row_end) of region `roi` of `src`.
+/// `dst` must be `roi`-sized. The region is treated as an image of its own, so Bayer
+/// interpolation reflects at all four of its edges rather than reading pixels outside it;
+/// chroma-subsampled sources need an even `roi.x`.
+void convert_rows(const ConstImageView& src, const Rect& roi, const ImageView& dst, std::uint32_t row_begin,
+                  std::uint32_t row_end, const ConvertOptions& options = {});
+
+/// True for the formats `downscale_rows()` accepts: mono8, rgb8 and bgr8.
+bool can_downscale(PixelFormat format) noexcept;
+
+/// Packed format of `format` shrunk by `factor`; partial blocks at the edges are dropped.
+StreamFormat downscaled_format(const StreamFormat& format, std::uint32_t factor) noexcept;
+
+/// Box-filters `src` by an integer `factor` into output rows [row_begin, row_end) of `dst`,
+/// whose size must match `downscaled_format()`. Throws std::invalid_argument otherwise.
+void downscale_rows(const ConstImageView& src, const ImageView& dst, std::uint32_t factor, std::uint32_t row_begin,
+                    std::uint32_t row_end);
+
+namespace detail {
+
+/// The ROI `convert_rows()` without validation, writing region row `r` to row `r - row_begin`
+/// of `strip`. Lets a caller that checked the geometry up front convert a region a few rows at
+/// a time into a small buffer while Bayer rows still reflect only at the region's own edges.
+void convert_region_rows(const ConstImageView& src, const Rect& roi, PixelFormat to, std::byte* strip,
+                         std::size_t strip_stride, std::uint32_t row_begin, std::uint32_t row_end,
+                         const ConvertOptions& options) noexcept;
+
+} // namespace detail
+
+} // namespace camera_interface
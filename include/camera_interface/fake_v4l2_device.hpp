@@ -0,0 +1,87 @@
+#pragma once
+
+#include "camera_interface/pixel_format.hpp"
+#include "camera_interface/v4l2_io.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace camera_interface {
+
+/// Scripted stand-in for a V4L2 capture node.
+///
+/// Implements the streaming-I/O subset of the V4L2 ioctl API (QUERYCAP, ENUM_FMT,
+/// ENUM_FRAMESIZES, ENUM_FRAMEINTERVALS, G/S/TRY_FMT, G/S_PARM, REQBUFS, QUERYBUF, QBUF,
+/// DQBUF, STREAMON/OFF) for both `V4L2_MEMORY_MMAP` and `V4L2_MEMORY_DMABUF`, with an
+/// eventfd standing in for the device descriptor. Frames complete only when the owner
+/// calls `produce()`, so a test decides exactly when and what the "sensor" delivers.
+class FakeV4l2Device final : public V4l2Io {
+public:
+    struct Config {
+        StreamFormat format = StreamFormat::packed(640, 480, PixelFormat::yuyv);
+        std::string card = "Fake V4L2 device";
+        /// Added to every ioctl, to mimic devices behind a slow bus such as USB.
+        std::chrono::microseconds ioctl_latency{0};
+    };
+
+    /// Writes the pixel data of one frame.
+    using Fill = std::function<void(std::byte* data, const StreamFormat& format, std::uint64_t sequence)>;
+
+    FakeV4l2Device();
+    explicit FakeV4l2Device(const Config& config);
+    ~FakeV4l2Device() override;
+
+    int fd() const noexcept override { return event_fd_; }
+    int ioctl(unsigned long request, void* arg) noexcept override;
+    void* mmap(std::size_t length, std::int64_t offset) noexcept override;
+    void munmap(void* address, std::size_t length) noexcept override;
+
+    /// Completes the oldest queued buffer as if the sensor had finished a frame. Without a
+    /// `fill` a moving test pattern is written. When no buffer is queued the frame is lost,
+    /// exactly like a real driver: the sequence counter still advances and false is returned.
+    bool produce(const Fill& fill = {}, std::int64_t timestamp_ns = 0);
+
+    bool streaming() const;
+    std::size_t queued_buffers() const;
+    std::uint64_t lost_frames() const;
+
+private:
+    struct Buffer {
+        std::byte* data = nullptr;
+        std::size_t length = 0;
+        int dmabuf_fd = -1;
+        bool queued = false;
+        bool done = false;
+        std::uint32_t bytes_used = 0;
+        std::uint64_t sequence = 0;
+        std::int64_t timestamp_ns = 0;
+    };
+
+    int handle(unsigned long request, void* arg);
+    void release_buffers();
+
+    Config config_;
+    int event_fd_ = -1;
+
+    mutable std::mutex mutex_;
+    std::uint32_t memory_ = 0;
+    std::size_t buffer_pitch_ = 0;
+    std::byte* storage_ = nullptr;
+    std::vector<Buffer> buffers_;
+    std::deque<std::uint32_t> queued_;
+    std::deque<std::uint32_t> done_;
+    bool streaming_ = false;
+    std::uint64_t sequence_ = 0;
+    std::uint64_t lost_ = 0;
+    std::uint32_t fps_numerator_ = 30;
+    std::uint32_t fps_denominator_ = 1;
+};
+
+} // namespace camera_interface
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "camera_interface/pixel_format.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace camera_interface {
+
+/// Luminance summary of a frame on a decimated grid, in 8-bit luma units (see `frame_stats.hpp`).
+struct LumaStats {
+    float mean = 0.0f;
+    float variance = 0.0f;
+    float saturated = 0.0f; ///< Percentage of samples at or above the saturation level.
+    float focus = 0.0f;     ///< Variance of the Laplacian; higher is sharper.
+};
+
+/// Per-frame description, written by the producer before the handle is shared.
+struct FrameInfo {
+    StreamFormat format;
+    std::uint64_t sequence = 0;
+    std::int64_t timestamp_ns = 0; ///< CLOCK_MONOTONIC capture time.
+    std::size_t bytes_used = 0;
+    std::int64_t host_timestamp_ns = 0; ///< CLOCK_MONOTONIC time the host dequeued the frame.
+    std::uint32_t exposure_us = 0;      ///< Exposure time; 0 when the source does not report it.
+    float gain = 0.0f;                  ///< Sensor gain in source units; 0 when not reported.
+    std::uint64_t drops = 0;            ///< Frames the source had lost before this one.
+    /// Filled in on the capture thread when `DeliveryConfig::frame_stats` is set; zero otherwise.
+    LumaStats luma;
+};
+
+namespace detail {
+
+struct PoolState;
+
+struct FrameSlot {
+    std::atomic<std::uint32_t> refs{0};
+    std::atomic<std::uint32_t> next_free{0};
+    std::uint32_t index = 0;
+    std::byte* data = nullptr;
+    std::size_t capacity = 0;
+    FrameInfo info;
+    PoolState* state = nullptr;
+};
+
+void release_slot(FrameSlot* slot) noexcept;
+
+} // namespace detail
+
+/// Reference-counted handle to one pool buffer.
+///
+/// Copying a handle bumps an atomic counter; the buffer goes back to its pool (or to the
+/// driver, for externally backed pools) when the last handle is dropped. Handles stay
+/// valid after the pool object itself has been destroyed.
+class FrameHandle {
+public:
+    FrameHandle() noexcept = default;
+    FrameHandle(const FrameHandle& other) noexcept : slot_(other.slot_)
+    {
+        if (slot_)
+            slot_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    FrameHandle(FrameHandle&& other) noexcept : slot_(other.slot_) { other.slot_ = nullptr; }
+    FrameHandle& operator=(const FrameHandle& other) noexcept
+    {
+        FrameHandle(other).swap(*this);
+        return *this;
+    }
+    FrameHandle& operator=(FrameHandle&& other) noexcept
+    {
+        FrameHandle(std::move(other)).swap(*this);
+        return *this;
+    }
+    ~FrameHandle() { reset(); }
+
+    void reset() noexcept
+    {
+        if (slot_ && slot_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            detail::release_slot(slot_);
+        slot_ = nullptr;
+    }
+    void swap(FrameHandle& other) noexcept
+    {
+        detail::FrameSlot* tmp = slot_;
+        slot_ = other.slot_;
+        other.slot_ = tmp;
+    }
+
+    explicit operator bool() const noexcept { return slot_ != nullptr; }
+
+    std::byte* data() const noexcept { return slot_->data; }
+    std::size_t capacity() const noexcept { return slot_->capacity; }
+    std::uint32_t index() const noexcept { return slot_->index; }
+    FrameInfo& info() noexcept { return slot_->info; }
+    const FrameInfo& info() const noexcept { return slot_->info; }
+    std::uint32_t use_count() const noexcept
+    {
+        return slot_ ? slot_->refs.load(std::memory_order_relaxed) : 0;
+    }
+
+private:
+    friend class FrameBufferPool;
+    explicit FrameHandle(detail::FrameSlot* slot) noexcept : slot_(slot) {}
+
+    detail::FrameSlot* slot_ = nullptr;
+};
+
+/// Contiguous memory owned by someone else (driver mmap, shared memory, ...).
+struct BufferRegion {
+    std::byte* data = nullptr;
+    std::size_t size = 0;
+};
+
+/// Called with the slot index when the last handle to an external buffer is dropped.
+using ReleaseHook = std::function<void(std::uint32_t index)>;
+
+/// Fixed-capacity pool of pre-allocated frame buffers.
+///
+/// All memory is reserved up front; `acquire()` and handle release are lock-free and never
+/// touch the heap, so backends can call them from the acquisition thread at full frame rate.
+///
+/// A pool is either *managed* (it owns its storage and recycles slots through an internal
+/// free list) or *external* (it wraps buffers owned elsewhere; slots are claimed by index
+/// and handed back through a release hook, e.g. to re-queue a V4L2 buffer).
+class FrameBufferPool {
+public:
+    struct Config {
+        std::size_t capacity = 8;
+        std::size_t buffer_size = 0;
+        std::size_t alignment = 4096;
+        bool prefault = true; ///< Touch every page at construction so capture never faults.
+        /// Allocate the buffers on this NUMA node (see `Placement`); -1, or a build without
+        /// libnuma, uses the default policy. Throws std::invalid_argument for a missing node.
+        int numa_node = -1;
+    };
+
+    explicit FrameBufferPool(const Config& config);
+    FrameBufferPool(std::vector<BufferRegion> buffers, ReleaseHook on_release);
+    ~FrameBufferPool();
+
+    FrameBufferPool(const FrameBufferPool&) = delete;
+    FrameBufferPool& operator=(const FrameBufferPool&) = delete;
+
+    /// Takes a free buffer from a managed pool; returns an empty handle when exhausted.
+    FrameHandle acquire() noexcept;
+
+    /// Claims a specific buffer of an external pool; returns an empty handle if it is in use.
+    FrameHandle claim(std::uint32_t index) noexcept;
+
+    std::size_t capacity() const noexcept;
+    std::size_t buffer_size() const noexcept;
+    /// Number of buffers not currently referenced by any handle (approximate under contention).
+    std::size_t available() const noexcept;
+    bool is_external() const noexcept;
+    /// Node the buffers are bound to; -1 when they follow the default policy.
+    int numa_node() const noexcept;
+
+private:
+    detail::PoolState* state_;
+};
+
+} // namespace camera_interface
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "camera_interface/pixel_format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace camera_interface {
+
+class ThreadPool;
+
+/// Lossless codecs a recording can store frames with (`RecordingHeader::codec`).
+enum class FrameCodec : std::uint32_t {
+    none = 0,
+    delta_lz4 = 1, ///< Delta prediction, then LZ4 block compression, in independent row bands.
+};
+
+/// How a sample is predicted from its neighbours before compression. Bayer mosaics are
+/// predicted from the nearest sample of the same colour, mono16 in 16-bit arithmetic.
+enum class DeltaPredictor : std::uint8_t {
+    none,
+    left, ///< From the sample to the left; the first samples of a row are kept.
+    up,   ///< From the sample above; the first rows of a band fall back to `left`.
+};
+
+struct FrameCodecConfig {
+    FrameCodec codec = FrameCodec::none;
+    /// Used for mono and Bayer formats; other formats are compressed without prediction.
+    DeltaPredictor predictor = DeltaPredictor::left;
+    /// Rows per independently compressed band, the unit of parallel work.
+    std::uint32_t band_rows = 64;
+};
+
+/// Compresses frames of one format with `FrameCodec::delta_lz4`.
+///
+/// The bands of a frame are predicted and compressed concurrently on `pool` (the calling
+/// thread takes part), or one after another without a pool. Scratch space for a whole
+/// frame is allocated up front, so encoding never touches the heap. One frame at a time.
+class FrameEncoder {
+public:
+    /// Throws std::invalid_argument for an empty format or `band_rows == 0`.
+    FrameEncoder(const StreamFormat& format, const FrameCodecConfig& config, ThreadPool* pool = nullptr);
+    ~FrameEncoder();
+
+    FrameEncoder(const FrameEncoder&) = delete;
+    FrameEncoder& operator=(const FrameEncoder&) = delete;
+
+    /// Largest encoding of a frame of this format, i.e. the `dst` capacity `encode()` needs.
+    std::size_t max_encoded_size() const noexcept { return max_encoded_size_; }
+
+    /// Encodes the first `bytes` (at most the frame size) of `src` into `dst`; returns the
+    /// encoded size. Only whole frames are predicted.
+    std::size_t encode(const std::byte* src, std::size_t bytes, std::byte* dst) noexcept;
+
+private:
+    struct Band;
+
+    StreamFormat format_;
+    FrameCodecConfig config_;
+    ThreadPool* pool_;
+    std::size_t max_encoded_size_ = 0;
+    std::unique_ptr<Band[]> bands_;
+    std::unique_ptr<std::byte[]> scratch_;
+};
+
+/// Decodes a `FrameCodec::delta_lz4` frame into `dst`, which must hold exactly `bytes`
+/// (the frame's `bytes_used`). Bands are decoded concurrently on `pool` when given.
+/// Returns false, leaving `dst` unspecified, if `src` is not a valid encoding of that size.
+bool decode_frame(std::span<const std::byte> src, std::byte* dst, std::size_t bytes,
+                  ThreadPool* pool = nullptr) noexcept;
+
+} // namespace camera_interface
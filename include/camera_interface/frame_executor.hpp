@@ -0,0 +1,133 @@
+#pragma once
+
+#include "camera_interface/convert.hpp"
+#include "camera_interface/frame_buffer_pool.hpp"
+#include "camera_interface/frame_queue.hpp"
+#include "camera_interface/metrics.hpp"
+#include "camera_interface/pixel_format.hpp"
+#include "camera_interface/thread_pool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace camera_interface {
+
+/// Crop, convert and downscale, applied in that order.
+struct FrameTransform {
+    /// Region of the input to keep; the whole frame when empty.
+    std::optional<Rect> crop;
+    /// Conversion target; the input format itself means "copy" (see `can_convert()`).
+    PixelFormat output = PixelFormat::rgb8;
+    /// Integer box-filter factor applied after conversion; 1 disables it.
+    std::uint32_t downscale = 1;
+    ConvertOptions convert;
+};
+
+enum class ExecutionMode {
+    /// Split every frame into row bands across all workers so each frame finishes as soon as
+    /// possible.
+    latency,
+    /// One task per frame: no split overhead, cores are kept busy by having several frames in
+    /// flight through `submit()`.
+    throughput,
+};
+
+struct FrameExecutorConfig {
+    /// Format of the frames that will be fed in; the stride may differ per frame.
+    StreamFormat input;
+    FrameTransform transform;
+    ExecutionMode mode = ExecutionMode::latency;
+    /// Output rows per task; 0 derives it from the mode and the number of workers.
+    std::uint32_t band_rows = 0;
+    /// Output frames, which also bounds how many frames can be in flight.
+    std::size_t pool_capacity = 4;
+    /// Depth of `results()`; power of two.
+    std::size_t results_depth = 4;
+};
+
+/// Runs a `FrameTransform` on a `ThreadPool`, writing into frames of its own pool.
+///
+/// Each frame is cut into bands of output rows that are converted independently. When
+/// downscaling follows a conversion, every band converts `downscale` rows at a time into a
+/// small per-band strip and filters it straight away, so the full-resolution intermediate
+/// never exists. Band and strip storage is allocated once, per output frame.
+class FrameExecutor {
+public:
+    /// Throws std::invalid_argument if the transform cannot be applied to `config.input`.
+    /// A null `threads` gives the executor a pool of its own.
+    FrameExecutor(std::shared_ptr<ThreadPool> threads, const FrameExecutorConfig& config);
+    /// Waits for submitted frames to finish.
+    ~FrameExecutor();
+
+    FrameExecutor(const FrameExecutor&) = delete;
+    FrameExecutor& operator=(const FrameExecutor&) = delete;
+
+    const StreamFormat& output_format() const noexcept { return output_; }
+    const FrameBufferPool& pool() const noexcept { return pool_; }
+    ThreadPool& threads() noexcept { return *threads_; }
+    std::uint32_t bands() const noexcept { return bands_; }
+
+    /// Transforms `input` on the pool (the caller helps) and returns the result, or an empty
+    /// handle when every output frame is still held. Throws std::invalid_argument if `input`
+    /// does not match the configured format.
+    FrameHandle process(const FrameHandle& input);
+
+    /// Starts transforming `input` and returns immediately; the result is pushed to
+    /// `results()`. Returns false, and counts a drop, when no output frame is free.
+    bool submit(FrameHandle input);
+
+    FrameQueue& results() noexcept { return results_; }
+
+    /// Blocks until every submitted frame has reached `results()`.
+    void wait_idle();
+
+    /// Frames refused by `submit()` for lack of an output frame.
+    std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    /// Per-frame conversion time, from `process()`/`submit()` to the finished output frame.
+    ExecutorStats stats() const;
+
+private:
+    struct Job {
+        FrameExecutor* owner = nullptr;
+        FrameHandle input;
+        FrameHandle output;
+        std::atomic<std::size_t> remaining{0};
+        std::int64_t started_ns = 0;
+        std::vector<std::byte> strips; ///< `downscale` converted rows per band.
+    };
+
+    void check_input(const FrameHandle& input) const;
+    Job& start_job(const FrameHandle& input, FrameHandle output);
+    void run_band(Job& job, std::size_t band) const noexcept;
+    void finish(Job& job) noexcept;
+    void record(const Job& job) noexcept;
+    static void run_submitted(void* context, std::size_t band) noexcept;
+
+    std::shared_ptr<ThreadPool> threads_;
+    FrameExecutorConfig config_;
+    Rect roi_;
+    StreamFormat output_;
+    bool convert_then_scale_ = false;
+    std::size_t strip_stride_ = 0;
+    std::uint32_t band_rows_ = 0;
+    std::uint32_t bands_ = 0;
+
+    FrameBufferPool pool_;
+    std::vector<std::unique_ptr<Job>> jobs_;
+    FrameQueue results_;
+
+    std::mutex mutex_;
+    std::condition_variable idle_;
+    std::size_t in_flight_ = 0;
+    std::atomic<std::uint64_t> dropped_{0};
+    ExecutorMetrics metrics_;
+};
+
+} // namespace camera_interface
@@ -0,0 +1,264 @@
+#pragma once
+
+#include "camera_interface/frame_buffer_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace camera_interface {
+
+enum class ProducerMode { single, multiple };
+
+/// What `push()` does when the queue is full.
+enum class OverflowPolicy {
+    drop_oldest, ///< Evict the oldest queued element; the producer never waits.
+    block,       ///< Wait for the consumer to make room.
+};
+
+namespace detail {
+
+/// Sleep/wake point that costs a fence and a load when nobody is waiting.
+class WaitPoint {
+public:
+    void notify() noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) == 0)
+            return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        cv_.notify_all();
+    }
+
+    template <typename Predicate>
+    bool wait_until(std::chrono::steady_clock::time_point deadline, Predicate ready)
+    {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        bool ok;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ok = cv_.wait_until(lock, deadline, ready);
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        return ok;
+    }
+
+private:
+    std::atomic<std::uint32_t> waiters_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+inline std::chrono::steady_clock::time_point deadline_after(std::chrono::nanoseconds timeout) noexcept
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (timeout >= std::chrono::steady_clock::time_point::max() - now)
+        return std::chrono::steady_clock::time_point::max();
+    return now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+}
+
+} // namespace detail
+
+/// Bounded lock-free ring queue (Vyukov-style sequenced cells).
+///
+/// Any number of producers (or exactly one, with `ProducerMode::single`, which skips the
+/// CAS on the tail) feed a single consumer. Pushing and popping never take a lock; the
+/// mutex inside is only touched when a thread actually has to sleep. With
+/// `OverflowPolicy::drop_oldest` the producer evicts from the head itself, so the dequeue
+/// side is always CAS-based.
+template <typename T, ProducerMode Mode = ProducerMode::multiple>
+class RingQueue {
+public:
+    static constexpr auto forever = std::chrono::nanoseconds::max();
+
+    explicit RingQueue(std::size_t capacity, OverflowPolicy policy = OverflowPolicy::drop_oldest)
+        : policy_(policy)
+    {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+            throw std::invalid_argument("RingQueue: capacity must be a power of two >= 2");
+        mask_ = capacity - 1;
+        cells_ = std::make_unique<Cell[]>(capacity);
+        for (std::size_t i = 0; i < capacity; ++i)
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    RingQueue(const RingQueue&) = delete;
+    RingQueue& operator=(const RingQueue&) = delete;
+
+    /// Enqueues without waiting or evicting. On failure `value` is left untouched.
+    bool try_push(T& value)
+    {
+        if (closed_.load(std::memory_order_relaxed) || !enqueue(value))
+            return false;
+        not_empty_.notify();
+        return true;
+    }
+
+    /// Enqueues according to the overflow policy. Returns false if the queue is closed, or
+    /// if a blocking push timed out; the value is dropped in both cases.
+    bool push(T value, std::chrono::nanoseconds timeout = forever)
+    {
+        if (policy_ == OverflowPolicy::drop_oldest) {
+            while (!try_push(value)) {
+                if (closed_.load(std::memory_order_relaxed)) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                if (dequeue())
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+            return true;
+        }
+
+        if (try_push(value))
+            return true;
+        const auto deadline = detail::deadline_after(timeout);
+        for (;;) {
+            not_full_.wait_until(deadline, [&] { return closed() || !full(); });
+            if (try_push(value))
+                return true;
+            if (closed() || std::chrono::steady_clock::now() >= deadline) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+    }
+
+    std::optional<T> try_pop()
+    {
+        std::optional<T> value = dequeue();
+        if (value && policy_ == OverflowPolicy::block)
+            not_full_.notify();
+        return value;
+    }
+
+    /// Waits up to `timeout` for an element. Returns early with nothing once the queue is
+    /// closed and drained.
+    std::optional<T> pop(std::chrono::nanoseconds timeout = forever)
+    {
+        if (std::optional<T> value = try_pop())
+            return value;
+        const auto deadline = detail::deadline_after(timeout);
+        for (;;) {
+            not_empty_.wait_until(deadline, [&] { return closed() || !empty(); });
+            if (std::optional<T> value = try_pop())
+                return value;
+            if (closed() || std::chrono::steady_clock::now() >= deadline)
+                return std::nullopt;
+        }
+    }
+
+    /// Rejects further pushes and wakes every waiting thread. Queued elements can still be popped.
+    void close() noexcept
+    {
+        closed_.store(true, std::memory_order_seq_cst);
+        not_empty_.notify();
+        not_full_.notify();
+    }
+    void reopen() noexcept { closed_.store(false, std::memory_order_seq_cst); }
+    bool closed() const noexcept { return closed_.load(std::memory_order_acquire); }
+
+    /// Pops and destroys everything currently queued.
+    void clear()
+    {
+        while (try_pop()) {
+        }
+    }
+
+    std::size_t size() const noexcept
+    {
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+    bool empty() const noexcept { return size() == 0; }
+    bool full() const noexcept { return size() > mask_; }
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+    OverflowPolicy policy() const noexcept { return policy_; }
+
+    /// Elements evicted or rejected since construction.
+    std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    bool enqueue(T& value)
+    {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        Cell* cell;
+        if constexpr (Mode == ProducerMode::single) {
+            cell = &cells_[pos & mask_];
+            if (cell->sequence.load(std::memory_order_acquire) != pos)
+                return false;
+            tail_.store(pos + 1, std::memory_order_relaxed);
+        } else {
+            for (;;) {
+                cell = &cells_[pos & mask_];
+                const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                if (diff == 0) {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = tail_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    std::optional<T> dequeue()
+    {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+        std::optional<T> value(std::move(cell->value));
+        cell->value = T{};
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return value;
+    }
+
+    OverflowPolicy policy_;
+    std::size_t mask_ = 0;
+    std::unique_ptr<Cell[]> cells_;
+
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<bool> closed_{false};
+    detail::WaitPoint not_empty_;
+    detail::WaitPoint not_full_;
+};
+
+/// Default frame delivery queue: any number of capture threads, one consumer.
+using FrameQueue = RingQueue<FrameHandle, ProducerMode::multiple>;
+/// Cheaper variant when exactly one thread produces.
+using SpscFrameQueue = RingQueue<FrameHandle, ProducerMode::single>;
+
+} // namespace camera_interface
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "camera_interface/camera.hpp"
+#include "camera_interface/poller.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace camera_interface {
+
+/// Fire-and-forget coroutine for consumers run by a `FrameReactor`.
+///
+/// A task does nothing until it is handed to `FrameReactor::spawn()`, which then owns it.
+class Task {
+public:
+    struct promise_type {
+        std::exception_ptr error;
+
+        Task get_return_object() noexcept { return Task(Handle::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&& other) noexcept
+    {
+        Task(std::move(other)).swap(*this);
+        return *this;
+    }
+    ~Task()
+    {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    void swap(Task& other) noexcept { std::swap(handle_, other.handle_); }
+
+private:
+    friend class FrameReactor;
+    explicit Task(Handle handle) noexcept : handle_(handle) {}
+
+    Handle handle_;
+};
+
+/// Single-threaded epoll reactor that runs consumer coroutines for many cameras.
+///
+/// Each attached camera gets an eventfd that its acquisition thread writes only while a
+/// coroutine is actually suspended in `co_await camera.next_frame()`, so idle cameras cost
+/// nothing and one thread can serve dozens of streams:
+///
+///     FrameReactor reactor;
+///     reactor.attach(camera);
+///     reactor.spawn([](Camera& c) -> Task {
+///         while (FrameHandle frame = co_await c.next_frame())
+///             consume(frame);
+///     }(camera));
+///     reactor.run();
+///
+/// Coroutines always resume on the thread calling `run()` / `poll()`. Every other member
+/// except `spawn()` and `stop()` must be called from that thread too, or before it starts.
+class FrameReactor {
+public:
+    /// Throws std::system_error if epoll is unavailable.
+    FrameReactor();
+    /// Detaches every camera and destroys tasks that have not finished.
+    ~FrameReactor();
+
+    FrameReactor(const FrameReactor&) = delete;
+    FrameReactor& operator=(const FrameReactor&) = delete;
+
+    /// Lets coroutines await `camera.next_frame()` on this reactor. Attach and detach while
+    /// the camera is not streaming. Throws std::logic_error if the camera is attached to
+    /// another reactor, std::system_error if no eventfd can be created.
+    void attach(Camera& camera);
+    /// A coroutine still waiting on the camera stays suspended until the reactor is destroyed.
+    void detach(Camera& camera) noexcept;
+
+    /// Queues `task` to start on the reactor thread. Thread-safe.
+    void spawn(Task task);
+
+    /// Runs until every spawned task has finished or `stop()` is called. Rethrows the first
+    /// exception that escapes a task, after destroying that task.
+    void run();
+    /// One round: starts spawned tasks, waits up to `timeout` for frames and resumes their
+    /// waiters. Returns the number of coroutines resumed.
+    std::size_t poll(std::chrono::milliseconds timeout);
+    /// Makes `run()` return. Thread-safe.
+    void stop() noexcept;
+
+    /// Spawned tasks that have not finished.
+    std::size_t tasks() const;
+
+private:
+    void wake(Camera& camera) noexcept;
+    std::size_t start_spawned();
+    void reap();
+
+    Poller poller_;
+    std::vector<Camera*> cameras_;
+    std::vector<Task::Handle> running_;
+    std::size_t resumed_ = 0;
+
+    mutable std::mutex mutex_;
+    std::vector<Task::Handle> spawned_;
+    std::atomic<bool> stop_requested_{false};
+};
+
+} // namespace camera_interface
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "camera_interface/convert.hpp"
+#include "camera_interface/frame_buffer_pool.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace camera_interface {
+
+struct FrameStatsConfig {
+    /// Grid spacing in pixels; one luma sample is taken every `step` pixels in both
+    /// directions. Bayer mosaics are sampled per 2x2 cell, so odd steps round up.
+    std::uint32_t step = 4;
+    /// Samples at or above this luma count as saturated.
+    std::uint8_t saturation_level = 250;
+    /// Right shift that brings mono16 samples to 8 bits, as in `ConvertOptions`.
+    unsigned mono16_shift = 8;
+};
+
+/// Luminance statistics of one frame.
+struct FrameStats {
+    std::uint64_t sequence = 0; ///< Sequence number of the frame they were computed from.
+    std::uint32_t samples = 0;  ///< Grid points the statistics cover.
+    LumaStats luma;
+    std::array<std::uint32_t, 256> histogram{};
+};
+
+/// Computes `FrameStats` in a single pass over a decimated grid.
+///
+/// Each grid row is reduced to 8-bit luma in a small line buffer: the Y plane or Y bytes of
+/// YUV formats, the 2x2 cell average of Bayer mosaics ((R + 2G + B) / 4), BT.601 weights for
+/// RGB, the shifted value for mono16. The histogram, mean, variance and saturation come from
+/// that line, and the Laplacian from it and its two neighbours, so every source row is read
+/// once and no copy of the frame is made. The gather and Laplacian kernels use the active
+/// `SimdLevel`. Line buffers grow to the widest frame seen; after that collecting never
+/// allocates.
+class FrameStatsCollector {
+public:
+    /// Throws std::invalid_argument for `step == 0` or a `mono16_shift` above 15.
+    explicit FrameStatsCollector(const FrameStatsConfig& config = {});
+
+    const FrameStatsConfig& config() const noexcept { return config_; }
+
+    /// Fills everything in `out` except `sequence`. Returns false for an image too small to
+    /// sample (Bayer needs 2x2) or when a line buffer could not be grown.
+    bool collect(const ConstImageView& image, FrameStats& out) noexcept;
+
+private:
+    FrameStatsConfig config_;
+    std::vector<std::uint8_t> lines_;
+};
+
+/// Convenience wrapper around a one-off `FrameStatsCollector`. Throws std::invalid_argument
+/// for a bad config or an image too small to sample.
+FrameStats compute_frame_stats(const ConstImageView& image, const FrameStatsConfig& config = {});
+
+/// Latest `FrameStats` of a stream: one writer (the capture thread) publishes, any number of
+/// readers copy it out without blocking the writer.
+class LatestFrameStats {
+public:
+    /// Single writer only.
+    void publish(const FrameStats& stats) noexcept;
+
+    /// Copies the latest statistics into `out`; false until something has been published.
+    bool read(FrameStats& out) const noexcept;
+
+    /// Statistics published so far.
+    std::uint64_t published() const noexcept { return version_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr std::size_t kWords = (sizeof(FrameStats) + 7) / 8;
+
+    std::atomic<std::uint64_t> version_{0}; ///< Odd while a write is in progress.
+    std::array<std::atomic<std::uint64_t>, kWords> words_{};
+};
+
+} // namespace camera_interface
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "camera_interface/camera.hpp"
+#include "camera_interface/frame_queue.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace camera_interface {
+
+/// Upper bound on the number of streams one synchronizer can align.
+inline constexpr std::size_t kMaxSyncStreams = 16;
+
+/// One frame per stream whose timestamps all lie within the synchronizer's tolerance.
+struct FrameBundle {
+    std::array<FrameHandle, kMaxSyncStreams> frames; ///< Indexed by stream; first `count` are set.
+    std::size_t count = 0;
+    std::int64_t timestamp_ns = 0; ///< Earliest timestamp in the bundle.
+    std::int64_t spread_ns = 0;    ///< Latest minus earliest timestamp.
+};
+
+struct SynchronizerConfig {
+    std::size_t streams = 2;
+    std::chrono::nanoseconds tolerance{std::chrono::milliseconds(1)};
+    std::size_t stream_depth = 4; ///< Unmatched frames kept per stream before the oldest is dropped.
+    std::size_t output_depth = 4; ///< Bundles buffered for the consumer (power of two).
+};
+
+/// Groups frames from N streams into bundles by capture timestamp.
+///
+/// Each stream keeps at most `stream_depth` unmatched frames. Whenever every stream has a
+/// candidate, the latest head timestamp becomes the reference: heads older than
+/// `reference - tolerance` are dropped as stale, heads superseded by a later frame that is
+/// still not past the reference are dropped in favour of it, and once all heads lie within
+/// tolerance they are emitted as a bundle. Memory use is fixed at construction.
+///
+/// `push()` and `drain()` must be called from one thread; bundles can be consumed from
+/// another through `pop()` / `try_pop()`. Frames of one stream must arrive in timestamp order.
+class FrameSynchronizer {
+public:
+    explicit FrameSynchronizer(const SynchronizerConfig& config);
+
+    /// Offers a frame from `stream` and emits any bundles it completes.
+    void push(std::size_t stream, FrameHandle frame);
+
+    /// Moves every frame already queued in `cameras[i]` into stream `i`; returns frames taken.
+    std::size_t drain(std::span<Camera* const> cameras);
+
+    std::optional<FrameBundle> try_pop() { return bundles_.try_pop(); }
+    std::optional<FrameBundle> pop(std::chrono::nanoseconds timeout) { return bundles_.pop(timeout); }
+
+    std::size_t streams() const noexcept { return lanes_.size(); }
+    std::uint64_t bundles_emitted() const noexcept { return emitted_.load(std::memory_order_relaxed); }
+    /// Frames discarded because no partner arrived within tolerance (or a closer one did).
+    std::uint64_t stale_dropped() const noexcept { return stale_.load(std::memory_order_relaxed); }
+    /// Frames discarded because a stream ran `stream_depth` frames ahead of the others.
+    std::uint64_t overflow_dropped() const noexcept { return overflow_.load(std::memory_order_relaxed); }
+    /// Bundles evicted because the consumer did not keep up.
+    std::uint64_t bundles_dropped() const noexcept { return bundles_.dropped(); }
+
+private:
+    /// Fixed-size FIFO of pending frames for one stream.
+    struct Lane {
+        std::vector<FrameHandle> slots;
+        std::size_t head = 0;
+        std::size_t size = 0;
+
+        FrameHandle& at(std::size_t i) { return slots[(head + i) % slots.size()]; }
+        std::int64_t timestamp(std::size_t i) { return at(i).info().timestamp_ns; }
+        void push(FrameHandle frame);
+        FrameHandle pop();
+    };
+
+    void match();
+
+    std::int64_t tolerance_ns_;
+    std::vector<Lane> lanes_;
+    RingQueue<FrameBundle, ProducerMode::single> bundles_;
+    std::atomic<std::uint64_t> emitted_{0};
+    std::atomic<std::uint64_t> stale_{0};
+    std::atomic<std::uint64_t> overflow_{0};
+};
+
+} // namespace camera_interface
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "camera_interface/frame_buffer_pool.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace camera_interface {
+
+/// Copied-out metadata of consecutive frames, one vector per field, oldest first.
+struct MetadataSnapshot {
+    std::vector<std::uint64_t> sequence;
+    std::vector<std::int64_t> sensor_ns;
+    std::vector<std::int64_t> host_ns;
+    std::vector<std::uint32_t> exposure_us;
+    std::vector<float> gain;
+    std::vector<std::uint64_t> drops;
+    /// `FrameInfo::luma` fields; zero unless the camera computes frame statistics.
+    std::vector<float> luma_mean;
+    std::vector<float> saturated;
+    std::vector<float> focus;
+    /// Position of the first entry in the log's lifetime; entries are numbered from 0.
+    std::uint64_t first = 0;
+
+    std::size_t size() const noexcept { return sequence.size(); }
+    bool empty() const noexcept { return sequence.empty(); }
+};
+
+/// Frame-interval statistics over a run of timestamps.
+struct JitterStats {
+    std::size_t intervals = 0;
+    double mean_ns = 0.0;
+    double stddev_ns = 0.0;
+    std::int64_t min_ns = 0;
+    std::int64_t max_ns = 0;
+    /// Largest |interval - mean|.
+    double max_deviation_ns = 0.0;
+    /// Frames missing from the sequence numbers.
+    std::uint64_t sequence_gaps = 0;
+    /// Host minus sensor timestamp: mean and worst case.
+    double mean_host_delay_ns = 0.0;
+    std::int64_t max_host_delay_ns = 0;
+};
+
+/// Interval statistics of `snapshot.sensor_ns`, or of the host timestamps with `host_clock`.
+JitterStats analyze_jitter(const MetadataSnapshot& snapshot, bool host_clock = false) noexcept;
+/// Interval statistics of a bare timestamp series.
+JitterStats analyze_jitter(std::span<const std::int64_t> timestamps) noexcept;
+
+/// Fixed-capacity struct-of-arrays ring of per-frame metadata.
+///
+/// Every field lives in its own contiguous column, so a scan over timestamps reads only
+/// timestamps and never touches pixel data or the frame pool. One thread appends (the
+/// acquisition thread, through `Camera::deliver()`); any number of threads may take
+/// snapshots concurrently without blocking it. Entries overwritten while a snapshot is
+/// being copied are discarded from that snapshot rather than returned torn.
+class MetadataLog {
+public:
+    /// Throws std::invalid_argument unless `capacity` is a power of two >= 2.
+    explicit MetadataLog(std::size_t capacity);
+
+    MetadataLog(const MetadataLog&) = delete;
+    MetadataLog& operator=(const MetadataLog&) = delete;
+
+    /// Single writer only.
+    void append(const FrameInfo& info) noexcept;
+
+    /// The newest `max_entries` entries still in the ring (all of them by default).
+    MetadataSnapshot snapshot(std::size_t max_entries = SIZE_MAX) const;
+    /// Entries appended at or after lifetime position `from`, e.g. the end of an earlier
+    /// snapshot, for incremental scans. Entries that have already been overwritten are skipped.
+    MetadataSnapshot since(std::uint64_t from) const;
+
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+    /// Entries appended over the log's lifetime.
+    std::uint64_t appended() const noexcept { return head_.load(std::memory_order_acquire); }
+
+private:
+    template <typename T>
+    using Column = std::unique_ptr<std::atomic<T>[]>;
+
+    MetadataSnapshot copy(std::uint64_t from, std::uint64_t to) const;
+
+    std::size_t mask_ = 0;
+    Column<std::uint64_t> sequence_;
+    Column<std::int64_t> sensor_ns_;
+    Column<std::int64_t> host_ns_;
+    Column<std::uint32_t> exposure_us_;
+    Column<float> gain_;
+    Column<std::uint64_t> drops_;
+    Column<float> luma_mean_;
+    Column<float> saturated_;
+    Column<float> focus_;
+    std::atomic<std::uint64_t> head_{0};    ///< Entries published.
+    std::atomic<std::uint64_t> writing_{0}; ///< Entries published or being written.
+};
+
+} // namespace camera_interface
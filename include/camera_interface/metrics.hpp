@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace camera_interface {
+
+/// Point-in-time copy of a `LatencyHistogram`.
+struct HistogramSnapshot {
+    std::vector<std::uint64_t> buckets;
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t min = 0;
+    std::uint64_t max = 0;
+
+    double mean() const noexcept;
+    /// Smallest value that at least `percent` of the samples do not exceed, to bucket
+    /// precision; 0 when empty.
+    std::uint64_t percentile(double percent) const noexcept;
+    /// Samples known to be <= `value` (whole buckets only).
+    std::uint64_t count_at_or_below(std::uint64_t value) const noexcept;
+};
+
+/// Log-linear histogram of non-negative integer samples: latencies in nanoseconds, queue
+/// depths and the like.
+///
+/// As in HdrHistogram, every power-of-two range is split into 32 linear sub-buckets, so a
+/// value is known to within about 3% anywhere in the range, at a fixed footprint of about
+/// 10 KiB. `record()` is a few relaxed atomic operations and never allocates, so acquisition
+/// threads can call it per frame, and any number of threads may record concurrently.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 5;
+    /// Samples of 2^kMaxExponent (about 73 minutes in nanoseconds) and above are clamped.
+    static constexpr unsigned kMaxExponent = 42;
+    static constexpr std::size_t kLinearBuckets = std::size_t{1} << (kSubBucketBits + 1);
+    static constexpr std::size_t kBucketCount =
+        kLinearBuckets + (kMaxExponent - kSubBucketBits - 1) * (std::size_t{1} << kSubBucketBits);
+
+    /// Negative samples (e.g. from clock skew between sensor and host) count as zero.
+    void record(std::int64_t value) noexcept;
+    HistogramSnapshot snapshot() const;
+    void reset() noexcept;
+
+    static std::size_t bucket_index(std::uint64_t value) noexcept;
+    /// Largest value that lands in bucket `index`.
+    static std::uint64_t bucket_upper(std::size_t index) noexcept;
+
+private:
+    std::array<std::atomic<std::uint64_t>, kBucketCount> buckets_{};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> min_{std::numeric_limits<std::uint64_t>::max()};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+/// Live per-camera counters, updated by `Camera` on the delivery and consumer paths.
+struct CameraMetrics {
+    LatencyHistogram sensor_to_dequeue;   ///< Host dequeue time minus sensor timestamp, ns.
+    LatencyHistogram dequeue_to_consumer; ///< Consumer pop time minus host dequeue time, ns.
+    LatencyHistogram queue_depth;         ///< Delivery queue depth as each frame is queued.
+    std::atomic<std::uint64_t> delivered{0};
+    std::atomic<std::uint64_t> consumed{0};
+};
+
+struct CameraStats {
+    HistogramSnapshot sensor_to_dequeue;
+    HistogramSnapshot dequeue_to_consumer;
+    HistogramSnapshot queue_depth;
+    std::uint64_t frames_delivered = 0;
+    std::uint64_t frames_consumed = 0;
+    /// Frames the delivery queue evicted or refused.
+    std::uint64_t queue_drops = 0;
+    /// Frames lost before delivery: driver drops, starved pools, injected losses.
+    std::uint64_t source_drops = 0;
+    std::size_t queue_size = 0;
+};
+
+/// Live counters of a `FrameExecutor`.
+struct ExecutorMetrics {
+    LatencyHistogram conversion; ///< Time from start to finish of each frame, ns.
+    std::atomic<std::uint64_t> frames{0};
+};
+
+struct ExecutorStats {
+    HistogramSnapshot conversion;
+    std::uint64_t frames = 0;
+    /// Frames refused for lack of an output frame.
+    std::uint64_t drops = 0;
+};
+
+/// Builds a Prometheus text-format (0.0.4) exposition.
+///
+/// Samples are grouped per metric family, so several cameras can be added under different
+/// labels and every family still gets a single HELP/TYPE header.
+class PrometheusText {
+public:
+    using Label = std::pair<std::string_view, std::string_view>;
+
+    void counter(std::string_view name, std::string_view help, std::span<const Label> labels, double value);
+    void gauge(std::string_view name, std::string_view help, std::span<const Label> labels, double value);
+    /// Emits cumulative buckets at `bounds` (in exported units); samples are multiplied by
+    /// `scale` first, e.g. 1e-9 to export nanoseconds as seconds.
+    void histogram(std::string_view name, std::string_view help, std::span<const Label> labels,
+                   const HistogramSnapshot& snapshot, std::span<const double> bounds, double scale);
+
+    std::string str() const;
+
+private:
+    struct Family {
+        std::string name;
+        std::string help;
+        std::string type;
+        std::string samples;
+    };
+
+    Family& family(std::string_view name, std::string_view help, std::string_view type);
+
+    std::vector<Family> families_;
+};
+
+/// Latency buckets used for exported `*_seconds` histograms: 1-2-5 steps from 10 us to 10 s.
+std::span<const double> default_latency_bounds() noexcept;
+
+/// Adds the standard `camera_*` families for one camera, labelled `camera="<name>"`.
+void add_metrics(PrometheusText& text, std::string_view camera, const CameraStats& stats);
+/// Adds the standard `executor_*` families, labelled `executor="<name>"`.
+void add_metrics(PrometheusText& text, std::string_view executor, const ExecutorStats& stats);
+
+} // namespace camera_interface
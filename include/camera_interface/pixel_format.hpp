@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace camera_interface {
+
+/// Pixel layouts produced by camera backends and conversion kernels.
+enum class PixelFormat : std::uint32_t {
+    mono8,
+    mono16,       ///< 16-bit little-endian container, MSB-aligned or not depending on sensor.
+    bayer_rggb8,
+    bayer_bggr8,
+    bayer_grbg8,
+    bayer_gbrg8,
+    yuyv,         ///< Packed 4:2:2, Y0 U Y1 V.
+    uyvy,         ///< Packed 4:2:2, U Y0 V Y1.
+    nv12,         ///< Planar Y followed by interleaved UV at half resolution.
+    i420,         ///< Planar Y, U, V; chroma at half resolution.
+    rgb8,
+    bgr8,
+};
+
+const char* to_string(PixelFormat format) noexcept;
+
+/// Bytes per pixel of the first plane (fractional formats are rounded up per pixel pair).
+std::size_t bytes_per_pixel(PixelFormat format) noexcept;
+
+/// Smallest legal row stride, in bytes, of the first plane. Even for NV12, whose UV rows share
+/// it and need a whole U/V pair for an odd last pixel.
+std::size_t min_stride(PixelFormat format, std::uint32_t width) noexcept;
+
+/// True for the four 8-bit Bayer mosaics.
+bool is_bayer(PixelFormat format) noexcept;
+
+/// Geometry and layout of the frames a stream produces.
+///
+/// For the planar YUV formats `stride` is the luma stride; chroma planes follow the
+/// luma plane contiguously with the stride implied by the format (`stride` for the
+/// NV12 UV plane, `(stride + 1) / 2` for the I420 U and V planes).
+struct StreamFormat {
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    PixelFormat format = PixelFormat::mono8;
+    std::size_t stride = 0;
+
+    /// Total bytes required to hold one frame, including chroma planes.
+    std::size_t frame_size() const noexcept;
+
+    /// Returns a copy with `stride` set to the tightest legal value.
+    static StreamFormat packed(std::uint32_t width, std::uint32_t height, PixelFormat format) noexcept;
+
+    friend bool operator==(const StreamFormat&, const StreamFormat&) = default;
+};
+
+} // namespace camera_interface
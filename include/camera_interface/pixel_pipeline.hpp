@@ -0,0 +1,534 @@
+#pragma once
+
+#include "camera_interface/convert.hpp"
+#include "camera_interface/pixel_format.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace camera_interface {
+
+/// Size of the image flowing between two pipeline stages.
+struct Extent {
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+
+    bool operator==(const Extent&) const = default;
+};
+
+/// Columns [begin, end) of an image that a later stage actually reads.
+struct Span {
+    std::uint32_t begin = 0;
+    std::uint32_t end = 0;
+
+    std::uint32_t size() const noexcept { return end - begin; }
+};
+
+namespace detail {
+
+/// Bytes per pixel of the formats a `Pipeline` carries between stages.
+constexpr std::size_t pipeline_pixel_bytes(PixelFormat format) noexcept
+{
+    switch (format) {
+    case PixelFormat::rgb8:
+    case PixelFormat::bgr8: return 3;
+    case PixelFormat::mono16:
+    case PixelFormat::yuyv:
+    case PixelFormat::uyvy: return 2;
+    default: return 1;
+    }
+}
+
+constexpr bool is_bayer_format(PixelFormat format) noexcept
+{
+    return format == PixelFormat::bayer_rggb8 || format == PixelFormat::bayer_bggr8
+        || format == PixelFormat::bayer_grbg8 || format == PixelFormat::bayer_gbrg8;
+}
+
+constexpr bool is_interleaved8(PixelFormat format) noexcept
+{
+    return format == PixelFormat::mono8 || format == PixelFormat::rgb8 || format == PixelFormat::bgr8;
+}
+
+/// Demosaics columns [x_begin, x_end) of row `y` of a `width`-wide Bayer image into `dst`,
+/// exactly as `convert()` would for the whole row, with the active SIMD kernels. The row
+/// pointers address column `x_begin`; the columns on either side of the span must be
+/// readable where they lie inside the image.
+void demosaic_span(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                   std::uint32_t width, PixelFormat format, std::uint32_t y, std::uint32_t x_begin,
+                   std::uint32_t x_end, std::uint8_t* dst) noexcept;
+
+/// Converts `width` pixels of a YUYV or UYVY row, starting on an even column, to rgb8.
+void yuv422_span(const std::uint8_t* src, PixelFormat format, std::uint32_t width, std::uint8_t* dst) noexcept;
+
+} // namespace detail
+
+// Stages. Each one describes its formats at compile time and its geometry at run time:
+//
+//     static constexpr bool accepts(PixelFormat in);
+//     static constexpr PixelFormat output_format(PixelFormat in);
+//     Extent output_extent(Extent in) const;         // throws std::invalid_argument
+//     Span input_span(Extent in, Span out) const;    // input columns needed for `out`
+//     template <PixelFormat In> void prepare(Extent in, Span in_span, Span out_span);
+//     template <PixelFormat In, class Pull>
+//     const std::uint8_t* row(std::uint32_t y, std::uint8_t* out, Pull&& pull);
+//
+// `row()` returns output row `y`, pointing at column `out_span.begin`. It may fill `out`
+// (room for `out_span` only) or return memory of its own or of its input; the result stays
+// valid until the next call. `pull(y, buffer)` does the same for the stage's input. A stage
+// that can open a pipeline also names the format it reads as `input_format`.
+
+/// Passes frames of format `Format` through unchanged; opens pipelines whose first real
+/// stage works on any format, e.g. `Pipeline<Input<PixelFormat::rgb8>, Crop>`.
+template <PixelFormat Format>
+struct Input {
+    static constexpr PixelFormat input_format = Format;
+    static constexpr bool accepts(PixelFormat in) noexcept { return in == Format; }
+    static constexpr PixelFormat output_format(PixelFormat in) noexcept { return in; }
+
+    Extent output_extent(Extent in) const noexcept { return in; }
+    Span input_span(Extent, Span out) const noexcept { return out; }
+    template <PixelFormat In>
+    void prepare(Extent, Span, Span) noexcept
+    {
+    }
+    template <PixelFormat In, class Pull>
+    const std::uint8_t* row(std::uint32_t y, std::uint8_t* out, Pull&& pull)
+    {
+        return pull(y, out);
+    }
+};
+
+/// Bilinear demosaic of an 8-bit Bayer mosaic to rgb8, bit-identical to `convert()` even
+/// when later stages only need part of each row.
+template <PixelFormat Bayer>
+struct Demosaic {
+    static_assert(detail::is_bayer_format(Bayer), "Demosaic needs an 8-bit Bayer format");
+
+    static constexpr PixelFormat input_format = Bayer;
+    static constexpr bool accepts(PixelFormat in) noexcept { return in == Bayer; }
+    static constexpr PixelFormat output_format(PixelFormat) noexcept { return PixelFormat::rgb8; }
+
+    Extent output_extent(Extent in) const
+    {
+        if (in.width < 2 || in.height < 2)
+            throw std::invalid_argument("Demosaic: Bayer images must be at least 2x2");
+        return in;
+    }
+    Span input_span(Extent in, Span out) const noexcept
+    {
+        return Span{out.begin == 0 ? 0 : out.begin - 1, std::min(out.end + 1, in.width)};
+    }
+    template <PixelFormat In>
+    void prepare(Extent in, Span in_span, Span out_span)
+    {
+        height_ = in.height;
+        width_ = in.width;
+        offset_ = out_span.begin - in_span.begin;
+        for (std::size_t i = 0; i < 3; ++i) {
+            lines_[i].resize(in_span.size());
+            cached_[i] = kNone;
+        }
+        span_ = out_span;
+    }
+    template <PixelFormat In, class Pull>
+    const std::uint8_t* row(std::uint32_t y, std::uint8_t* out, Pull&& pull)
+    {
+        const std::uint32_t above = y == 0 ? 1 : y - 1;
+        const std::uint32_t below = y + 1 == height_ ? y - 1 : y + 1;
+        // Input rows carry up to one extra column on each side; skip to column `span_.begin`.
+        detail::demosaic_span(line(above, pull) + offset_, line(y, pull) + offset_, line(below, pull) + offset_,
+                              width_, Bayer, y, span_.begin, span_.end, out);
+        return out;
+    }
+
+private:
+    static constexpr std::uint32_t kNone = ~std::uint32_t{0};
+
+    /// Three consecutive input rows stay cached, so each is produced once per frame.
+    template <class Pull>
+    const std::uint8_t* line(std::uint32_t y, Pull& pull)
+    {
+        const std::size_t slot = y % 3;
+        if (cached_[slot] != y) {
+            rows_[slot] = pull(y, lines_[slot].data());
+            cached_[slot] = y;
+        }
+        return rows_[slot];
+    }
+
+    std::uint32_t width_ = 0;
+    std::uint32_t height_ = 0;
+    std::uint32_t offset_ = 0;
+    Span span_;
+    std::array<std::vector<std::uint8_t>, 3> lines_;
+    std::array<const std::uint8_t*, 3> rows_{};
+    std::array<std::uint32_t, 3> cached_{kNone, kNone, kNone};
+};
+
+/// Cuts out `roi`. Costs nothing: earlier stages are only asked for the columns and rows
+/// inside it.
+struct Crop {
+    Rect roi;
+
+    static constexpr bool accepts(PixelFormat in) noexcept { return detail::is_interleaved8(in); }
+    static constexpr PixelFormat output_format(PixelFormat in) noexcept { return in; }
+
+    Extent output_extent(Extent in) const
+    {
+        if (roi.width == 0 || roi.height == 0 || roi.width > in.width || roi.x > in.width - roi.width
+            || roi.height > in.height || roi.y > in.height - roi.height)
+            throw std::invalid_argument("Crop: region empty or outside the image");
+        return Extent{roi.width, roi.height};
+    }
+    Span input_span(Extent, Span out) const noexcept { return Span{out.begin + roi.x, out.end + roi.x}; }
+    template <PixelFormat In>
+    void prepare(Extent, Span, Span) noexcept
+    {
+    }
+    template <PixelFormat In, class Pull>
+    const std::uint8_t* row(std::uint32_t y, std::uint8_t* out, Pull&& pull)
+    {
+        return pull(y + roi.y, out);
+    }
+};
+
+/// `Resize` filters.
+struct Nearest {};
+/// Pixel-centre aligned, with 8-bit weights.
+struct Bilinear {};
+
+/// Scales to `Width` x `Height`, or to the size given at construction when those are 0.
+/// Fixing the size at compile time lets the compiler specialise the row loops for it.
+template <class Filter, std::uint32_t Width = 0, std::uint32_t Height = 0>
+class Resize {
+public:
+    static_assert(std::is_same_v<Filter, Nearest> || std::is_same_v<Filter, Bilinear>, "unknown Resize filter");
+    static_assert((Width == 0) == (Height == 0), "fix both dimensions or neither");
+
+    Resize() noexcept requires(Width != 0) : width_(Width), height_(Height) {}
+    Resize(std::uint32_t width, std::uint32_t height) noexcept requires(Width == 0) : width_(width), height_(height) {}
+
+    static constexpr bool accepts(PixelFormat in) noexcept { return detail::is_interleaved8(in); }
+    static constexpr PixelFormat output_format(PixelFormat in) noexcept { return in; }
+
+    Extent output_extent(Extent) const
+    {
+        if (width() == 0 || height() == 0)
+            throw std::invalid_argument("Resize: empty output size");
+        return Extent{width(), height()};
+    }
+    Span input_span(Extent in, Span out) const noexcept
+    {
+        if (out.size() == 0)
+            return Span{};
+        const Sample first = sample(out.begin, in.width, width());
+        const Sample last = sample(out.end - 1, in.width, width());
+        return Span{first.index, std::is_same_v<Filter, Bilinear> ? last.next + 1 : last.index + 1};
+    }
+    template <PixelFormat In>
+    void prepare(Extent in, Span in_span, Span out_span)
+    {
+        constexpr std::size_t channels = detail::pipeline_pixel_bytes(In);
+        in_height_ = in.height;
+        columns_.resize(out_span.size());
+        for (std::uint32_t x = out_span.begin; x < out_span.end; ++x) {
+            Sample s = sample(x, in.width, width());
+            s.index = static_cast<std::uint32_t>((s.index - in_span.begin) * channels);
+            s.next = static_cast<std::uint32_t>((s.next - in_span.begin) * channels);
+            columns_[x - out_span.begin] = s;
+        }
+        input_.resize(in_span.size() * channels);
+        if constexpr (std::is_same_v<Filter, Bilinear>) {
+            for (std::size_t i = 0; i < 2; ++i) {
+                horizontal_[i].resize(out_span.size() * channels);
+                cached_[i] = kNone;
+            }
+        }
+    }
+    template <PixelFormat In, class Pull>
+    const std::uint8_t* row(std::uint32_t y, std::uint8_t* out, Pull&& pull)
+    {
+        constexpr std::size_t channels = detail::pipeline_pixel_bytes(In);
+        const Sample v = sample(y, in_height_, height());
+        if constexpr (std::is_same_v<Filter, Nearest>) {
+            const std::uint8_t* src = pull(v.index, input_.data());
+            for (std::size_t x = 0; x < columns_.size(); ++x)
+                for (std::size_t c = 0; c < channels; ++c)
+                    out[x * channels + c] = src[columns_[x].index + c];
+        } else {
+            const std::uint16_t* top = horizontal<channels>(v.index, pull);
+            const std::uint16_t* bottom = horizontal<channels>(v.next, pull);
+            const std::uint32_t wb = v.weight;
+            const std::uint32_t wt = 256 - wb;
+            for (std::size_t i = 0; i < columns_.size() * channels; ++i)
+                out[i] = static_cast<std::uint8_t>((top[i] * wt + bottom[i] * wb + 32768) >> 16);
+        }
+        return out;
+    }
+
+private:
+    static constexpr std::uint32_t kNone = ~std::uint32_t{0};
+
+    /// Input position of an output pixel: `index` and `next` blended by `weight` / 256.
+    struct Sample {
+        std::uint32_t index = 0;
+        std::uint32_t next = 0;
+        std::uint32_t weight = 0;
+    };
+
+    std::uint32_t width() const noexcept { return Width != 0 ? Width : width_; }
+    std::uint32_t height() const noexcept { return Height != 0 ? Height : height_; }
+
+    static Sample sample(std::uint32_t i, std::uint32_t in, std::uint32_t out) noexcept
+    {
+        if constexpr (std::is_same_v<Filter, Nearest>) {
+            const auto index = static_cast<std::uint32_t>((2 * std::uint64_t{i} + 1) * in / (2 * std::uint64_t{out}));
+            return Sample{index, index, 0};
+        } else {
+            // (i + 0.5) * in / out - 0.5 in 16.16 fixed point, clamped to the image.
+            const std::int64_t scaled = static_cast<std::int64_t>((2 * std::uint64_t{i} + 1) * in * 32768 / out) - 32768;
+            const std::int64_t position = std::clamp<std::int64_t>(scaled, 0, std::int64_t{in - 1} << 16);
+            const auto index = static_cast<std::uint32_t>(position >> 16);
+            return Sample{index, std::min(index + 1, in - 1), static_cast<std::uint32_t>((position >> 8) & 0xff)};
+        }
+    }
+
+    /// Input row `y` resampled horizontally, kept at 16 bits; the last two are cached.
+    template <std::size_t Channels, class Pull>
+    const std::uint16_t* horizontal(std::uint32_t y, Pull& pull)
+    {
+        const std::size_t slot = y & 1;
+        std::uint16_t* dst = horizontal_[slot].data();
+        if (cached_[slot] == y)
+            return dst;
+        const std::uint8_t* src = pull(y, input_.data());
+        for (std::size_t x = 0; x < columns_.size(); ++x) {
+            const Sample s = columns_[x];
+            for (std::size_t c = 0; c < Channels; ++c)
+                dst[x * Channels + c] = static_cast<std::uint16_t>(src[s.index + c] * (256 - s.weight)
+                                                                   + src[s.next + c] * s.weight);
+        }
+        cached_[slot] = y;
+        return dst;
+    }
+
+    std::uint32_t width_;
+    std::uint32_t height_;
+    std::uint32_t in_height_ = 0;
+    std::vector<Sample> columns_;
+    std::vector<std::uint8_t> input_;
+    std::array<std::vector<std::uint16_t>, 2> horizontal_;
+    std::array<std::uint32_t, 2> cached_{kNone, kNone};
+};
+
+/// Converts mono8, bgr8, YUYV or UYVY to rgb8; rgb8 passes through untouched.
+struct ToRGB8 {
+    static constexpr bool accepts(PixelFormat in) noexcept
+    {
+        return detail::is_interleaved8(in) || in == PixelFormat::yuyv || in == PixelFormat::uyvy;
+    }
+    static constexpr PixelFormat output_format(PixelFormat) noexcept { return PixelFormat::rgb8; }
+
+    Extent output_extent(Extent in) const noexcept { return in; }
+    Span input_span(Extent in, Span out) const noexcept
+    {
+        // 4:2:2 chroma is shared by column pairs.
+        return Span{out.begin & ~1u, std::min(out.end + (out.end & 1), in.width)};
+    }
+    template <PixelFormat In>
+    void prepare(Extent, Span in_span, Span out_span)
+    {
+        input_.resize(in_span.size() * detail::pipeline_pixel_bytes(In));
+        if constexpr (In == PixelFormat::yuyv || In == PixelFormat::uyvy) {
+            skip_ = out_span.begin - in_span.begin;
+            converted_.resize(in_span.size() * 3);
+        }
+        width_ = out_span.size();
+    }
+    template <PixelFormat In, class Pull>
+    const std::uint8_t* row(std::uint32_t y, std::uint8_t* out, Pull&& pull)
+    {
+        if constexpr (In == PixelFormat::rgb8) {
+            return pull(y, out);
+        } else if constexpr (In == PixelFormat::yuyv || In == PixelFormat::uyvy) {
+            const std::uint8_t* src = pull(y, input_.data());
+            if (skip_ == 0) {
+                detail::yuv422_span(src, In, width_, out);
+                return out;
+            }
+            detail::yuv422_span(src, In, width_ + skip_, converted_.data());
+            return converted_.data() + 3 * skip_;
+        } else {
+            const std::uint8_t* src = pull(y, input_.data());
+            for (std::size_t x = 0; x < width_; ++x) {
+                if constexpr (In == PixelFormat::mono8) {
+                    out[3 * x] = out[3 * x + 1] = out[3 * x + 2] = src[x];
+                } else {
+                    out[3 * x] = src[3 * x + 2];
+                    out[3 * x + 1] = src[3 * x + 1];
+                    out[3 * x + 2] = src[3 * x];
+                }
+            }
+            return out;
+        }
+    }
+
+private:
+    std::uint32_t width_ = 0;
+    std::uint32_t skip_ = 0;
+    std::vector<std::uint8_t> input_;
+    std::vector<std::uint8_t> converted_;
+};
+
+namespace detail {
+
+template <class... Stages>
+struct StageFormats {
+    using First = std::tuple_element_t<0, std::tuple<Stages...>>;
+    static_assert(requires { First::input_format; },
+                  "the first stage must fix the input format; start with Input<Format> or Demosaic<Format>");
+
+    /// Format entering each stage, followed by the pipeline's output format.
+    static constexpr std::array<PixelFormat, sizeof...(Stages) + 1> formats = [] {
+        std::array<PixelFormat, sizeof...(Stages) + 1> formats{};
+        formats[0] = First::input_format;
+        std::size_t i = 0;
+        ((formats[i + 1] = Stages::output_format(formats[i]), ++i), ...);
+        return formats;
+    }();
+    static constexpr bool valid = [] {
+        std::size_t i = 0;
+        return ((Stages::accepts(formats[i++])) && ...);
+    }();
+};
+
+} // namespace detail
+
+/// Chain of pixel operations fused into a single pass over the output rows:
+///
+///     Pipeline pipeline{Demosaic<PixelFormat::bayer_rggb8>{}, Crop{roi},
+///                       Resize<Bilinear, 640, 360>{}, ToRGB8{}};
+///     pipeline.run(image_view(frame), output);
+///
+/// Each output row pulls just the input rows and columns it depends on through the chain,
+/// so intermediate data lives in a few line buffers that stay in cache instead of one full
+/// frame per stage, and work outside a crop is never done. Formats are checked and stage
+/// code is specialised at compile time; sizes are checked on every run.
+///
+/// Line buffers are reused across runs and make a pipeline object single-threaded; give
+/// each thread its own copy to process bands of rows in parallel. Planar sources (NV12,
+/// I420) are not supported.
+template <class... Stages>
+class Pipeline {
+    static_assert(sizeof...(Stages) > 0, "a pipeline needs at least one stage");
+    using Formats = detail::StageFormats<Stages...>;
+    static_assert(Formats::valid, "a stage does not accept the pixel format produced before it");
+    static constexpr std::size_t kStages = sizeof...(Stages);
+
+public:
+    static constexpr PixelFormat input_format = Formats::formats.front();
+    static constexpr PixelFormat output_format = Formats::formats.back();
+
+    Pipeline() requires(std::is_default_constructible_v<Stages> && ...) = default;
+    explicit Pipeline(Stages... stages) : stages_(std::move(stages)...) {}
+
+    /// Output format for `input`; throws std::invalid_argument if the input has the wrong
+    /// pixel format or a stage cannot handle its size.
+    StreamFormat output(const StreamFormat& input) const
+    {
+        std::array<Extent, kStages + 1> extents;
+        return output(input, extents);
+    }
+
+    void run(const ConstImageView& src, const ImageView& dst) { run_rows(src, dst, 0, dst.format.height); }
+
+    /// Produces output rows [row_begin, row_end) only. Throws std::invalid_argument if
+    /// `dst` does not have the format `output()` reports.
+    void run_rows(const ConstImageView& src, const ImageView& dst, std::uint32_t row_begin, std::uint32_t row_end)
+    {
+        const StreamFormat out = output(src.format, extents_);
+        if (dst.format.width != out.width || dst.format.height != out.height || dst.format.format != out.format
+            || dst.format.stride < out.stride)
+            throw std::invalid_argument("Pipeline: destination does not match the output format");
+
+        spans_[kStages] = Span{0, out.width};
+        prepare(std::make_index_sequence<kStages>{});
+        src_ = src;
+
+        row_end = std::min(row_end, out.height);
+        const std::size_t bytes = min_stride(output_format, out.width);
+        for (std::uint32_t y = row_begin; y < row_end; ++y) {
+            auto* d = reinterpret_cast<std::uint8_t*>(dst.data) + y * dst.format.stride;
+            const std::uint8_t* row = pull<kStages - 1>(y, d);
+            if (row != d)
+                std::memcpy(d, row, bytes);
+        }
+    }
+
+    template <std::size_t I>
+    auto& stage() noexcept
+    {
+        return std::get<I>(stages_);
+    }
+
+private:
+    StreamFormat output(const StreamFormat& input, std::array<Extent, kStages + 1>& extents) const
+    {
+        if (input.format != input_format)
+            throw std::invalid_argument(std::string("Pipeline: expected ") + to_string(input_format) + " input, got "
+                                        + to_string(input.format));
+        if (input.stride < min_stride(input.format, input.width))
+            throw std::invalid_argument("Pipeline: stride too small");
+        extents[0] = Extent{input.width, input.height};
+        forward(extents, std::make_index_sequence<kStages>{});
+        return StreamFormat::packed(extents[kStages].width, extents[kStages].height, output_format);
+    }
+
+    template <std::size_t... I>
+    void forward(std::array<Extent, kStages + 1>& extents, std::index_sequence<I...>) const
+    {
+        ((extents[I + 1] = std::get<I>(stages_).output_extent(extents[I])), ...);
+    }
+
+    /// Input spans from the last stage back to the first, then line buffers front to back.
+    template <std::size_t... I>
+    void prepare(std::index_sequence<I...>)
+    {
+        ((spans_[kStages - 1 - I] = std::get<kStages - 1 - I>(stages_).input_span(extents_[kStages - 1 - I],
+                                                                                  spans_[kStages - I])),
+         ...);
+        (std::get<I>(stages_).template prepare<Formats::formats[I]>(extents_[I], spans_[I], spans_[I + 1]), ...);
+    }
+
+    template <std::size_t I>
+    const std::uint8_t* pull(std::uint32_t y, std::uint8_t* out)
+    {
+        return std::get<I>(stages_).template row<Formats::formats[I]>(
+            y, out, [this](std::uint32_t input_y, std::uint8_t* buffer) -> const std::uint8_t* {
+                if constexpr (I == 0) {
+                    (void)buffer;
+                    return reinterpret_cast<const std::uint8_t*>(src_.data) + input_y * src_.format.stride
+                         + spans_[0].begin * detail::pipeline_pixel_bytes(input_format);
+                } else {
+                    return pull<I - 1>(input_y, buffer);
+                }
+            });
+    }
+
+    std::tuple<Stages...> stages_;
+    std::array<Extent, kStages + 1> extents_{};
+    std::array<Span, kStages + 1> spans_{};
+    ConstImageView src_;
+};
+
+} // namespace camera_interface
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace camera_interface {
+
+/// Where a camera's acquisition thread runs and where its frame buffers live.
+///
+/// On multi-socket hosts a capture thread filling buffers on another node pays for every
+/// byte twice (remote writes now, remote reads by the consumer later), so cameras are best
+/// kept on one node together with their buffers and their consumers.
+struct Placement {
+    /// Core the acquisition thread is pinned to; -1 leaves it to the scheduler.
+    int cpu = -1;
+    /// Node frame buffers are allocated on; -1 follows `cpu`.
+    int numa_node = -1;
+
+    /// `numa_node`, else the node of `cpu`, else -1 (default memory policy).
+    int memory_node() const noexcept;
+};
+
+/// True when buffers can be bound to a node: built with libnuma and running on a NUMA kernel.
+bool numa_supported() noexcept;
+/// Configured memory nodes; 1 without NUMA support.
+int numa_node_count() noexcept;
+/// Node of `cpu`; 0 without NUMA support, -1 for a core that does not exist.
+int numa_node_of_cpu(int cpu) noexcept;
+/// Node the bus device behind a V4L2 node (e.g. `/dev/video0`) is attached to, from sysfs;
+/// -1 when unknown. Capture threads of that camera are best pinned to this node.
+int v4l2_device_numa_node(const std::string& device);
+
+/// Cores the calling process may run on, ascending.
+std::vector<int> allowed_cpus();
+/// Pins the calling thread to `cpu`; false (with errno set) if that is not allowed.
+bool pin_current_thread(int cpu) noexcept;
+
+/// Throws std::invalid_argument unless `placement` names an allowed core and, where NUMA is
+/// supported, an existing node. Cameras call this at construction.
+void check_placement(const Placement& placement);
+
+/// Automatic placement: hands out cores for capture threads so they spread over the
+/// allowed cores, preferring the node a camera's device is attached to.
+class PlacementPlanner {
+public:
+    /// Plans over `allowed_cpus()`.
+    PlacementPlanner();
+    /// Plans over the given cores only, e.g. to keep some free for consumers.
+    explicit PlacementPlanner(std::vector<int> cpus);
+
+    /// Least used core of `node`, with buffers on that node. With `node` -1, or a node
+    /// none of the cores belong to, the nodes take turns. Empty when there are no cores.
+    Placement place(int node = -1);
+
+    const std::vector<int>& cpus() const noexcept { return cpus_; }
+
+private:
+    std::vector<int> cpus_;
+    std::vector<int> nodes_;    ///< Node of each core.
+    std::vector<unsigned> use_; ///< Threads placed on each core.
+    int next_node_ = 0;
+};
+
+} // namespace camera_interface
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "camera_interface/camera.hpp"
+#include "camera_interface/placement.hpp"
+#include "camera_interface/recording_reader.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace camera_interface {
+
+struct PlaybackConfig {
+    std::string path;
+    /// Pace frames by their recorded timestamps. When false they are served as fast as the
+    /// delivery queue takes them; pair that with `OverflowPolicy::block` to replay every frame.
+    bool realtime = true;
+    /// Speed multiplier for real-time pacing.
+    double speed = 1.0;
+    /// Start over from the first frame at the end instead of stopping.
+    bool loop = false;
+    /// Restamp frames with the monotonic clock at delivery and keep sequence numbers rising
+    /// across loops, seeks and restarts, as a live camera would. When false frames keep their recorded
+    /// sequence and timestamp.
+    bool live_timestamps = true;
+    std::size_t start_frame = 0;
+    /// Frames read ahead of the playback position.
+    std::size_t prefetch_frames = 2;
+    /// Core of the playback thread. Frames are views of the page cache, so `numa_node`
+    /// does not apply.
+    Placement placement;
+    DeliveryConfig delivery;
+};
+
+/// Replays a recording through the `Camera` interface, so a production capture can be fed
+/// through the same pipeline offline. Frames are zero-copy views of the mapped file.
+class PlaybackCamera final : public Camera {
+public:
+    /// Throws like `RecordingReader`, or std::invalid_argument for a bad configuration.
+    explicit PlaybackCamera(const PlaybackConfig& config);
+    ~PlaybackCamera() override;
+
+    void start() override;
+    void stop() override;
+    /// False once playback has reached the end of a non-looping recording.
+    bool is_streaming() const noexcept override
+    {
+        return thread_.joinable() && !finished_.load(std::memory_order_acquire);
+    }
+    StreamFormat format() const override { return reader_.format(); }
+    const FrameBufferPool& pool() const noexcept override { return reader_.pool(); }
+
+    RecordingReader& recording() noexcept { return reader_; }
+
+    /// Moves playback to frame `index`; takes effect with the next frame.
+    void seek(std::size_t index) noexcept;
+    /// Moves playback to the first frame at or after `timestamp_ns` (recorded time).
+    void seek_to_timestamp(std::int64_t timestamp_ns) noexcept;
+    /// Index of the next frame to be served.
+    std::size_t position() const noexcept { return position_.load(std::memory_order_relaxed); }
+
+    std::uint64_t frames_played() const noexcept { return played_.load(std::memory_order_relaxed); }
+    /// Frames skipped because a consumer still held the same frame from an earlier pass.
+    std::uint64_t frames_skipped() const noexcept { return skipped_.load(std::memory_order_relaxed); }
+    std::uint64_t source_drops() const noexcept override { return frames_skipped(); }
+
+private:
+    static constexpr std::size_t kNoSeek = std::numeric_limits<std::size_t>::max();
+
+    void run();
+
+    PlaybackConfig config_;
+    RecordingReader reader_;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> stop_requested_{false};
+    std::atomic<bool> finished_{false};
+    std::atomic<std::size_t> position_{0};
+    std::atomic<std::size_t> seek_to_{kNoSeek};
+    /// Live sequence number of the next frame. Survives stop() / start() so restarted
+    /// playback never repeats a sequence; only the playback thread touches it.
+    std::uint64_t next_sequence_ = 0;
+
+    std::atomic<std::uint64_t> played_{0};
+    std::atomic<std::uint64_t> skipped_{0};
+};
+
+} // namespace camera_interface
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace camera_interface {
+
+/// epoll-driven event loop that lets one thread service many file descriptors.
+///
+/// Callbacks run on whichever thread calls `poll_once()` (one thread at a time), normally
+/// the loop thread started with `start()`. `remove()` does not return while the
+/// descriptor's callback is running on another thread, so objects captured by a callback
+/// may be destroyed right after removing it.
+class Poller {
+public:
+    using Callback = std::function<void(std::uint32_t events)>;
+
+    Poller();
+    ~Poller();
+
+    Poller(const Poller&) = delete;
+    Poller& operator=(const Poller&) = delete;
+
+    /// Registers `fd` (level-triggered) for the given EPOLL* event mask.
+    void add(int fd, std::uint32_t events, Callback callback);
+    void remove(int fd);
+
+    /// Waits up to `timeout` and dispatches ready callbacks; returns how many ran.
+    int poll_once(std::chrono::milliseconds timeout);
+
+    /// Runs `poll_once()` on a dedicated thread until `stop()`, pinned to `cpu` unless it is -1.
+    void start(int cpu = -1);
+    void stop();
+    bool running() const noexcept { return thread_.joinable(); }
+
+    /// Interrupts a blocked `poll_once()`.
+    void wake() noexcept;
+
+private:
+    struct Entry {
+        std::uint64_t id;
+        Callback callback;
+    };
+
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    std::thread thread_;
+    std::atomic<bool> stop_requested_{false};
+
+    std::mutex mutex_;
+    std::condition_variable idle_;
+    std::unordered_map<std::uint64_t, std::shared_ptr<Entry>> entries_;
+    std::unordered_map<int, std::uint64_t> ids_;
+    std::uint64_t next_id_ = 1;
+    std::uint64_t dispatching_ = 0;
+    std::thread::id dispatch_thread_;
+};
+
+} // namespace camera_interface
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "camera_interface/frame_buffer_pool.hpp"
+#include "camera_interface/frame_queue.hpp"
+#include "camera_interface/pixel_format.hpp"
+#include "camera_interface/recording.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace camera_interface {
+
+class ThreadPool;
+
+namespace detail {
+class IoUring;
+}
+
+/// How the recorder's writer thread submits I/O.
+enum class RecorderIo {
+    automatic, ///< io_uring when the kernel allows it, otherwise pwritev.
+    io_uring,  ///< Several batches in flight through io_uring; throws if unavailable.
+    pwritev,   ///< One blocking pwritev per batch.
+};
+
+struct RecorderConfig {
+    std::string path;
+    /// Format of every recorded frame; fixes the record size.
+    StreamFormat format;
+    /// Frames waiting for the writer; power of two. Each one keeps its pool buffer until written.
+    std::size_t queue_depth = 32;
+    /// Most frames gathered into one vectored write.
+    std::size_t batch_frames = 8;
+    /// Batches kept in flight with io_uring.
+    std::size_t max_in_flight = 4;
+    RecorderIo io = RecorderIo::automatic;
+    /// Bypass the page cache. Falls back to buffered writes with write-behind (start writeback
+    /// at once, drop pages once written) on filesystems that refuse O_DIRECT.
+    bool direct_io = true;
+    /// Reserve this much disk space up front so extents are not allocated mid-capture.
+    std::uint64_t preallocate_bytes = 0;
+    /// Compress frames on the writer side; with `FrameCodec::none` they are written verbatim.
+    FrameCodecConfig codec;
+    /// Threads compressing each frame's bands, the writer thread included; 0 uses every
+    /// hardware thread.
+    unsigned codec_threads = 0;
+};
+
+/// Streams frames to a recording file (see `recording.hpp`) from a dedicated writer thread.
+///
+/// `write()` only takes a reference to the frame and queues it, so the capture thread never
+/// copies pixels or waits for the disk. The writer gathers whatever is queued into batches
+/// of consecutive records and writes each with a single vectored call straight from the
+/// frame buffers; only the sub-block tail of each frame goes through a bounce block.
+///
+/// With a codec the writer instead encodes each frame into its batch and releases the
+/// frame buffer right away, trading CPU time for disk bandwidth. The batches then hold
+/// `batch_frames` encoded frames each.
+class Recorder {
+public:
+    /// Creates (or truncates) the file and writes a provisional header; throws
+    /// std::system_error or std::invalid_argument on failure.
+    explicit Recorder(const RecorderConfig& config);
+    /// Closes the recording; errors are swallowed, call `close()` first to see them.
+    ~Recorder();
+
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    /// Queues a frame. Returns false, and counts a drop, when the queue is full, the frame
+    /// does not match the recording format, or the recorder is closed or failed.
+    bool write(FrameHandle frame) noexcept;
+
+    /// Writes out everything queued, then the index and final header. Throws
+    /// std::system_error if any write failed. Idempotent.
+    void close();
+
+    bool is_open() const noexcept { return writer_.joinable(); }
+    bool direct_io() const noexcept { return direct_io_; }
+    bool uses_io_uring() const noexcept { return ring_ != nullptr; }
+    const RecorderConfig& config() const noexcept { return config_; }
+
+    std::uint64_t frames_written() const noexcept { return written_.load(std::memory_order_relaxed); }
+    std::uint64_t frames_dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    std::uint64_t bytes_written() const noexcept { return bytes_.load(std::memory_order_relaxed); }
+    /// Decoded size of the frames written, to compare with `bytes_written()` when compressing.
+    std::uint64_t raw_bytes() const noexcept { return raw_bytes_.load(std::memory_order_relaxed); }
+    /// First I/O error hit by the writer, if any.
+    std::error_code error() const noexcept;
+
+private:
+    struct Batch;
+    struct BlockDeleter {
+        void operator()(std::byte* p) const noexcept;
+    };
+    using Blocks = std::unique_ptr<std::byte[], BlockDeleter>;
+
+    static Blocks allocate_blocks(std::size_t bytes);
+    void run() noexcept;
+    bool append(Batch& batch, FrameHandle& frame) noexcept;
+    void issue(Batch& batch) noexcept;
+    void complete(Batch& batch, std::int64_t result) noexcept;
+    bool reap(unsigned wait_for) noexcept;
+    void fail(int error) noexcept;
+    void write_behind(std::uint64_t offset, std::uint64_t bytes) noexcept;
+    void finalize();
+
+    RecorderConfig config_;
+    int fd_ = -1;
+    bool direct_io_ = false;
+    std::uint64_t record_size_ = 0;
+    std::uint64_t payload_size_ = 0;
+    std::unique_ptr<detail::IoUring> ring_;
+    std::unique_ptr<ThreadPool> codec_pool_;
+    std::unique_ptr<FrameEncoder> encoder_;
+    std::size_t encoded_pitch_ = 0;
+
+    FrameQueue queue_;
+    std::vector<Batch> batches_;
+    std::size_t in_flight_ = 0;
+    std::uint64_t next_offset_ = 0;
+    std::uint64_t behind_offset_ = 0;
+    std::uint64_t behind_bytes_ = 0;
+    std::vector<RecordingIndexEntry> index_;
+    Blocks header_block_;
+
+    std::thread writer_;
+    std::atomic<int> error_{0};
+    std::atomic<std::uint64_t> written_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> bytes_{0};
+    std::atomic<std::uint64_t> raw_bytes_{0};
+};
+
+} // namespace camera_interface
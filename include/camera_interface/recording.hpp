@@ -0,0 +1,85 @@
+#pragma once
+
+// On-disk layout of a frame recording, shared by `Recorder` and the playback side.
+//
+//   [ RecordingHeader, padded to one block                  ]  offset 0
+//   [ record 0: RecordHeader block | payload, block padded  ]  data_offset
+//   [ record 1 ...                                          ]  data_offset + record_size
+//   [ RecordingIndexEntry[frame_count], block padded        ]  index_offset
+//
+// Without a codec every record has the same size, so record i starts at data_offset + i *
+// record_size. With one (`RecordingHeader::codec`), each payload is an encoded frame (see
+// `frame_codec.hpp`) and records are packed: one ends after its header block plus its
+// `stored_bytes` rounded up to a block. Everything is aligned to `kRecordingBlock` so it can
+// be written with O_DIRECT straight from frame buffers. Integers are stored in host byte
+// order. The header's `index_offset` and `frame_count` are only filled in once the recording
+// is closed; an unfinished file can still be recovered by walking the per-record headers.
+
+#include "camera_interface/frame_codec.hpp"
+#include "camera_interface/pixel_format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace camera_interface {
+
+/// Alignment of every structure in a recording; a multiple of any O_DIRECT block size.
+inline constexpr std::size_t kRecordingBlock = 4096;
+
+inline constexpr char kRecordingMagic[8] = {'C', 'A', 'M', 'R', 'E', 'C', '0', '1'};
+inline constexpr std::uint32_t kRecordMagic = 0x43455246; // "FREC"
+/// Version 2 added `codec`; version 1 files are read as uncompressed.
+inline constexpr std::uint32_t kRecordingVersion = 2;
+
+/// `RecordingHeader::flags`: the index and frame count are valid.
+inline constexpr std::uint32_t kRecordingFinalized = 1u << 0;
+
+struct RecordingHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint32_t width;
+    std::uint32_t height;
+    std::uint32_t fourcc; ///< V4L2 fourcc of the pixel format.
+    std::uint32_t stride;
+    std::uint64_t frame_bytes; ///< Largest decoded frame.
+    std::uint64_t record_size; ///< Largest record; the size of every record without a codec.
+    std::uint64_t data_offset;
+    std::uint64_t frame_count;
+    std::uint64_t index_offset;
+    std::int64_t created_realtime_ns;
+    std::uint32_t codec; ///< FrameCodec of every payload.
+    std::uint8_t reserved[44];
+};
+static_assert(sizeof(RecordingHeader) == 128);
+
+/// First block of every record.
+struct RecordHeader {
+    std::uint32_t magic;
+    std::uint32_t stored_bytes; ///< Encoded payload size with a codec, otherwise 0.
+    std::uint64_t sequence;
+    std::int64_t timestamp_ns;
+    std::uint64_t bytes_used;   ///< Decoded frame size.
+};
+static_assert(sizeof(RecordHeader) == 32);
+
+struct RecordingIndexEntry {
+    std::uint64_t sequence;
+    std::int64_t timestamp_ns;
+    std::uint64_t offset; ///< Of the payload, i.e. just past the record's header block.
+    std::uint64_t bytes_used; ///< Decoded frame size.
+};
+static_assert(sizeof(RecordingIndexEntry) == 32);
+
+constexpr std::uint64_t round_up_to_block(std::uint64_t bytes) noexcept
+{
+    return (bytes + kRecordingBlock - 1) / kRecordingBlock * kRecordingBlock;
+}
+
+/// Size of one record holding frames of `format`.
+inline std::uint64_t recording_record_size(const StreamFormat& format) noexcept
+{
+    return kRecordingBlock + round_up_to_block(format.frame_size());
+}
+
+} // namespace camera_interface
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "camera_interface/frame_buffer_pool.hpp"
+#include "camera_interface/pixel_format.hpp"
+#include "camera_interface/recording.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace camera_interface {
+
+/// Read-only, memory-mapped view of a recording written by `Recorder`.
+///
+/// Frames are served as `FrameHandle`s pointing straight into the mapping, one pool slot per
+/// record, so reading never copies pixels. The mapping is private, so a consumer that writes
+/// to a frame never modifies the file, though its changes stay visible to later readers of
+/// that frame through this object. Handles keep the mapping alive and may outlive the reader.
+///
+/// Compressed recordings are decoded instead, into a small pool of frame buffers.
+class RecordingReader {
+public:
+    /// Throws std::system_error if the file cannot be opened or mapped and std::runtime_error
+    /// if it is not a recording. Files that were never closed are indexed by walking their
+    /// record headers. `decode_buffers` frames of a compressed recording can be held at once.
+    explicit RecordingReader(const std::string& path, std::size_t decode_buffers = 8);
+    ~RecordingReader();
+
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    const StreamFormat& format() const noexcept { return format_; }
+    const RecordingHeader& header() const noexcept { return header_; }
+    std::size_t frame_count() const noexcept { return index_.size(); }
+    /// False when the index was recovered from an unfinished file.
+    bool finalized() const noexcept { return (header_.flags & kRecordingFinalized) != 0; }
+    FrameCodec codec() const noexcept { return static_cast<FrameCodec>(header_.codec); }
+
+    const RecordingIndexEntry& entry(std::size_t index) const noexcept { return index_[index]; }
+    /// First frame whose timestamp is at or after `timestamp_ns`; `frame_count()` if none.
+    /// Timestamps are assumed to be non-decreasing, as captured.
+    std::size_t find(std::int64_t timestamp_ns) const noexcept;
+
+    /// Zero-copy frame `index` with its recorded sequence and timestamp. Empty when out of
+    /// range or when that frame is still held through an earlier handle. For a compressed
+    /// recording, a decoded copy; empty when every decode buffer is held or the frame is
+    /// corrupt.
+    FrameHandle frame(std::size_t index) noexcept;
+
+    /// Stored bytes of frame `index` (encoded, for a compressed recording), without going
+    /// through the pool.
+    std::span<const std::byte> payload(std::size_t index) const noexcept;
+
+    /// Asks the kernel to read frames [index, index + count) ahead of use.
+    void prefetch(std::size_t index, std::size_t count) const noexcept;
+
+    const FrameBufferPool& pool() const noexcept { return *pool_; }
+
+private:
+    struct Mapping;
+
+    void load_index();
+
+    std::shared_ptr<Mapping> mapping_;
+    RecordingHeader header_{};
+    StreamFormat format_;
+    std::vector<RecordingIndexEntry> index_;
+    std::vector<std::uint32_t> stored_bytes_; ///< Per frame, for a compressed recording.
+    std::unique_ptr<FrameBufferPool> pool_;
+};
+
+} // namespace camera_interface
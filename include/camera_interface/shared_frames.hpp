@@ -0,0 +1,146 @@
+#pragma once
+
+#include "camera_interface/frame_buffer_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace camera_interface {
+
+namespace detail {
+struct SharedRegion;
+struct SharedAttachment;
+}
+
+struct FramePublisherConfig {
+    /// POSIX shared-memory name ("/camera0") subscribers open by name. Empty creates an
+    /// anonymous memfd instead, to be handed to subscribers as a descriptor (`fd()`).
+    std::string name;
+    /// Frame buffers in the region; a frame keeps its buffer until every subscriber it was
+    /// published to has dropped it.
+    std::size_t slot_count = 8;
+    std::size_t slot_size = 0; ///< Bytes per buffer; at least the largest frame.
+    std::size_t max_subscribers = 8; ///< At most 64.
+    /// When every buffer is pinned, take back the oldest frames that lagging subscribers have
+    /// not picked up yet (counted in their `dropped()`) instead of stalling every subscriber
+    /// behind the slowest one.
+    bool evict_lagging = true;
+};
+
+/// Fans one camera stream out to other processes through shared memory.
+///
+/// The region holds the frame buffers, a descriptor per buffer and a lock-free ring of
+/// published buffer indices. Publishing copies a frame into a free buffer once, whatever the
+/// number of subscribers, or nothing at all for frames written in place into a buffer from
+/// `acquire()`. Each buffer carries a bitmask of the subscribers that still reference it and
+/// is reused only once that mask is clear, so no process ever sees a buffer rewritten under
+/// it. Subscribers that exit without cleaning up are reaped by process id.
+///
+///     FramePublisher publisher({.name = "/camera0", .slot_size = camera.format().frame_size()});
+///     while (FrameHandle frame = camera.grab(timeout))
+///         publisher.publish(frame);
+///
+/// `acquire()` and `publish()` must be called from one thread at a time.
+class FramePublisher {
+public:
+    /// Creates and maps the region; throws std::invalid_argument for a bad configuration
+    /// and std::system_error if it cannot be created. A stale region with the same name is
+    /// replaced.
+    explicit FramePublisher(const FramePublisherConfig& config);
+    /// Marks the stream finished, wakes subscribers and unlinks the name. Subscribers keep
+    /// their mappings and drain what was already published.
+    ~FramePublisher();
+
+    FramePublisher(const FramePublisher&) = delete;
+    FramePublisher& operator=(const FramePublisher&) = delete;
+
+    /// A free shared buffer to fill in place and pass to `publish()` without a copy; empty
+    /// when every buffer is pinned. The handle keeps the region mapped and may outlive the
+    /// publisher.
+    FrameHandle acquire() noexcept;
+
+    /// Hands `frame` to every current subscriber: zero-copy for buffers from `acquire()`,
+    /// one copy of `info().bytes_used` bytes otherwise. Returns false, without copying, when
+    /// there is no subscriber or no buffer could be freed, or if the frame does not fit.
+    bool publish(const FrameHandle& frame) noexcept;
+
+    /// Releases the buffers of subscribers whose process has exited. Done automatically when
+    /// no buffer is free.
+    std::size_t reap() noexcept;
+
+    const std::string& name() const noexcept { return name_; }
+    /// Descriptor of the region, for passing an anonymous region over a UNIX socket or to
+    /// a child process. Owned by the publisher.
+    int fd() const noexcept { return fd_; }
+
+    std::size_t subscribers() const noexcept;
+    std::uint64_t published() const noexcept { return published_; }
+    /// Frames not published because every buffer was pinned.
+    std::uint64_t dropped() const noexcept { return dropped_; }
+    /// Frames taken back from lagging subscribers.
+    std::uint64_t evicted() const noexcept { return evicted_; }
+
+private:
+    /// A buffer no subscriber references, claimed so that `acquire()` cannot hand it out.
+    FrameHandle claim_free() noexcept;
+    /// Takes back frames lagging subscribers have not picked up, oldest first, until one
+    /// buffer is free; false if every pinned buffer is actually held.
+    bool evict() noexcept;
+    void wake() noexcept;
+
+    std::string name_;
+    int fd_ = -1;
+    bool evict_lagging_ = true;
+    std::shared_ptr<detail::SharedRegion> region_;
+    std::unique_ptr<FrameBufferPool> pool_;
+    std::uint64_t published_ = 0;
+    std::uint64_t dropped_ = 0;
+    std::uint64_t evicted_ = 0;
+};
+
+/// Receives the frames of a `FramePublisher`, usually in another process.
+///
+/// Frames arrive as `FrameHandle`s pointing straight into the shared buffers; dropping the
+/// last handle tells the publisher the buffer is free again. Handles may outlive the
+/// subscriber, but keep their buffers pinned until they are dropped. A subscriber sees the
+/// frames published after it joined, in order, minus any the publisher evicted because it
+/// fell behind.
+class FrameSubscriber {
+public:
+    /// Opens a named region. Throws std::system_error if it does not exist and
+    /// std::runtime_error if it is not a frame region or has no free subscriber entry.
+    explicit FrameSubscriber(const std::string& name);
+    /// Maps the region behind `fd`, e.g. a descriptor received from the publisher; `fd` is
+    /// not taken over.
+    explicit FrameSubscriber(int fd);
+    ~FrameSubscriber();
+
+    FrameSubscriber(const FrameSubscriber&) = delete;
+    FrameSubscriber& operator=(const FrameSubscriber&) = delete;
+
+    /// Waits up to `timeout` for the next frame; returns an empty handle on timeout or once
+    /// the publisher has gone and every frame published to this subscriber was taken.
+    FrameHandle next(std::chrono::nanoseconds timeout);
+    /// Returns the next frame if one is ready, otherwise an empty handle.
+    FrameHandle try_next() noexcept;
+
+    /// True once the publisher has been destroyed.
+    bool closed() const noexcept;
+
+    std::uint64_t received() const noexcept { return received_; }
+    /// Frames published to this subscriber that it never saw because it fell behind.
+    std::uint64_t dropped() const noexcept;
+
+private:
+    void attach(int fd);
+
+    std::shared_ptr<detail::SharedAttachment> attachment_;
+    std::unique_ptr<FrameBufferPool> pool_;
+    std::uint64_t received_ = 0;
+};
+
+} // namespace camera_interface
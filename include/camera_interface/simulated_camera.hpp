@@ -0,0 +1,93 @@
+#pragma once
+
+#include "camera_interface/camera.hpp"
+#include "camera_interface/placement.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace camera_interface {
+
+enum class TestPattern {
+    none,     ///< Leave buffer contents untouched; measures the pipeline, not the generator.
+    gradient, ///< Diagonal ramp that moves one step per frame.
+};
+
+struct SimulatedCameraConfig {
+    StreamFormat format = StreamFormat::packed(1920, 1080, PixelFormat::bayer_rggb8);
+    double frame_rate = 30.0;
+    /// Each frame is released uniformly within +/- `jitter` of its nominal slot.
+    std::chrono::nanoseconds jitter{0};
+    /// Probability that the "sensor" loses a frame; lost frames still consume a sequence number.
+    double drop_probability = 0.0;
+    std::uint64_t seed = 1;
+    /// Pace frames in real time; when false frames are produced as fast as the pool allows,
+    /// but timestamps still follow the nominal schedule.
+    bool realtime = true;
+    TestPattern pattern = TestPattern::gradient;
+    /// Reported in each frame's metadata; an exposure of 0 reports the full frame period.
+    std::chrono::microseconds exposure{0};
+    float gain = 1.0f;
+    std::size_t pool_capacity = 8;
+    /// Core of the acquisition thread and node of the frame buffers.
+    Placement placement;
+    DeliveryConfig delivery;
+};
+
+/// Software camera for load-testing the acquisition pipeline without hardware.
+///
+/// Frame timing, jitter and drops are derived from `seed` alone, so two runs with the same
+/// configuration produce the same sequence numbers, timestamps and losses. The frame rate
+/// and readout window can be changed while streaming, as with a sensor that supports it.
+class SimulatedCamera final : public Camera {
+public:
+    explicit SimulatedCamera(const SimulatedCameraConfig& config);
+    ~SimulatedCamera() override;
+
+    void start() override;
+    void stop() override;
+    bool is_streaming() const noexcept override { return thread_.joinable(); }
+    StreamFormat format() const override;
+    const FrameBufferPool& pool() const noexcept override { return pool_; }
+
+    std::uint64_t frames_produced() const noexcept { return produced_.load(std::memory_order_relaxed); }
+    /// Frames lost by injected drops.
+    std::uint64_t frames_dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    /// Frames lost because every pool buffer was still held downstream.
+    std::uint64_t pool_starved() const noexcept { return starved_.load(std::memory_order_relaxed); }
+    std::uint64_t source_drops() const noexcept override { return frames_dropped() + pool_starved(); }
+
+    double frame_rate() const noexcept override { return frame_rate_.load(std::memory_order_relaxed); }
+    /// Takes effect from the next frame; the schedule continues from the last timestamp.
+    bool set_frame_rate(double frame_rate) noexcept override;
+    /// Crops, then bins, `config.format`. Widths and heights are rounded down to even values
+    /// for formats that pair pixels. Returns false if the window leaves the frame or is empty.
+    bool set_window(const SensorWindow& window) noexcept override;
+
+private:
+    void run();
+    void fill(FrameHandle& frame, const StreamFormat& format, std::uint64_t sequence) noexcept;
+
+    SimulatedCameraConfig config_;
+    FrameBufferPool pool_;
+    std::vector<std::byte> ramp_;
+
+    std::thread thread_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> stop_requested_{false};
+    std::atomic<double> frame_rate_;
+    StreamFormat format_; ///< Current readout format; guarded by `mutex_`.
+
+    std::atomic<std::uint64_t> produced_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> starved_{0};
+};
+
+} // namespace camera_interface
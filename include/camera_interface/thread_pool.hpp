@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace camera_interface {
+
+/// Fixed set of worker threads with one task deque each.
+///
+/// A worker pops its own deque newest-first, which keeps freshly split work in its cache, and
+/// steals oldest-first from the others when it runs dry. Tasks posted from outside the pool are
+/// spread round-robin. Threads that block in `parallel_for()` run pending tasks while they wait,
+/// so nested parallelism cannot deadlock.
+class ThreadPool {
+public:
+    /// Tasks are plain function pointers with a context so posting never allocates a closure.
+    using TaskFn = void (*)(void* context, std::size_t index) noexcept;
+
+    /// `threads == 0` uses one worker per hardware thread.
+    explicit ThreadPool(unsigned threads = 0);
+    /// Runs every task already posted, then joins the workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const noexcept { return static_cast<unsigned>(workers_.size()); }
+
+    /// Queues `fn(context, index)`; from a worker of this pool it lands on that worker's deque.
+    void post(TaskFn fn, void* context, std::size_t index);
+
+    /// Runs `body(i)` for every i in [0, count) across the pool and returns when all are done.
+    /// The calling thread takes part. `body` must not throw.
+    template <typename F>
+    void parallel_for(std::size_t count, F&& body);
+
+    /// Runs one pending task on the calling thread; false when every deque is empty.
+    bool run_one() noexcept;
+
+    /// Tasks a worker took from another worker's deque.
+    std::uint64_t steals() const noexcept { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    struct Task {
+        TaskFn fn;
+        void* context;
+        std::size_t index;
+    };
+
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+        std::thread thread;
+    };
+
+    void run_worker(unsigned self);
+    bool pop_local(unsigned self, Task& task) noexcept;
+    bool steal(unsigned start, Task& task) noexcept;
+    /// Helps with pending work until `remaining` drops to zero.
+    void wait_for(const std::atomic<std::size_t>& remaining) noexcept;
+    /// Signals threads blocked in `wait_for()` that some batch finished.
+    void notify_completion() noexcept;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<std::uint32_t> work_epoch_{0};
+    std::atomic<std::uint32_t> sleepers_{0};
+    std::atomic<std::uint32_t> completion_epoch_{0};
+    std::atomic<std::uint32_t> next_{0};
+    std::atomic<std::uint64_t> steals_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+template <typename F>
+void ThreadPool::parallel_for(std::size_t count, F&& body)
+{
+    if (count == 0)
+        return;
+    struct Batch {
+        ThreadPool* pool;
+        std::remove_reference_t<F>* body;
+        std::atomic<std::size_t> remaining;
+    };
+    Batch batch{this, &body, count};
+    const TaskFn run = [](void* context, std::size_t index) noexcept {
+        auto* b = static_cast<Batch*>(context);
+        ThreadPool* pool = b->pool;
+        (*b->body)(index);
+        // `b` lives on the waiting thread's stack and may be gone once the count hits zero.
+        if (b->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            pool->notify_completion();
+    };
+    for (std::size_t i = 1; i < count; ++i)
+        post(run, &batch, i);
+    run(&batch, 0);
+    wait_for(batch.remaining);
+}
+
+} // namespace camera_interface
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "camera_interface/camera.hpp"
+#include "camera_interface/placement.hpp"
+#include "camera_interface/poller.hpp"
+#include "camera_interface/v4l2_io.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace camera_interface {
+
+enum class V4l2Memory {
+    mmap,   ///< Driver-allocated buffers mapped into the process (V4L2_MEMORY_MMAP).
+    dmabuf, ///< Caller-supplied DMABUF descriptors imported by the driver (V4L2_MEMORY_DMABUF).
+};
+
+struct V4l2Config {
+    std::string device = "/dev/video0";
+    std::uint32_t width = 0;  ///< 0 keeps the driver's current size.
+    std::uint32_t height = 0;
+    PixelFormat format = PixelFormat::yuyv;
+    double frame_rate = 0.0;  ///< 0 keeps the driver's current rate.
+    std::uint32_t buffer_count = 4;
+    V4l2Memory memory = V4l2Memory::mmap;
+    std::vector<int> dmabuf_fds; ///< One per buffer for `V4l2Memory::dmabuf`; owned by the caller.
+    /// `cpu` pins the poller thread if this camera is the one that starts it. Buffers belong
+    /// to the driver, so `numa_node` does not apply; place the camera on the node its device
+    /// is attached to (`v4l2_device_numa_node()`) instead.
+    Placement placement;
+    DeliveryConfig delivery;
+};
+
+/// Video4Linux2 capture backend using streaming I/O.
+///
+/// Driver buffers are exposed directly as frames: the pool wraps the mmapped (or imported
+/// DMABUF) buffers, a dequeued buffer becomes a `FrameHandle`, and dropping the last
+/// handle re-queues it with VIDIOC_QBUF. No pixel data is copied.
+///
+/// Dequeuing is driven by a `Poller`. Passing the same poller to many cameras lets one
+/// thread service all of them; without one, the camera runs a private poller thread.
+class V4l2Camera final : public Camera {
+public:
+    explicit V4l2Camera(const V4l2Config& config, std::shared_ptr<Poller> poller = nullptr);
+    /// Uses an already opened device, e.g. a `FakeV4l2Device`; `config.device` is ignored.
+    V4l2Camera(std::unique_ptr<V4l2Io> io, const V4l2Config& config, std::shared_ptr<Poller> poller = nullptr);
+    ~V4l2Camera() override;
+
+    /// Also samples the exposure and gain controls, which are reported in every frame's
+    /// metadata until the next start.
+    void start() override;
+    void stop() override;
+    bool is_streaming() const noexcept override { return streaming_.load(std::memory_order_acquire); }
+    StreamFormat format() const override { return format_; }
+    const FrameBufferPool& pool() const noexcept override { return *pool_; }
+
+    /// Dequeues every completed buffer and delivers it. Called by the poller; exposed for
+    /// callers that run their own event loop on `fd()`.
+    void service();
+
+    int fd() const noexcept;
+
+    /// Exports an MMAP buffer as a DMABUF descriptor (VIDIOC_EXPBUF) for zero-copy hand-off
+    /// to other devices. The caller owns the returned descriptor.
+    int export_dmabuf(std::uint32_t index) const;
+
+    /// Frames the driver reported as lost (gaps in the buffer sequence numbers).
+    std::uint64_t driver_drops() const noexcept { return driver_drops_.load(std::memory_order_relaxed); }
+    std::uint64_t source_drops() const noexcept override { return driver_drops(); }
+
+    double frame_rate() const noexcept override { return frame_rate_.load(std::memory_order_relaxed); }
+    /// VIDIOC_S_PARM while streaming. Many drivers refuse (EBUSY) or round to a supported
+    /// interval; the rate they settle on is what `frame_rate()` reports.
+    bool set_frame_rate(double frame_rate) noexcept override;
+
+private:
+    struct Device;
+
+    void configure(const V4l2Config& config);
+    void read_controls() noexcept;
+
+    std::shared_ptr<Device> device_;
+    std::unique_ptr<FrameBufferPool> pool_;
+    std::shared_ptr<Poller> poller_;
+    StreamFormat format_;
+    std::atomic<bool> streaming_{false};
+    bool have_sequence_ = false;
+    std::uint32_t last_sequence_ = 0;
+    std::uint32_t exposure_us_ = 0;
+    float gain_ = 0.0f;
+    std::atomic<std::uint64_t> driver_drops_{0};
+    std::atomic<double> frame_rate_{0.0};
+    int poller_cpu_ = -1;
+};
+
+} // namespace camera_interface
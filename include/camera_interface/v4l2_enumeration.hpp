@@ -0,0 +1,144 @@
+#pragma once
+
+#include "camera_interface/pixel_format.hpp"
+#include "camera_interface/v4l2_io.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace camera_interface {
+
+struct V4l2FrameSize {
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    /// Supported frame rates. For a stepwise or continuous range, its slowest and fastest rate.
+    std::vector<double> frame_rates;
+
+    bool operator==(const V4l2FrameSize&) const = default;
+};
+
+struct V4l2FormatInfo {
+    std::uint32_t fourcc = 0;
+    std::string description;
+    /// Discrete sizes. For a stepwise or continuous range, its smallest and largest size.
+    std::vector<V4l2FrameSize> sizes;
+
+    /// The format as this library knows it, if it does.
+    std::optional<PixelFormat> pixel_format() const noexcept { return from_v4l2_fourcc(fourcc); }
+
+    bool operator==(const V4l2FormatInfo&) const = default;
+};
+
+struct V4l2ControlInfo {
+    std::uint32_t id = 0;
+    std::uint32_t type = 0; ///< V4L2_CTRL_TYPE_*.
+    std::string name;
+    std::int64_t minimum = 0;
+    std::int64_t maximum = 0;
+    std::int64_t step = 0;
+    std::int64_t default_value = 0;
+    std::uint32_t flags = 0;
+
+    bool operator==(const V4l2ControlInfo&) const = default;
+};
+
+/// What must match for cached capabilities to be trusted: the driver and its version (a
+/// kernel or firmware update can change what a device offers), the card and bus position
+/// (a different camera plugged into the same port) and the device number of the node.
+struct V4l2DeviceIdentity {
+    std::string driver;
+    std::string card;
+    std::string bus_info;
+    std::uint32_t version = 0;
+    std::uint64_t device_number = 0; ///< st_rdev of the node; 0 when it is not a device file.
+
+    bool operator==(const V4l2DeviceIdentity&) const = default;
+};
+
+struct V4l2DeviceInfo {
+    std::string path;
+    V4l2DeviceIdentity identity;
+    std::uint32_t capabilities = 0; ///< V4L2_CAP_* of this node.
+    std::vector<V4l2FormatInfo> formats;
+    std::vector<V4l2ControlInfo> controls;
+    /// Taken from a `V4l2CapabilityCache` rather than probed.
+    bool cached = false;
+
+    /// True for nodes `V4l2Camera` can stream from.
+    bool can_capture() const noexcept;
+};
+
+/// One VIDIOC_QUERYCAP; `path` is only used for its device number. Throws std::system_error.
+V4l2DeviceIdentity query_v4l2_identity(V4l2Io& io, const std::string& path);
+
+/// Queries every format, frame size, frame interval and control of a device. Queries a
+/// driver does not implement leave their part empty. Throws std::system_error if the
+/// device does not answer QUERYCAP.
+V4l2DeviceInfo probe_v4l2_device(V4l2Io& io, const std::string& path);
+
+/// On-disk record of probed device capabilities, keyed by node path and checked against
+/// the device's `V4l2DeviceIdentity` on every lookup.
+///
+/// The file is plain text with a version line; a missing, unreadable, malformed or
+/// outdated file simply yields an empty cache.
+class V4l2CapabilityCache {
+public:
+    explicit V4l2CapabilityCache(std::string path);
+
+    const std::string& path() const noexcept { return path_; }
+    std::size_t size() const noexcept { return entries_.size(); }
+    /// True when entries changed since the file was loaded or last saved.
+    bool dirty() const noexcept { return dirty_; }
+
+    /// Cached capabilities of `device_path`, or null if there are none or `identity` differs.
+    const V4l2DeviceInfo* find(const std::string& device_path, const V4l2DeviceIdentity& identity) const;
+    void store(const V4l2DeviceInfo& info);
+    void erase(const std::string& device_path);
+    /// Drops the entries of devices not in `device_paths`, e.g. after one was unplugged.
+    void retain(const std::vector<std::string>& device_paths);
+
+    /// Writes the file atomically (unique temporary file, fsync, then rename). Throws
+    /// std::system_error.
+    void save();
+
+private:
+    std::string path_;
+    std::map<std::string, V4l2DeviceInfo> entries_;
+    bool dirty_ = false;
+};
+
+struct V4l2EnumerationConfig {
+    /// Nodes to look at; empty scans `directory` for video* nodes.
+    std::vector<std::string> paths;
+    std::string directory = "/dev";
+    /// Capability cache file; empty probes every device.
+    std::string cache_path;
+    /// Devices opened and probed at once; 0 handles all of them concurrently.
+    unsigned threads = 0;
+    /// Leave out nodes that cannot stream video capture (metadata, output, ...).
+    bool capture_only = true;
+    /// How nodes are opened; replaceable so `FakeV4l2Device`s can stand in for hardware.
+    std::function<std::unique_ptr<V4l2Io>(const std::string&)> open = open_v4l2_device;
+};
+
+struct V4l2Enumeration {
+    /// Sorted by path.
+    std::vector<V4l2DeviceInfo> devices;
+    /// Nodes that could not be opened or queried, with the error.
+    std::vector<std::pair<std::string, std::string>> failures;
+    std::size_t cache_hits = 0;
+};
+
+/// Opens and probes V4L2 devices in parallel. With a cache, a device whose identity still
+/// matches costs a single QUERYCAP; the others are probed in full and the cache file is
+/// rewritten if anything changed. Errors saving the cache are ignored.
+V4l2Enumeration enumerate_v4l2_devices(const V4l2EnumerationConfig& config = {});
+
+} // namespace camera_interface
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "camera_interface/pixel_format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace camera_interface {
+
+/// The handful of syscalls the V4L2 backend makes on a device node.
+///
+/// The seam exists so the backend runs unchanged against a real `/dev/videoN` (including
+/// the `vivid` virtual driver) or against `FakeV4l2Device` in environments without video
+/// hardware. Methods follow syscall conventions: -1 / MAP_FAILED with errno set on failure.
+class V4l2Io {
+public:
+    virtual ~V4l2Io();
+
+    /// Descriptor that becomes readable (EPOLLIN) when a buffer can be dequeued.
+    virtual int fd() const noexcept = 0;
+    virtual int ioctl(unsigned long request, void* arg) noexcept = 0;
+    virtual void* mmap(std::size_t length, std::int64_t offset) noexcept = 0;
+    virtual void munmap(void* address, std::size_t length) noexcept = 0;
+};
+
+/// Opens a real device node non-blocking; throws std::system_error on failure.
+std::unique_ptr<V4l2Io> open_v4l2_device(const std::string& path);
+
+/// V4L2 fourcc for a pixel format.
+std::uint32_t to_v4l2_fourcc(PixelFormat format) noexcept;
+std::optional<PixelFormat> from_v4l2_fourcc(std::uint32_t fourcc) noexcept;
+
+} // namespace camera_interface
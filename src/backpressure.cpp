@@ -0,0 +1,161 @@
+#include "camera_interface/backpressure.hpp"
+
+#include "camera_interface/camera.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace camera_interface {
+
+const char* to_string(BackpressureAction action) noexcept
+{
+    switch (action) {
+    case BackpressureAction::decimate: return "decimate";
+    case BackpressureAction::reduce_frame_rate: return "reduce_frame_rate";
+    case BackpressureAction::reduce_window: return "reduce_window";
+    }
+    return "unknown";
+}
+
+Backpressure::Backpressure(Camera& camera, const BackpressurePolicy& policy, std::size_t queue_capacity)
+    : camera_(camera), policy_(policy)
+{
+    if (!(policy_.low_watermark >= 0.0 && policy_.low_watermark < policy_.high_watermark
+          && policy_.high_watermark <= 1.0))
+        throw std::invalid_argument("Backpressure: watermarks must satisfy 0 <= low < high <= 1");
+    if (policy_.interval.count() <= 0)
+        throw std::invalid_argument("Backpressure: interval must be positive");
+    if (!(policy_.min_frame_rate_scale > 0.0 && policy_.min_frame_rate_scale <= 1.0))
+        throw std::invalid_argument("Backpressure: min_frame_rate_scale must be in (0, 1]");
+
+    for (const BackpressureAction action : policy_.actions) {
+        switch (action) {
+        case BackpressureAction::decimate:
+            for (std::uint32_t factor = 2; factor <= policy_.max_decimation; factor *= 2)
+                steps_.push_back(Step{action, static_cast<double>(factor)});
+            break;
+        case BackpressureAction::reduce_frame_rate:
+            for (double scale = 0.5; scale >= policy_.min_frame_rate_scale; scale /= 2)
+                steps_.push_back(Step{action, scale});
+            break;
+        case BackpressureAction::reduce_window:
+            steps_.push_back(Step{action, 0.0});
+            break;
+        }
+    }
+    high_depth_ = std::max<std::size_t>(
+        1, static_cast<std::size_t>(std::ceil(policy_.high_watermark * static_cast<double>(queue_capacity))));
+    low_depth_ = static_cast<std::size_t>(policy_.low_watermark * static_cast<double>(queue_capacity));
+}
+
+bool Backpressure::admit(std::size_t queue_size, std::int64_t now_ns) noexcept
+{
+    peak_depth_ = std::max(peak_depth_, queue_size);
+    if (now_ns >= next_evaluation_ns_)
+        evaluate(now_ns);
+    const std::uint32_t decimation = decimation_.load(std::memory_order_relaxed);
+    if (decimation > 1 && frame_counter_++ % decimation != 0) {
+        decimated_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void Backpressure::consumed(std::int64_t latency_ns) noexcept
+{
+    std::int64_t peak = peak_latency_ns_.load(std::memory_order_relaxed);
+    while (latency_ns > peak
+           && !peak_latency_ns_.compare_exchange_weak(peak, latency_ns, std::memory_order_relaxed)) {
+    }
+}
+
+BackpressureState Backpressure::state() const noexcept
+{
+    BackpressureState state;
+    state.level = level_.load(std::memory_order_relaxed);
+    state.decimation = decimation_.load(std::memory_order_relaxed);
+    state.frame_rate_scale = frame_rate_scale_.load(std::memory_order_relaxed);
+    state.reduced_window = reduced_window_.load(std::memory_order_relaxed);
+    state.escalations = escalations_.load(std::memory_order_relaxed);
+    state.relaxations = relaxations_.load(std::memory_order_relaxed);
+    state.decimated = decimated_.load(std::memory_order_relaxed);
+    return state;
+}
+
+void Backpressure::evaluate(std::int64_t now_ns) noexcept
+{
+    const bool first = next_evaluation_ns_ == 0;
+    next_evaluation_ns_ = now_ns + std::chrono::nanoseconds(policy_.interval).count();
+    const std::size_t depth = std::exchange(peak_depth_, 0);
+    const std::int64_t latency = peak_latency_ns_.exchange(0, std::memory_order_relaxed);
+    if (first)
+        return;
+
+    const std::int64_t max_latency = policy_.max_latency.count();
+    const bool congested = depth >= high_depth_ || (max_latency > 0 && latency >= max_latency);
+    const bool clear = depth <= low_depth_ && (max_latency <= 0 || latency < max_latency / 2);
+    congested_ = congested ? congested_ + 1 : 0;
+    clear_ = clear ? clear_ + 1 : 0;
+
+    const unsigned level = level_.load(std::memory_order_relaxed);
+    if (congested_ >= policy_.escalate_after && level < steps_.size()) {
+        congested_ = 0;
+        // A step the camera rejects is dropped from the ladder, along with the rest of its kind.
+        while (level < steps_.size() && !apply(level + 1)) {
+            const BackpressureAction rejected = steps_[level].action;
+            steps_.erase(std::remove_if(steps_.begin() + level, steps_.end(),
+                                        [rejected](const Step& step) { return step.action == rejected; }),
+                         steps_.end());
+        }
+        if (level < steps_.size()) {
+            level_.store(level + 1, std::memory_order_relaxed);
+            escalations_.fetch_add(1, std::memory_order_relaxed);
+        }
+    } else if (clear_ >= policy_.relax_after && level > 0) {
+        clear_ = 0;
+        // A restore the camera refuses leaves the stream degraded, so the level stays put
+        // and the restore is retried after the next run of clear samples.
+        if (apply(level - 1)) {
+            level_.store(level - 1, std::memory_order_relaxed);
+            relaxations_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool Backpressure::apply(unsigned level) noexcept
+{
+    std::uint32_t decimation = 1;
+    double rate_scale = 1.0;
+    bool window = false;
+    for (unsigned i = 0; i < level; ++i) {
+        switch (steps_[i].action) {
+        case BackpressureAction::decimate: decimation = static_cast<std::uint32_t>(steps_[i].value); break;
+        case BackpressureAction::reduce_frame_rate: rate_scale = steps_[i].value; break;
+        case BackpressureAction::reduce_window: window = true; break;
+        }
+    }
+
+    if (rate_scale != applied_rate_scale_) {
+        if (nominal_rate_ <= 0.0)
+            nominal_rate_ = camera_.frame_rate();
+        if (nominal_rate_ <= 0.0 || !camera_.set_frame_rate(nominal_rate_ * rate_scale))
+            return false;
+        applied_rate_scale_ = rate_scale;
+        // Published now so state() stays truthful even if the window change below fails.
+        frame_rate_scale_.store(rate_scale, std::memory_order_relaxed);
+    }
+    if (window != applied_window_) {
+        if (!camera_.set_window(window ? policy_.window : SensorWindow{}))
+            return false;
+        applied_window_ = window;
+    }
+    if (decimation == 1)
+        frame_counter_ = 0;
+    decimation_.store(decimation, std::memory_order_relaxed);
+    reduced_window_.store(window, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace camera_interface
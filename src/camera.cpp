@@ -0,0 +1,152 @@
+#include "camera_interface/camera.hpp"
+
+#include "camera_interface/clock.hpp"
+#include "camera_interface/frame_reactor.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#include <unistd.h>
+
+namespace camera_interface {
+
+Camera::Camera(const DeliveryConfig& delivery)
+    : frames_(delivery.queue_depth, delivery.overflow),
+      metrics_(delivery.metrics ? std::make_unique<CameraMetrics>() : nullptr),
+      metadata_(delivery.metadata_depth != 0 ? std::make_unique<MetadataLog>(delivery.metadata_depth) : nullptr),
+      backpressure_(delivery.backpressure
+                        ? std::make_unique<Backpressure>(*this, *delivery.backpressure, frames_.capacity())
+                        : nullptr),
+      stats_collector_(delivery.frame_stats ? std::make_unique<FrameStatsCollector>(*delivery.frame_stats) : nullptr),
+      latest_stats_(delivery.frame_stats ? std::make_unique<LatestFrameStats>() : nullptr)
+{
+    frames_.close();
+}
+
+Camera::~Camera()
+{
+    if (reactor_)
+        reactor_->detach(*this);
+}
+
+FrameHandle Camera::grab(std::chrono::nanoseconds timeout)
+{
+    return consumed(frames_.pop(timeout));
+}
+
+FrameHandle Camera::try_grab()
+{
+    return consumed(frames_.try_pop());
+}
+
+NextFrame Camera::next_frame()
+{
+    if (!reactor_)
+        throw std::logic_error("Camera::next_frame: camera is not attached to a FrameReactor");
+    return NextFrame(*this);
+}
+
+bool Camera::deliver(FrameHandle frame)
+{
+    FrameInfo& info = frame.info();
+    if (info.host_timestamp_ns == 0)
+        info.host_timestamp_ns = monotonic_now_ns();
+    if (backpressure_ && !backpressure_->admit(frames_.size(), info.host_timestamp_ns))
+        return false;
+    info.drops = source_drops();
+    // Partial frames are skipped; their statistics would describe a torn image.
+    if (stats_collector_ && info.bytes_used >= info.format.frame_size()
+        && stats_collector_->collect(ConstImageView{frame.data(), info.format}, stats_)) {
+        stats_.sequence = info.sequence;
+        info.luma = stats_.luma;
+        latest_stats_->publish(stats_);
+    }
+    if (metadata_)
+        metadata_->append(info);
+    if (metrics_) {
+        metrics_->sensor_to_dequeue.record(info.host_timestamp_ns - info.timestamp_ns);
+        metrics_->queue_depth.record(static_cast<std::int64_t>(frames_.size()));
+        metrics_->delivered.fetch_add(1, std::memory_order_relaxed);
+    }
+    const bool queued = frames_.push(std::move(frame));
+    signal_waiter();
+    return queued;
+}
+
+FrameHandle Camera::consumed(std::optional<FrameHandle> frame) noexcept
+{
+    if (!frame)
+        return {};
+    if (metrics_ || backpressure_) {
+        const std::int64_t latency = monotonic_now_ns() - frame->info().host_timestamp_ns;
+        if (metrics_) {
+            metrics_->dequeue_to_consumer.record(latency);
+            metrics_->consumed.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (backpressure_)
+            backpressure_->consumed(latency);
+    }
+    return std::move(*frame);
+}
+
+bool Camera::arm_waiter() noexcept
+{
+    // Dekker-style pairing with signal_waiter(): either the producer sees the flag, or we
+    // see its frame.
+    signal_armed_.store(true, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (frames_.empty() && !frames_.closed())
+        return false;
+    signal_armed_.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+void Camera::signal_waiter() noexcept
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!signal_armed_.load(std::memory_order_relaxed) || !signal_armed_.exchange(false))
+        return;
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const auto n = ::write(signal_fd_, &one, sizeof one);
+}
+
+CameraStats Camera::stats() const
+{
+    CameraStats stats;
+    if (metrics_) {
+        stats.sensor_to_dequeue = metrics_->sensor_to_dequeue.snapshot();
+        stats.dequeue_to_consumer = metrics_->dequeue_to_consumer.snapshot();
+        stats.queue_depth = metrics_->queue_depth.snapshot();
+        stats.frames_delivered = metrics_->delivered.load(std::memory_order_relaxed);
+        stats.frames_consumed = metrics_->consumed.load(std::memory_order_relaxed);
+    }
+    stats.queue_drops = frames_.dropped();
+    stats.source_drops = source_drops();
+    stats.queue_size = frames_.size();
+    return stats;
+}
+
+bool NextFrame::await_ready()
+{
+    frame_ = camera_->try_grab();
+    return frame_ || camera_->frames_.closed();
+}
+
+bool NextFrame::await_suspend(std::coroutine_handle<> waiter)
+{
+    if (camera_->waiter_)
+        throw std::logic_error("Camera::next_frame: another coroutine is already waiting");
+    if (camera_->arm_waiter())
+        return false;
+    camera_->waiter_ = waiter;
+    return true;
+}
+
+FrameHandle NextFrame::await_resume()
+{
+    if (!frame_)
+        frame_ = camera_->try_grab();
+    return std::move(frame_);
+}
+
+} // namespace camera_interface
@@ -0,0 +1,441 @@
+#include "camera_interface/convert.hpp"
+
+#include "convert_kernels.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace camera_interface {
+
+namespace detail {
+
+namespace {
+
+std::uint8_t clamp_u8(int value) noexcept
+{
+    return static_cast<std::uint8_t>(std::clamp(value, 0, 255));
+}
+
+/// BT.601 limited range in 6-bit fixed point. The luma term is (y - 16) * 255 / 219 * 64,
+/// computed as a 16x16 high multiply of y * 257 so the SIMD kernels can reproduce it exactly
+/// in saturating 16-bit lanes.
+void yuv_to_rgb(int y, int u, int v, std::uint8_t* out) noexcept
+{
+    const int c = ((y * 257 * 19003) >> 16) - 1192;
+    const int d = u - 128;
+    const int e = v - 128;
+    out[0] = clamp_u8((c + 102 * e + 32) >> 6);
+    out[1] = clamp_u8((c - 25 * d - 52 * e + 32) >> 6);
+    out[2] = clamp_u8((c + 129 * d + 32) >> 6);
+}
+
+} // namespace
+
+void bayer_span_scalar(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                       std::uint8_t* dst, std::uint32_t width, BayerSite even, BayerSite odd,
+                       std::uint32_t x_begin, std::uint32_t x_end) noexcept
+{
+    for (std::uint32_t x = x_begin; x < x_end; ++x) {
+        // Reflect-101 at the borders keeps the colour phase of the missing neighbour.
+        const std::uint32_t xl = x == 0 ? 1 : x - 1;
+        const std::uint32_t xr = x + 1 == width ? x - 1 : x + 1;
+        const int c = row[x];
+        const int l = row[xl];
+        const int r = row[xr];
+        const int u = above[x];
+        const int d = below[x];
+        const auto h = static_cast<std::uint8_t>((l + r + 1) >> 1);
+        const auto v = static_cast<std::uint8_t>((u + d + 1) >> 1);
+        const auto cross = static_cast<std::uint8_t>((l + r + u + d + 2) >> 2);
+        const auto diag = static_cast<std::uint8_t>((above[xl] + above[xr] + below[xl] + below[xr] + 2) >> 2);
+
+        std::uint8_t* out = dst + 3 * static_cast<std::size_t>(x);
+        switch ((x & 1) ? odd : even) {
+        case BayerSite::red:
+            out[0] = static_cast<std::uint8_t>(c), out[1] = cross, out[2] = diag;
+            break;
+        case BayerSite::green_red:
+            out[0] = h, out[1] = static_cast<std::uint8_t>(c), out[2] = v;
+            break;
+        case BayerSite::green_blue:
+            out[0] = v, out[1] = static_cast<std::uint8_t>(c), out[2] = h;
+            break;
+        case BayerSite::blue:
+            out[0] = diag, out[1] = cross, out[2] = static_cast<std::uint8_t>(c);
+            break;
+        }
+    }
+}
+
+void yuv422_span_scalar(const std::uint8_t* src, std::uint8_t* dst, std::uint32_t width, bool uyvy,
+                        std::uint32_t x_begin) noexcept
+{
+    for (std::uint32_t x = x_begin; x < width; x += 2) {
+        const std::uint8_t* m = src + 2 * static_cast<std::size_t>(x);
+        const int y0 = uyvy ? m[1] : m[0];
+        const int u = uyvy ? m[0] : m[1];
+        const int y1 = uyvy ? m[3] : m[2];
+        const int v = uyvy ? m[2] : m[3];
+        std::uint8_t* out = dst + 3 * static_cast<std::size_t>(x);
+        yuv_to_rgb(y0, u, v, out);
+        if (x + 1 < width)
+            yuv_to_rgb(y1, u, v, out + 3);
+    }
+}
+
+void yuv420_span_scalar(const std::uint8_t* y, const std::uint8_t* u, const std::uint8_t* v,
+                        std::size_t chroma_step, std::uint8_t* dst, std::uint32_t width,
+                        std::uint32_t x_begin) noexcept
+{
+    for (std::uint32_t x = x_begin; x < width; ++x) {
+        const std::size_t c = (x / 2) * chroma_step;
+        yuv_to_rgb(y[x], u[c], v[c], dst + 3 * static_cast<std::size_t>(x));
+    }
+}
+
+void mono16_span_scalar(const std::uint16_t* src, std::uint8_t* dst, std::uint32_t width, unsigned shift,
+                        std::uint32_t x_begin) noexcept
+{
+    for (std::uint32_t x = x_begin; x < width; ++x)
+        dst[x] = static_cast<std::uint8_t>(std::min<unsigned>(src[x] >> shift, 255u));
+}
+
+namespace {
+
+void bayer_row_scalar(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                      std::uint8_t* dst, std::uint32_t width, BayerSite even, BayerSite odd)
+{
+    bayer_span_scalar(above, row, below, dst, width, even, odd, 0, width);
+}
+
+void yuv422_row_scalar(const std::uint8_t* src, std::uint8_t* dst, std::uint32_t width, bool uyvy)
+{
+    yuv422_span_scalar(src, dst, width, uyvy, 0);
+}
+
+void yuv420_row_scalar(const std::uint8_t* y, const std::uint8_t* u, const std::uint8_t* v,
+                       std::size_t chroma_step, std::uint8_t* dst, std::uint32_t width)
+{
+    yuv420_span_scalar(y, u, v, chroma_step, dst, width, 0);
+}
+
+void mono16_row_scalar(const std::uint16_t* src, std::uint8_t* dst, std::uint32_t width, unsigned shift)
+{
+    mono16_span_scalar(src, dst, width, shift, 0);
+}
+
+} // namespace
+
+const ConvertKernels scalar_kernels = {
+    bayer_row_scalar,
+    yuv422_row_scalar,
+    yuv420_row_scalar,
+    mono16_row_scalar,
+};
+
+std::pair<BayerSite, BayerSite> bayer_sites(PixelFormat format, std::uint32_t y) noexcept
+{
+    const bool odd_row = (y & 1) != 0;
+    switch (format) {
+    case PixelFormat::bayer_bggr8:
+        return odd_row ? std::pair{BayerSite::green_red, BayerSite::red}
+                       : std::pair{BayerSite::blue, BayerSite::green_blue};
+    case PixelFormat::bayer_grbg8:
+        return odd_row ? std::pair{BayerSite::blue, BayerSite::green_blue}
+                       : std::pair{BayerSite::green_red, BayerSite::red};
+    case PixelFormat::bayer_gbrg8:
+        return odd_row ? std::pair{BayerSite::red, BayerSite::green_red}
+                       : std::pair{BayerSite::green_blue, BayerSite::blue};
+    default:
+        return odd_row ? std::pair{BayerSite::green_blue, BayerSite::blue}
+                       : std::pair{BayerSite::red, BayerSite::green_red};
+    }
+}
+
+} // namespace detail
+
+namespace {
+
+using detail::BayerSite;
+
+const detail::ConvertKernels* kernels_for(SimdLevel level) noexcept
+{
+    switch (level) {
+#if defined(CAMERA_INTERFACE_X86_SIMD)
+    case SimdLevel::avx2: return &detail::avx2_kernels;
+    case SimdLevel::sse42: return &detail::sse42_kernels;
+#endif
+    default: return &detail::scalar_kernels;
+    }
+}
+
+std::atomic<SimdLevel>& active_level() noexcept
+{
+    static std::atomic<SimdLevel> level{detected_simd_level()};
+    return level;
+}
+
+bool is_planar(PixelFormat format) noexcept
+{
+    return format == PixelFormat::nv12 || format == PixelFormat::i420;
+}
+
+/// Chroma-subsampled formats can only be cut on even columns.
+bool needs_even_x(PixelFormat format) noexcept
+{
+    return format == PixelFormat::yuyv || format == PixelFormat::uyvy || is_planar(format);
+}
+
+void validate(const ConstImageView& src, const Rect& roi, const ImageView& dst)
+{
+    const StreamFormat& sf = src.format;
+    if (!can_convert(sf.format, dst.format.format))
+        throw std::invalid_argument(std::string("convert: unsupported conversion ") + to_string(sf.format)
+                                    + " -> " + to_string(dst.format.format));
+    if (roi.width > sf.width || roi.x > sf.width - roi.width || roi.height > sf.height
+        || roi.y > sf.height - roi.height)
+        throw std::invalid_argument("convert: region outside the source image");
+    if (needs_even_x(sf.format) && (roi.x & 1) != 0)
+        throw std::invalid_argument("convert: region must start on an even column for this format");
+    if (roi.width != dst.format.width || roi.height != dst.format.height)
+        throw std::invalid_argument("convert: destination size differs from the converted region");
+    if (sf.stride < min_stride(sf.format, sf.width)
+        || dst.format.stride < min_stride(dst.format.format, dst.format.width))
+        throw std::invalid_argument("convert: stride too small");
+    if (is_bayer(sf.format) && (roi.width < 2 || roi.height < 2))
+        throw std::invalid_argument("convert: Bayer images must be at least 2x2");
+}
+
+/// One output row of a `factor` x `factor` box filter with rounding. The 2x2 case, by far the
+/// most common, gets its own loop with compile-time bounds.
+template <std::size_t Channels>
+void box_row(const std::uint8_t* top, std::size_t stride, std::uint8_t* out, std::uint32_t out_width,
+             std::uint32_t factor) noexcept
+{
+    if (factor == 2) {
+        const std::uint8_t* bottom = top + stride;
+        for (std::uint32_t x = 0; x < out_width; ++x) {
+            const std::size_t i = std::size_t{x} * 2 * Channels;
+            for (std::size_t c = 0; c < Channels; ++c)
+                out[x * Channels + c] = static_cast<std::uint8_t>(
+                    (top[i + c] + top[i + Channels + c] + bottom[i + c] + bottom[i + Channels + c] + 2) >> 2);
+        }
+        return;
+    }
+    const std::uint32_t area = factor * factor;
+    for (std::uint32_t x = 0; x < out_width; ++x) {
+        const std::size_t first = std::size_t{x} * factor * Channels;
+        for (std::size_t c = 0; c < Channels; ++c) {
+            std::uint32_t total = 0;
+            for (std::uint32_t dy = 0; dy < factor; ++dy) {
+                const std::uint8_t* row = top + dy * stride + first + c;
+                for (std::uint32_t dx = 0; dx < factor; ++dx)
+                    total += row[dx * Channels];
+            }
+            out[x * Channels + c] = static_cast<std::uint8_t>((total + area / 2) / area);
+        }
+    }
+}
+
+} // namespace
+
+const char* to_string(SimdLevel level) noexcept
+{
+    switch (level) {
+    case SimdLevel::scalar: return "scalar";
+    case SimdLevel::sse42: return "sse4.2";
+    case SimdLevel::avx2: return "avx2";
+    }
+    return "unknown";
+}
+
+SimdLevel detected_simd_level() noexcept
+{
+#if defined(CAMERA_INTERFACE_X86_SIMD)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return SimdLevel::avx2;
+    if (__builtin_cpu_supports("sse4.2"))
+        return SimdLevel::sse42;
+#endif
+    return SimdLevel::scalar;
+}
+
+SimdLevel active_simd_level() noexcept
+{
+    return active_level().load(std::memory_order_relaxed);
+}
+
+void set_simd_level(SimdLevel level) noexcept
+{
+    active_level().store(std::min(level, detected_simd_level()), std::memory_order_relaxed);
+}
+
+const detail::ConvertKernels& detail::active_kernels() noexcept
+{
+    return *kernels_for(active_simd_level());
+}
+
+bool can_convert(PixelFormat from, PixelFormat to) noexcept
+{
+    if (from == to)
+        return !is_planar(from);
+    switch (from) {
+    case PixelFormat::bayer_rggb8:
+    case PixelFormat::bayer_bggr8:
+    case PixelFormat::bayer_grbg8:
+    case PixelFormat::bayer_gbrg8:
+    case PixelFormat::yuyv:
+    case PixelFormat::uyvy:
+    case PixelFormat::nv12:
+    case PixelFormat::i420:
+        return to == PixelFormat::rgb8;
+    case PixelFormat::mono16:
+        return to == PixelFormat::mono8;
+    default:
+        return false;
+    }
+}
+
+void convert(const ConstImageView& src, const ImageView& dst, const ConvertOptions& options)
+{
+    convert_rows(src, dst, 0, src.format.height, options);
+}
+
+void convert_rows(const ConstImageView& src, const ImageView& dst, std::uint32_t row_begin,
+                  std::uint32_t row_end, const ConvertOptions& options)
+{
+    convert_rows(src, Rect{0, 0, src.format.width, src.format.height}, dst, row_begin, row_end, options);
+}
+
+void convert_rows(const ConstImageView& src, const Rect& roi, const ImageView& dst, std::uint32_t row_begin,
+                  std::uint32_t row_end, const ConvertOptions& options)
+{
+    validate(src, roi, dst);
+    row_end = std::min(row_end, roi.height);
+    if (row_begin < row_end) {
+        std::byte* first = dst.data + std::size_t{row_begin} * dst.format.stride;
+        detail::convert_region_rows(src, roi, dst.format.format, first, dst.format.stride, row_begin, row_end,
+                                    options);
+    }
+}
+
+void detail::convert_region_rows(const ConstImageView& src, const Rect& roi, PixelFormat to, std::byte* strip,
+                                 std::size_t strip_stride, std::uint32_t row_begin, std::uint32_t row_end,
+                                 const ConvertOptions& options) noexcept
+{
+    const detail::ConvertKernels& k = detail::active_kernels();
+    const StreamFormat& sf = src.format;
+    const std::uint32_t width = roi.width;
+    const std::uint32_t height = sf.height;
+
+    const auto* s = reinterpret_cast<const std::uint8_t*>(src.data);
+    const std::size_t ss = sf.stride;
+    // Region row r lands on strip row r - row_begin.
+    const auto out = [&](std::uint32_t r) {
+        return reinterpret_cast<std::uint8_t*>(strip) + (r - row_begin) * strip_stride;
+    };
+    const std::size_t x0 = roi.x;
+
+    if (sf.format == to) {
+        const std::size_t offset = sf.format == PixelFormat::yuyv || sf.format == PixelFormat::uyvy
+                                       ? x0 * 2
+                                       : x0 * bytes_per_pixel(sf.format);
+        const std::size_t bytes = min_stride(sf.format, width);
+        for (std::uint32_t r = row_begin; r < row_end; ++r)
+            std::memcpy(out(r), s + (roi.y + r) * ss + offset, bytes);
+        return;
+    }
+
+    switch (sf.format) {
+    case PixelFormat::bayer_rggb8:
+    case PixelFormat::bayer_bggr8:
+    case PixelFormat::bayer_grbg8:
+    case PixelFormat::bayer_gbrg8:
+        for (std::uint32_t r = row_begin; r < row_end; ++r) {
+            // Reflect at the region's top and bottom rows, as the kernels do at its sides.
+            const std::uint32_t y = roi.y + r;
+            const std::uint32_t above = r == 0 ? y + 1 : y - 1;
+            const std::uint32_t below = r + 1 == roi.height ? y - 1 : y + 1;
+            auto [even, odd] = detail::bayer_sites(sf.format, y);
+            if ((x0 & 1) != 0)
+                std::swap(even, odd);
+            k.bayer_row(s + above * ss + x0, s + y * ss + x0, s + below * ss + x0, out(r), width, even, odd);
+        }
+        break;
+    case PixelFormat::yuyv:
+    case PixelFormat::uyvy:
+        for (std::uint32_t r = row_begin; r < row_end; ++r)
+            k.yuv422_row(s + (roi.y + r) * ss + x0 * 2, out(r), width, sf.format == PixelFormat::uyvy);
+        break;
+    case PixelFormat::nv12: {
+        const std::uint8_t* uv = s + ss * height + x0;
+        for (std::uint32_t r = row_begin; r < row_end; ++r) {
+            const std::uint32_t y = roi.y + r;
+            const std::uint8_t* chroma = uv + (y / 2) * ss;
+            k.yuv420_row(s + y * ss + x0, chroma, chroma + 1, 2, out(r), width);
+        }
+        break;
+    }
+    case PixelFormat::i420: {
+        const std::size_t cs = (ss + 1) / 2;
+        const std::uint8_t* u = s + ss * height;
+        const std::uint8_t* v = u + cs * ((height + 1) / 2);
+        for (std::uint32_t r = row_begin; r < row_end; ++r) {
+            const std::uint32_t y = roi.y + r;
+            const std::size_t chroma = (y / 2) * cs + x0 / 2;
+            k.yuv420_row(s + y * ss + x0, u + chroma, v + chroma, 1, out(r), width);
+        }
+        break;
+    }
+    case PixelFormat::mono16: {
+        const unsigned shift = std::min(options.mono16_shift, 16u);
+        for (std::uint32_t r = row_begin; r < row_end; ++r)
+            k.mono16_row(reinterpret_cast<const std::uint16_t*>(s + (roi.y + r) * ss + x0 * 2), out(r), width,
+                         shift);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+bool can_downscale(PixelFormat format) noexcept
+{
+    return format == PixelFormat::mono8 || format == PixelFormat::rgb8 || format == PixelFormat::bgr8;
+}
+
+StreamFormat downscaled_format(const StreamFormat& format, std::uint32_t factor) noexcept
+{
+    factor = std::max(factor, 1u);
+    return StreamFormat::packed(format.width / factor, format.height / factor, format.format);
+}
+
+void downscale_rows(const ConstImageView& src, const ImageView& dst, std::uint32_t factor, std::uint32_t row_begin,
+                    std::uint32_t row_end)
+{
+    const StreamFormat& sf = src.format;
+    if (!can_downscale(sf.format) || dst.format.format != sf.format)
+        throw std::invalid_argument(std::string("downscale: unsupported format ") + to_string(sf.format));
+    if (factor == 0 || dst.format.width != sf.width / factor || dst.format.height != sf.height / factor)
+        throw std::invalid_argument("downscale: destination size does not match the factor");
+    if (sf.stride < min_stride(sf.format, sf.width) || dst.format.stride < min_stride(sf.format, dst.format.width))
+        throw std::invalid_argument("downscale: stride too small");
+
+    row_end = std::min(row_end, dst.format.height);
+    const std::size_t channels = bytes_per_pixel(sf.format);
+    for (std::uint32_t r = row_begin; r < row_end; ++r) {
+        const auto* top = reinterpret_cast<const std::uint8_t*>(src.data) + std::size_t{r} * factor * sf.stride;
+        auto* out = reinterpret_cast<std::uint8_t*>(dst.data) + r * dst.format.stride;
+        if (channels == 3)
+            box_row<3>(top, sf.stride, out, dst.format.width, factor);
+        else
+            box_row<1>(top, sf.stride, out, dst.format.width, factor);
+    }
+}
+
+} // namespace camera_interface
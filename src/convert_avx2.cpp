@@ -0,0 +1,195 @@
+// Compiled with -mavx2; only reached when the CPU and OS report AVX2.
+
+#include "convert_x86.hpp"
+
+namespace camera_interface::detail {
+
+namespace {
+
+template <int Source>
+__m256i select(__m256i c, __m256i h, __m256i v, __m256i cross, __m256i diag)
+{
+    if constexpr (Source == 0)
+        return c;
+    else if constexpr (Source == 1)
+        return h;
+    else if constexpr (Source == 2)
+        return v;
+    else if constexpr (Source == 3)
+        return cross;
+    else
+        return diag;
+}
+
+__m256i load(const std::uint8_t* p)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+/// (a + b + c + d + 2) >> 2 per byte, exact. Unpack and pack both work within 128-bit
+/// lanes, so byte order is preserved.
+__m256i average4(__m256i a, __m256i b, __m256i c, __m256i d)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i two = _mm256_set1_epi16(2);
+    const __m256i lo = _mm256_add_epi16(
+        _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero)),
+        _mm256_add_epi16(_mm256_unpacklo_epi8(c, zero), _mm256_unpacklo_epi8(d, zero)));
+    const __m256i hi = _mm256_add_epi16(
+        _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero)),
+        _mm256_add_epi16(_mm256_unpackhi_epi8(c, zero), _mm256_unpackhi_epi8(d, zero)));
+    return _mm256_packus_epi16(_mm256_srli_epi16(_mm256_add_epi16(lo, two), 2),
+                               _mm256_srli_epi16(_mm256_add_epi16(hi, two), 2));
+}
+
+/// Writes 32 pixels (96 bytes) of packed RGB.
+void store_rgb32(std::uint8_t* dst, __m256i r, __m256i g, __m256i b)
+{
+    store_rgb16(dst, _mm256_castsi256_si128(r), _mm256_castsi256_si128(g), _mm256_castsi256_si128(b));
+    store_rgb16(dst + 48, _mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1),
+                _mm256_extracti128_si256(b, 1));
+}
+
+template <BayerSite Even, BayerSite Odd>
+void bayer_row_impl(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                    std::uint8_t* dst, std::uint32_t width)
+{
+    bayer_span_scalar(above, row, below, dst, width, Even, Odd, 0, 2);
+    const __m256i odd_lanes = _mm256_set1_epi16(static_cast<short>(0xff00));
+    std::uint32_t x = 2;
+    for (; x + 33 <= width; x += 32) {
+        const __m256i l = load(row + x - 1);
+        const __m256i r = load(row + x + 1);
+        const __m256i u = load(above + x);
+        const __m256i d = load(below + x);
+        const __m256i c = load(row + x);
+        const __m256i h = _mm256_avg_epu8(l, r);
+        const __m256i v = _mm256_avg_epu8(u, d);
+        const __m256i cross = average4(l, r, u, d);
+        const __m256i diag = average4(load(above + x - 1), load(above + x + 1), load(below + x - 1),
+                                      load(below + x + 1));
+
+        const __m256i red = _mm256_blendv_epi8(select<bayer_source(Even, 0)>(c, h, v, cross, diag),
+                                               select<bayer_source(Odd, 0)>(c, h, v, cross, diag), odd_lanes);
+        const __m256i green = _mm256_blendv_epi8(select<bayer_source(Even, 1)>(c, h, v, cross, diag),
+                                                 select<bayer_source(Odd, 1)>(c, h, v, cross, diag), odd_lanes);
+        const __m256i blue = _mm256_blendv_epi8(select<bayer_source(Even, 2)>(c, h, v, cross, diag),
+                                                select<bayer_source(Odd, 2)>(c, h, v, cross, diag), odd_lanes);
+        store_rgb32(dst + 3 * static_cast<std::size_t>(x), red, green, blue);
+    }
+    bayer_span_scalar(above, row, below, dst, width, Even, Odd, x, width);
+}
+
+void bayer_row(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+               std::uint8_t* dst, std::uint32_t width, BayerSite even, BayerSite odd)
+{
+    using S = BayerSite;
+    if (even == S::red && odd == S::green_red)
+        bayer_row_impl<S::red, S::green_red>(above, row, below, dst, width);
+    else if (even == S::green_red && odd == S::red)
+        bayer_row_impl<S::green_red, S::red>(above, row, below, dst, width);
+    else if (even == S::green_blue && odd == S::blue)
+        bayer_row_impl<S::green_blue, S::blue>(above, row, below, dst, width);
+    else if (even == S::blue && odd == S::green_blue)
+        bayer_row_impl<S::blue, S::green_blue>(above, row, below, dst, width);
+    else
+        bayer_span_scalar(above, row, below, dst, width, even, odd, 0, width);
+}
+
+/// Converts 16 pixels held in 16-bit lanes (luma as y * 257); same arithmetic as the SSE and
+/// scalar paths.
+void yuv16_lanes_to_rgb(__m256i y, __m256i u, __m256i v, __m256i& r, __m256i& g, __m256i& b)
+{
+    const __m256i c =
+        _mm256_sub_epi16(_mm256_mulhi_epu16(y, _mm256_set1_epi16(19003)), _mm256_set1_epi16(1192));
+    const __m256i d = _mm256_sub_epi16(u, _mm256_set1_epi16(128));
+    const __m256i e = _mm256_sub_epi16(v, _mm256_set1_epi16(128));
+    const __m256i round = _mm256_set1_epi16(32);
+    r = _mm256_srai_epi16(
+        _mm256_adds_epi16(_mm256_adds_epi16(c, _mm256_mullo_epi16(e, _mm256_set1_epi16(102))), round), 6);
+    g = _mm256_srai_epi16(
+        _mm256_adds_epi16(_mm256_subs_epi16(_mm256_subs_epi16(c, _mm256_mullo_epi16(d, _mm256_set1_epi16(25))),
+                                            _mm256_mullo_epi16(e, _mm256_set1_epi16(52))),
+                          round),
+        6);
+    b = _mm256_srai_epi16(
+        _mm256_adds_epi16(_mm256_adds_epi16(c, _mm256_mullo_epi16(d, _mm256_set1_epi16(129))), round), 6);
+}
+
+/// Packs two sets of 16 words into 32 bytes in pixel order.
+__m256i pack_ordered(__m256i lo, __m256i hi)
+{
+    return _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xd8);
+}
+
+/// Widens 16 luma bytes to y * 257 in 16-bit lanes.
+__m256i widen_luma(__m128i y)
+{
+    const __m256i wide = _mm256_cvtepu8_epi16(y);
+    return _mm256_or_si256(wide, _mm256_slli_epi16(wide, 8));
+}
+
+/// 32 Y samples plus 16 U / 16 V samples to 96 bytes of RGB.
+void yuv32_to_rgb(__m128i y_lo, __m128i y_hi, __m128i u, __m128i v, std::uint8_t* dst)
+{
+    __m256i r0, g0, b0, r1, g1, b1;
+    yuv16_lanes_to_rgb(widen_luma(y_lo), _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(u, u)),
+                       _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(v, v)), r0, g0, b0);
+    yuv16_lanes_to_rgb(widen_luma(y_hi), _mm256_cvtepu8_epi16(_mm_unpackhi_epi8(u, u)),
+                       _mm256_cvtepu8_epi16(_mm_unpackhi_epi8(v, v)), r1, g1, b1);
+    store_rgb32(dst, pack_ordered(r0, r1), pack_ordered(g0, g1), pack_ordered(b0, b1));
+}
+
+void yuv422_row(const std::uint8_t* src, std::uint8_t* dst, std::uint32_t width, bool uyvy)
+{
+    std::uint32_t x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m128i y0, u0, v0, y1, u1, v1;
+        deinterleave_yuv422(src + 2 * static_cast<std::size_t>(x), uyvy, y0, u0, v0);
+        deinterleave_yuv422(src + 2 * static_cast<std::size_t>(x) + 32, uyvy, y1, u1, v1);
+        yuv32_to_rgb(y0, y1, _mm_unpacklo_epi64(u0, u1), _mm_unpacklo_epi64(v0, v1),
+                     dst + 3 * static_cast<std::size_t>(x));
+    }
+    yuv422_span_scalar(src, dst, width, uyvy, x);
+}
+
+void yuv420_row(const std::uint8_t* y, const std::uint8_t* u, const std::uint8_t* v, std::size_t chroma_step,
+                std::uint8_t* dst, std::uint32_t width)
+{
+    std::uint32_t x = 0;
+    for (; x + 32 <= width; x += 32) {
+        __m128i u0, v0, u1, v1;
+        load_chroma420(u, v, chroma_step, x, u0, v0);
+        load_chroma420(u, v, chroma_step, x + 16, u1, v1);
+        yuv32_to_rgb(_mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x)),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x + 16)), _mm_unpacklo_epi64(u0, u1),
+                     _mm_unpacklo_epi64(v0, v1), dst + 3 * static_cast<std::size_t>(x));
+    }
+    yuv420_span_scalar(y, u, v, chroma_step, dst, width, x);
+}
+
+void mono16_row(const std::uint16_t* src, std::uint8_t* dst, std::uint32_t width, unsigned shift)
+{
+    const __m128i count = _mm_cvtsi32_si128(static_cast<int>(shift));
+    const __m256i max = _mm256_set1_epi16(255);
+    std::uint32_t x = 0;
+    for (; x + 32 <= width; x += 32) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + x + 16));
+        const __m256i lo = _mm256_min_epu16(_mm256_srl_epi16(a, count), max);
+        const __m256i hi = _mm256_min_epu16(_mm256_srl_epi16(b, count), max);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), pack_ordered(lo, hi));
+    }
+    mono16_span_scalar(src, dst, width, shift, x);
+}
+
+} // namespace
+
+const ConvertKernels avx2_kernels = {
+    bayer_row,
+    yuv422_row,
+    yuv420_row,
+    mono16_row,
+};
+
+} // namespace camera_interface::detail
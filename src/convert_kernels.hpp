@@ -0,0 +1,61 @@
+#pragma once
+
+// Row kernels behind convert(). Each instruction set provides one table; the scalar span
+// functions double as the reference implementation and as the edge/tail handlers of the
+// SIMD versions, which must produce bit-identical output.
+//
+// The SIMD translation units are compiled with -msse4.2 / -mavx2. Nothing with external
+// linkage that they instantiate may be shared with the baseline code, or the linker could
+// pick the AVX2 copy for a scalar caller; keep inline helpers out of this header.
+
+#include "camera_interface/pixel_format.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace camera_interface::detail {
+
+/// Colour site of a Bayer pixel: green sites are told apart by the colour of their row.
+enum class BayerSite : std::uint8_t { red, green_red, green_blue, blue };
+
+using BayerRowFn = void (*)(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                            std::uint8_t* dst, std::uint32_t width, BayerSite even, BayerSite odd);
+using Yuv422RowFn = void (*)(const std::uint8_t* src, std::uint8_t* dst, std::uint32_t width, bool uyvy);
+using Yuv420RowFn = void (*)(const std::uint8_t* y, const std::uint8_t* u, const std::uint8_t* v,
+                             std::size_t chroma_step, std::uint8_t* dst, std::uint32_t width);
+using Mono16RowFn = void (*)(const std::uint16_t* src, std::uint8_t* dst, std::uint32_t width, unsigned shift);
+
+struct ConvertKernels {
+    BayerRowFn bayer_row;
+    Yuv422RowFn yuv422_row;
+    Yuv420RowFn yuv420_row;
+    Mono16RowFn mono16_row;
+};
+
+extern const ConvertKernels scalar_kernels;
+#if defined(CAMERA_INTERFACE_X86_SIMD)
+extern const ConvertKernels sse42_kernels;
+extern const ConvertKernels avx2_kernels;
+#endif
+
+/// Table for `active_simd_level()`.
+const ConvertKernels& active_kernels() noexcept;
+
+/// Sites of the even and odd columns of row `y` of a Bayer image.
+std::pair<BayerSite, BayerSite> bayer_sites(PixelFormat format, std::uint32_t y) noexcept;
+
+void bayer_span_scalar(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                       std::uint8_t* dst, std::uint32_t width, BayerSite even, BayerSite odd,
+                       std::uint32_t x_begin, std::uint32_t x_end) noexcept;
+/// `x_begin` must be even.
+void yuv422_span_scalar(const std::uint8_t* src, std::uint8_t* dst, std::uint32_t width, bool uyvy,
+                        std::uint32_t x_begin) noexcept;
+/// `x_begin` must be even.
+void yuv420_span_scalar(const std::uint8_t* y, const std::uint8_t* u, const std::uint8_t* v,
+                        std::size_t chroma_step, std::uint8_t* dst, std::uint32_t width,
+                        std::uint32_t x_begin) noexcept;
+void mono16_span_scalar(const std::uint16_t* src, std::uint8_t* dst, std::uint32_t width, unsigned shift,
+                        std::uint32_t x_begin) noexcept;
+
+} // namespace camera_interface::detail
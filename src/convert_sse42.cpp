@@ -0,0 +1,161 @@
+// Compiled with -msse4.2; only reached when the CPU reports SSE4.2.
+
+#include "convert_x86.hpp"
+
+namespace camera_interface::detail {
+
+namespace {
+
+template <int Source>
+__m128i select(__m128i c, __m128i h, __m128i v, __m128i cross, __m128i diag)
+{
+    if constexpr (Source == 0)
+        return c;
+    else if constexpr (Source == 1)
+        return h;
+    else if constexpr (Source == 2)
+        return v;
+    else if constexpr (Source == 3)
+        return cross;
+    else
+        return diag;
+}
+
+/// (a + b + c + d + 2) >> 2 per byte, exact.
+__m128i average4(__m128i a, __m128i b, __m128i c, __m128i d)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i two = _mm_set1_epi16(2);
+    const __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)),
+                                     _mm_add_epi16(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(d, zero)));
+    const __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)),
+                                     _mm_add_epi16(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(d, zero)));
+    return _mm_packus_epi16(_mm_srli_epi16(_mm_add_epi16(lo, two), 2), _mm_srli_epi16(_mm_add_epi16(hi, two), 2));
+}
+
+__m128i load(const std::uint8_t* p)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+template <BayerSite Even, BayerSite Odd>
+void bayer_row_impl(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                    std::uint8_t* dst, std::uint32_t width)
+{
+    bayer_span_scalar(above, row, below, dst, width, Even, Odd, 0, 2);
+    const __m128i odd_lanes = _mm_set1_epi16(static_cast<short>(0xff00));
+    std::uint32_t x = 2;
+    for (; x + 17 <= width; x += 16) {
+        const __m128i l = load(row + x - 1);
+        const __m128i r = load(row + x + 1);
+        const __m128i u = load(above + x);
+        const __m128i d = load(below + x);
+        const __m128i c = load(row + x);
+        const __m128i h = _mm_avg_epu8(l, r);
+        const __m128i v = _mm_avg_epu8(u, d);
+        const __m128i cross = average4(l, r, u, d);
+        const __m128i diag = average4(load(above + x - 1), load(above + x + 1), load(below + x - 1),
+                                      load(below + x + 1));
+
+        const __m128i red = _mm_blendv_epi8(select<bayer_source(Even, 0)>(c, h, v, cross, diag),
+                                            select<bayer_source(Odd, 0)>(c, h, v, cross, diag), odd_lanes);
+        const __m128i green = _mm_blendv_epi8(select<bayer_source(Even, 1)>(c, h, v, cross, diag),
+                                              select<bayer_source(Odd, 1)>(c, h, v, cross, diag), odd_lanes);
+        const __m128i blue = _mm_blendv_epi8(select<bayer_source(Even, 2)>(c, h, v, cross, diag),
+                                             select<bayer_source(Odd, 2)>(c, h, v, cross, diag), odd_lanes);
+        store_rgb16(dst + 3 * static_cast<std::size_t>(x), red, green, blue);
+    }
+    bayer_span_scalar(above, row, below, dst, width, Even, Odd, x, width);
+}
+
+void bayer_row(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+               std::uint8_t* dst, std::uint32_t width, BayerSite even, BayerSite odd)
+{
+    using S = BayerSite;
+    if (even == S::red && odd == S::green_red)
+        bayer_row_impl<S::red, S::green_red>(above, row, below, dst, width);
+    else if (even == S::green_red && odd == S::red)
+        bayer_row_impl<S::green_red, S::red>(above, row, below, dst, width);
+    else if (even == S::green_blue && odd == S::blue)
+        bayer_row_impl<S::green_blue, S::blue>(above, row, below, dst, width);
+    else if (even == S::blue && odd == S::green_blue)
+        bayer_row_impl<S::blue, S::green_blue>(above, row, below, dst, width);
+    else
+        bayer_span_scalar(above, row, below, dst, width, even, odd, 0, width);
+}
+
+/// Converts 8 pixels held in 16-bit lanes (luma as y * 257); returns R, G, B still in 16-bit lanes.
+void yuv8_to_rgb(__m128i y, __m128i u, __m128i v, __m128i& r, __m128i& g, __m128i& b)
+{
+    const __m128i c = _mm_sub_epi16(_mm_mulhi_epu16(y, _mm_set1_epi16(19003)), _mm_set1_epi16(1192));
+    const __m128i d = _mm_sub_epi16(u, _mm_set1_epi16(128));
+    const __m128i e = _mm_sub_epi16(v, _mm_set1_epi16(128));
+    const __m128i round = _mm_set1_epi16(32);
+    r = _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(c, _mm_mullo_epi16(e, _mm_set1_epi16(102))), round), 6);
+    g = _mm_srai_epi16(_mm_adds_epi16(_mm_subs_epi16(_mm_subs_epi16(c, _mm_mullo_epi16(d, _mm_set1_epi16(25))),
+                                                     _mm_mullo_epi16(e, _mm_set1_epi16(52))),
+                                      round),
+                       6);
+    b = _mm_srai_epi16(_mm_adds_epi16(_mm_adds_epi16(c, _mm_mullo_epi16(d, _mm_set1_epi16(129))), round), 6);
+}
+
+/// 16 Y samples plus 8 U / 8 V samples (low halves) to 48 bytes of RGB.
+void yuv16_to_rgb(__m128i y, __m128i u, __m128i v, std::uint8_t* dst)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i u2 = _mm_unpacklo_epi8(u, u);
+    const __m128i v2 = _mm_unpacklo_epi8(v, v);
+    __m128i r0, g0, b0, r1, g1, b1;
+    yuv8_to_rgb(_mm_unpacklo_epi8(y, y), _mm_unpacklo_epi8(u2, zero), _mm_unpacklo_epi8(v2, zero), r0, g0, b0);
+    yuv8_to_rgb(_mm_unpackhi_epi8(y, y), _mm_unpackhi_epi8(u2, zero), _mm_unpackhi_epi8(v2, zero), r1, g1, b1);
+    store_rgb16(dst, _mm_packus_epi16(r0, r1), _mm_packus_epi16(g0, g1), _mm_packus_epi16(b0, b1));
+}
+
+void yuv422_row(const std::uint8_t* src, std::uint8_t* dst, std::uint32_t width, bool uyvy)
+{
+    std::uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i y, u, v;
+        deinterleave_yuv422(src + 2 * static_cast<std::size_t>(x), uyvy, y, u, v);
+        yuv16_to_rgb(y, u, v, dst + 3 * static_cast<std::size_t>(x));
+    }
+    yuv422_span_scalar(src, dst, width, uyvy, x);
+}
+
+void yuv420_row(const std::uint8_t* y, const std::uint8_t* u, const std::uint8_t* v, std::size_t chroma_step,
+                std::uint8_t* dst, std::uint32_t width)
+{
+    std::uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        __m128i cu, cv;
+        load_chroma420(u, v, chroma_step, x, cu, cv);
+        yuv16_to_rgb(load(y + x), cu, cv, dst + 3 * static_cast<std::size_t>(x));
+    }
+    yuv420_span_scalar(y, u, v, chroma_step, dst, width, x);
+}
+
+void mono16_row(const std::uint16_t* src, std::uint8_t* dst, std::uint32_t width, unsigned shift)
+{
+    const __m128i count = _mm_cvtsi32_si128(static_cast<int>(shift));
+    const __m128i max = _mm_set1_epi16(255);
+    std::uint32_t x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x + 8));
+        const __m128i lo = _mm_min_epu16(_mm_srl_epi16(a, count), max);
+        const __m128i hi = _mm_min_epu16(_mm_srl_epi16(b, count), max);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(lo, hi));
+    }
+    mono16_span_scalar(src, dst, width, shift, x);
+}
+
+} // namespace
+
+const ConvertKernels sse42_kernels = {
+    bayer_row,
+    yuv422_row,
+    yuv420_row,
+    mono16_row,
+};
+
+} // namespace camera_interface::detail
@@ -0,0 +1,109 @@
+#pragma once
+
+// SSE building blocks shared by the SSE4.2 and AVX2 kernel translation units. Everything
+// here has internal linkage on purpose: each TU gets a copy encoded for its own target.
+
+#include "convert_kernels.hpp"
+
+#include <immintrin.h>
+
+#include <array>
+#include <cstdint>
+
+namespace camera_interface::detail {
+namespace {
+
+/// pshufb masks that scatter 16 R, G and B bytes into three 16-byte chunks of packed RGB.
+struct InterleaveMasks {
+    std::uint8_t bytes[3][3][16]; // [chunk][channel][byte]
+};
+
+constexpr InterleaveMasks make_interleave_masks()
+{
+    InterleaveMasks masks{};
+    for (int chunk = 0; chunk < 3; ++chunk)
+        for (int channel = 0; channel < 3; ++channel)
+            for (int k = 0; k < 16; ++k) {
+                const int out = chunk * 16 + k;
+                masks.bytes[chunk][channel][k] =
+                    out % 3 == channel ? static_cast<std::uint8_t>(out / 3) : std::uint8_t{0x80};
+            }
+    return masks;
+}
+
+alignas(16) constexpr InterleaveMasks kInterleave = make_interleave_masks();
+
+inline __m128i mask_at(int chunk, int channel)
+{
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(kInterleave.bytes[chunk][channel]));
+}
+
+/// Writes 16 pixels (48 bytes) of packed RGB.
+inline void store_rgb16(std::uint8_t* dst, __m128i r, __m128i g, __m128i b)
+{
+    for (int chunk = 0; chunk < 3; ++chunk) {
+        const __m128i out = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(r, mask_at(chunk, 0)),
+                                                      _mm_shuffle_epi8(g, mask_at(chunk, 1))),
+                                         _mm_shuffle_epi8(b, mask_at(chunk, 2)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16 * chunk), out);
+    }
+}
+
+inline __m128i shuffle_mask(std::array<std::int8_t, 16> m)
+{
+    return _mm_setr_epi8(m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9], m[10], m[11],
+                         m[12], m[13], m[14], m[15]);
+}
+
+/// Splits 32 bytes of YUYV (or UYVY) into 16 Y bytes and 8 U / 8 V bytes (low halves).
+inline void deinterleave_yuv422(const std::uint8_t* src, bool uyvy, __m128i& y, __m128i& u, __m128i& v)
+{
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+    const std::int8_t o = uyvy ? 1 : 0; // offset of Y within each byte pair
+    const std::int8_t cu = uyvy ? 0 : 1;
+    const std::int8_t cv = uyvy ? 2 : 3;
+    const std::int8_t z = -128;
+    const __m128i ys = shuffle_mask({std::int8_t(o), std::int8_t(o + 2), std::int8_t(o + 4), std::int8_t(o + 6),
+                                     std::int8_t(o + 8), std::int8_t(o + 10), std::int8_t(o + 12),
+                                     std::int8_t(o + 14), z, z, z, z, z, z, z, z});
+    const __m128i us = shuffle_mask({cu, std::int8_t(cu + 4), std::int8_t(cu + 8), std::int8_t(cu + 12),
+                                     z, z, z, z, z, z, z, z, z, z, z, z});
+    const __m128i vs = shuffle_mask({cv, std::int8_t(cv + 4), std::int8_t(cv + 8), std::int8_t(cv + 12),
+                                     z, z, z, z, z, z, z, z, z, z, z, z});
+    y = _mm_unpacklo_epi64(_mm_shuffle_epi8(a, ys), _mm_shuffle_epi8(b, ys));
+    u = _mm_unpacklo_epi32(_mm_shuffle_epi8(a, us), _mm_shuffle_epi8(b, us));
+    v = _mm_unpacklo_epi32(_mm_shuffle_epi8(a, vs), _mm_shuffle_epi8(b, vs));
+}
+
+/// Loads 8 U and 8 V samples covering 16 pixels of a 4:2:0 row (NV12 or I420).
+inline void load_chroma420(const std::uint8_t* u, const std::uint8_t* v, std::size_t step, std::uint32_t x,
+                           __m128i& cu, __m128i& cv)
+{
+    if (step == 2) {
+        // NV12: `u` points at the interleaved UV row, `v` at u + 1.
+        const __m128i uv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + x));
+        cu = _mm_shuffle_epi8(uv, _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -128, -128, -128, -128, -128,
+                                                -128, -128, -128));
+        cv = _mm_shuffle_epi8(uv, _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, -128, -128, -128, -128, -128,
+                                                -128, -128, -128));
+    } else {
+        cu = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + x / 2));
+        cv = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + x / 2));
+    }
+}
+
+/// Index of the value each output channel takes at a Bayer site: c, h, v, cross, diag.
+constexpr int bayer_source(BayerSite site, int channel)
+{
+    constexpr int table[4][3] = {
+        {0, 3, 4}, // red: R = c, G = cross, B = diag
+        {1, 0, 2}, // green on red row: R = h, G = c, B = v
+        {2, 0, 1}, // green on blue row: R = v, G = c, B = h
+        {4, 3, 0}, // blue: R = diag, G = cross, B = c
+    };
+    return table[static_cast<int>(site)][channel];
+}
+
+} // namespace
+} // namespace camera_interface::detail
@@ -0,0 +1,347 @@
+#include "camera_interface/fake_v4l2_device.hpp"
+
+#include "camera_interface/clock.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <system_error>
+#include <thread>
+
+#include <linux/videodev2.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace camera_interface {
+
+namespace {
+
+constexpr std::size_t kPageSize = 4096;
+
+std::size_t round_up(std::size_t value, std::size_t multiple) noexcept
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+void copy_string(__u8* dst, std::size_t size, const std::string& src) noexcept
+{
+    std::strncpy(reinterpret_cast<char*>(dst), src.c_str(), size - 1);
+    dst[size - 1] = 0;
+}
+
+void write_pattern(std::byte* data, const StreamFormat& format, std::uint64_t sequence) noexcept
+{
+    const std::size_t size = format.frame_size();
+    for (std::size_t i = 0; i < size; ++i)
+        data[i] = static_cast<std::byte>(i % format.stride + i / format.stride + sequence);
+}
+
+} // namespace
+
+FakeV4l2Device::FakeV4l2Device() : FakeV4l2Device(Config{}) {}
+
+FakeV4l2Device::FakeV4l2Device(const Config& config) : config_(config)
+{
+    if (config_.format.stride == 0)
+        config_.format = StreamFormat::packed(config_.format.width, config_.format.height, config_.format.format);
+    event_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
+    if (event_fd_ < 0)
+        throw std::system_error(errno, std::generic_category(), "eventfd");
+}
+
+FakeV4l2Device::~FakeV4l2Device()
+{
+    release_buffers();
+    ::close(event_fd_);
+}
+
+int FakeV4l2Device::ioctl(unsigned long request, void* arg) noexcept
+{
+    if (config_.ioctl_latency.count() > 0)
+        std::this_thread::sleep_for(config_.ioctl_latency);
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int error = handle(request, arg);
+    if (error == 0)
+        return 0;
+    errno = error;
+    return -1;
+}
+
+int FakeV4l2Device::handle(unsigned long request, void* arg)
+{
+    switch (request) {
+    case VIDIOC_QUERYCAP: {
+        auto* cap = static_cast<v4l2_capability*>(arg);
+        std::memset(cap, 0, sizeof *cap);
+        copy_string(cap->driver, sizeof cap->driver, "fake_v4l2");
+        copy_string(cap->card, sizeof cap->card, config_.card);
+        copy_string(cap->bus_info, sizeof cap->bus_info, "platform:fake_v4l2");
+        cap->version = (1u << 16);
+        cap->device_caps = V4L2_CAP_VIDEO_CAPTURE | V4L2_CAP_STREAMING;
+        cap->capabilities = cap->device_caps | V4L2_CAP_DEVICE_CAPS;
+        return 0;
+    }
+    case VIDIOC_ENUM_FMT: {
+        auto* desc = static_cast<v4l2_fmtdesc*>(arg);
+        if (desc->type != V4L2_BUF_TYPE_VIDEO_CAPTURE || desc->index != 0)
+            return EINVAL;
+        desc->pixelformat = to_v4l2_fourcc(config_.format.format);
+        copy_string(desc->description, sizeof desc->description, to_string(config_.format.format));
+        return 0;
+    }
+    case VIDIOC_ENUM_FRAMESIZES: {
+        auto* size = static_cast<v4l2_frmsizeenum*>(arg);
+        if (size->index != 0 || size->pixel_format != to_v4l2_fourcc(config_.format.format))
+            return EINVAL;
+        size->type = V4L2_FRMSIZE_TYPE_DISCRETE;
+        size->discrete.width = config_.format.width;
+        size->discrete.height = config_.format.height;
+        return 0;
+    }
+    case VIDIOC_ENUM_FRAMEINTERVALS: {
+        auto* interval = static_cast<v4l2_frmivalenum*>(arg);
+        if (interval->index != 0 || interval->pixel_format != to_v4l2_fourcc(config_.format.format)
+            || interval->width != config_.format.width || interval->height != config_.format.height)
+            return EINVAL;
+        interval->type = V4L2_FRMIVAL_TYPE_DISCRETE;
+        interval->discrete.numerator = fps_denominator_;
+        interval->discrete.denominator = fps_numerator_;
+        return 0;
+    }
+    case VIDIOC_G_FMT:
+    case VIDIOC_S_FMT:
+    case VIDIOC_TRY_FMT: {
+        auto* fmt = static_cast<v4l2_format*>(arg);
+        if (fmt->type != V4L2_BUF_TYPE_VIDEO_CAPTURE)
+            return EINVAL;
+        StreamFormat format = config_.format;
+        if (request != VIDIOC_G_FMT) {
+            if (request == VIDIOC_S_FMT && !buffers_.empty())
+                return EBUSY;
+            if (const auto requested = from_v4l2_fourcc(fmt->fmt.pix.pixelformat))
+                format.format = *requested;
+            if (fmt->fmt.pix.width != 0 && fmt->fmt.pix.height != 0) {
+                format.width = fmt->fmt.pix.width;
+                format.height = fmt->fmt.pix.height;
+            }
+            format.stride = min_stride(format.format, format.width);
+            if (request == VIDIOC_S_FMT)
+                config_.format = format;
+        }
+        fmt->fmt.pix.width = format.width;
+        fmt->fmt.pix.height = format.height;
+        fmt->fmt.pix.pixelformat = to_v4l2_fourcc(format.format);
+        fmt->fmt.pix.field = V4L2_FIELD_NONE;
+        fmt->fmt.pix.bytesperline = static_cast<__u32>(format.stride);
+        fmt->fmt.pix.sizeimage = static_cast<__u32>(format.frame_size());
+        return 0;
+    }
+    case VIDIOC_G_PARM:
+    case VIDIOC_S_PARM: {
+        auto* parm = static_cast<v4l2_streamparm*>(arg);
+        if (parm->type != V4L2_BUF_TYPE_VIDEO_CAPTURE)
+            return EINVAL;
+        v4l2_fract& tpf = parm->parm.capture.timeperframe;
+        if (request == VIDIOC_S_PARM && tpf.numerator != 0 && tpf.denominator != 0) {
+            fps_numerator_ = tpf.denominator;
+            fps_denominator_ = tpf.numerator;
+        }
+        parm->parm.capture.capability = V4L2_CAP_TIMEPERFRAME;
+        tpf.numerator = fps_denominator_;
+        tpf.denominator = fps_numerator_;
+        return 0;
+    }
+    case VIDIOC_REQBUFS: {
+        auto* req = static_cast<v4l2_requestbuffers*>(arg);
+        if (req->type != V4L2_BUF_TYPE_VIDEO_CAPTURE)
+            return EINVAL;
+        if (req->memory != V4L2_MEMORY_MMAP && req->memory != V4L2_MEMORY_DMABUF)
+            return EINVAL;
+        if (streaming_)
+            return EBUSY;
+        release_buffers();
+        memory_ = req->memory;
+        req->capabilities = V4L2_BUF_CAP_SUPPORTS_MMAP | V4L2_BUF_CAP_SUPPORTS_DMABUF;
+        if (req->count == 0)
+            return 0;
+        const std::size_t length = config_.format.frame_size();
+        buffers_.resize(req->count);
+        if (memory_ == V4L2_MEMORY_MMAP) {
+            buffer_pitch_ = round_up(length, kPageSize);
+            storage_ = static_cast<std::byte*>(
+                ::operator new(buffer_pitch_ * req->count, std::align_val_t{kPageSize}));
+            for (std::size_t i = 0; i < buffers_.size(); ++i) {
+                buffers_[i].data = storage_ + i * buffer_pitch_;
+                buffers_[i].length = length;
+            }
+        }
+        return 0;
+    }
+    case VIDIOC_QUERYBUF:
+    case VIDIOC_QBUF: {
+        auto* buf = static_cast<v4l2_buffer*>(arg);
+        if (buf->type != V4L2_BUF_TYPE_VIDEO_CAPTURE || buf->index >= buffers_.size()
+            || buf->memory != memory_)
+            return EINVAL;
+        Buffer& buffer = buffers_[buf->index];
+        if (request == VIDIOC_QUERYBUF) {
+            buf->length = static_cast<__u32>(config_.format.frame_size());
+            if (memory_ == V4L2_MEMORY_MMAP)
+                buf->m.offset = static_cast<__u32>(buf->index * buffer_pitch_);
+            buf->flags = (buffer.queued ? V4L2_BUF_FLAG_QUEUED : 0) | (buffer.done ? V4L2_BUF_FLAG_DONE : 0);
+            return 0;
+        }
+        if (buffer.queued || buffer.done)
+            return EINVAL;
+        if (memory_ == V4L2_MEMORY_DMABUF && buffer.dmabuf_fd != buf->m.fd) {
+            const off_t size = ::lseek(buf->m.fd, 0, SEEK_END);
+            if (size < static_cast<off_t>(config_.format.frame_size()))
+                return EINVAL;
+            void* mapped = ::mmap(nullptr, static_cast<std::size_t>(size), PROT_READ | PROT_WRITE,
+                                  MAP_SHARED, buf->m.fd, 0);
+            if (mapped == MAP_FAILED)
+                return errno;
+            if (buffer.data)
+                ::munmap(buffer.data, buffer.length);
+            buffer.data = static_cast<std::byte*>(mapped);
+            buffer.length = static_cast<std::size_t>(size);
+            buffer.dmabuf_fd = buf->m.fd;
+        }
+        buffer.queued = true;
+        queued_.push_back(buf->index);
+        return 0;
+    }
+    case VIDIOC_DQBUF: {
+        auto* buf = static_cast<v4l2_buffer*>(arg);
+        if (buf->type != V4L2_BUF_TYPE_VIDEO_CAPTURE || buf->memory != memory_)
+            return EINVAL;
+        if (!streaming_)
+            return EINVAL;
+        if (done_.empty())
+            return EAGAIN;
+        const std::uint32_t index = done_.front();
+        done_.pop_front();
+        std::uint64_t token;
+        [[maybe_unused]] const auto n = ::read(event_fd_, &token, sizeof token);
+
+        Buffer& buffer = buffers_[index];
+        buffer.done = false;
+        buf->index = index;
+        buf->bytesused = buffer.bytes_used;
+        buf->flags = V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC;
+        buf->field = V4L2_FIELD_NONE;
+        buf->sequence = static_cast<__u32>(buffer.sequence);
+        buf->timestamp.tv_sec = buffer.timestamp_ns / 1'000'000'000;
+        buf->timestamp.tv_usec = (buffer.timestamp_ns % 1'000'000'000) / 1000;
+        buf->length = static_cast<__u32>(buffer.length);
+        if (memory_ == V4L2_MEMORY_DMABUF)
+            buf->m.fd = buffer.dmabuf_fd;
+        else
+            buf->m.offset = static_cast<__u32>(index * buffer_pitch_);
+        return 0;
+    }
+    case VIDIOC_STREAMON:
+    case VIDIOC_STREAMOFF: {
+        if (*static_cast<int*>(arg) != V4L2_BUF_TYPE_VIDEO_CAPTURE)
+            return EINVAL;
+        if (request == VIDIOC_STREAMON) {
+            if (buffers_.empty())
+                return EINVAL;
+            streaming_ = true;
+            return 0;
+        }
+        streaming_ = false;
+        for (Buffer& buffer : buffers_)
+            buffer.queued = buffer.done = false;
+        queued_.clear();
+        done_.clear();
+        std::uint64_t token;
+        while (::read(event_fd_, &token, sizeof token) > 0) {
+        }
+        return 0;
+    }
+    default:
+        return ENOTTY;
+    }
+}
+
+void* FakeV4l2Device::mmap(std::size_t length, std::int64_t offset) noexcept
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (memory_ != V4L2_MEMORY_MMAP || offset < 0 || buffer_pitch_ == 0
+        || static_cast<std::size_t>(offset) % buffer_pitch_ != 0)
+        return MAP_FAILED;
+    const std::size_t index = static_cast<std::size_t>(offset) / buffer_pitch_;
+    if (index >= buffers_.size() || length > buffer_pitch_)
+        return MAP_FAILED;
+    return buffers_[index].data;
+}
+
+void FakeV4l2Device::munmap(void*, std::size_t) noexcept {}
+
+bool FakeV4l2Device::produce(const Fill& fill, std::int64_t timestamp_ns)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!streaming_)
+        return false;
+    const std::uint64_t sequence = sequence_++;
+    if (queued_.empty()) {
+        ++lost_;
+        return false;
+    }
+    const std::uint32_t index = queued_.front();
+    queued_.pop_front();
+
+    Buffer& buffer = buffers_[index];
+    if (fill)
+        fill(buffer.data, config_.format, sequence);
+    else
+        write_pattern(buffer.data, config_.format, sequence);
+    buffer.queued = false;
+    buffer.done = true;
+    buffer.bytes_used = static_cast<std::uint32_t>(config_.format.frame_size());
+    buffer.sequence = sequence;
+    buffer.timestamp_ns = timestamp_ns != 0 ? timestamp_ns : monotonic_now_ns();
+    done_.push_back(index);
+
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const auto n = ::write(event_fd_, &one, sizeof one);
+    return true;
+}
+
+bool FakeV4l2Device::streaming() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return streaming_;
+}
+
+std::size_t FakeV4l2Device::queued_buffers() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_.size();
+}
+
+std::uint64_t FakeV4l2Device::lost_frames() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lost_;
+}
+
+void FakeV4l2Device::release_buffers()
+{
+    if (memory_ == V4L2_MEMORY_DMABUF) {
+        for (Buffer& buffer : buffers_)
+            if (buffer.data)
+                ::munmap(buffer.data, buffer.length);
+    }
+    if (storage_)
+        ::operator delete(storage_, std::align_val_t{kPageSize});
+    storage_ = nullptr;
+    buffer_pitch_ = 0;
+    buffers_.clear();
+    queued_.clear();
+    done_.clear();
+}
+
+} // namespace camera_interface
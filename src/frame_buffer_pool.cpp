@@ -0,0 +1,271 @@
+#include "camera_interface/frame_buffer_pool.hpp"
+
+#include "camera_interface/placement.hpp"
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(CAMERA_INTERFACE_HAVE_LIBNUMA)
+#include <numaif.h>
+#endif
+
+namespace camera_interface {
+
+namespace detail {
+
+namespace {
+
+constexpr std::uint32_t kNoSlot = std::numeric_limits<std::uint32_t>::max();
+
+constexpr std::uint64_t pack_head(std::uint64_t tag, std::uint32_t index) noexcept
+{
+    return (tag << 32) | index;
+}
+
+} // namespace
+
+struct PoolState {
+    std::unique_ptr<FrameSlot[]> slots;
+    std::size_t capacity = 0;
+    std::size_t buffer_size = 0;
+    std::byte* storage = nullptr;
+    std::size_t alignment = 0;
+    /// Anonymous mapping behind `storage` when it is bound to a NUMA node.
+    void* mapping = nullptr;
+    std::size_t mapping_size = 0;
+    int numa_node = -1;
+    bool external = false;
+    ReleaseHook on_release;
+
+    /// Tagged Treiber stack head: upper 32 bits are an ABA counter, lower 32 the slot index.
+    alignas(64) std::atomic<std::uint64_t> free_head{pack_head(0, kNoSlot)};
+    alignas(64) std::atomic<std::size_t> available{0};
+    /// One reference for the owning pool object plus one per slot in use.
+    std::atomic<std::size_t> lifetime{1};
+    std::atomic<bool> orphaned{false};
+
+    ~PoolState()
+    {
+        if (mapping)
+            ::munmap(mapping, mapping_size);
+        else if (storage)
+            ::operator delete(storage, std::align_val_t{alignment});
+    }
+
+    void push_free(FrameSlot* slot) noexcept
+    {
+        std::uint64_t head = free_head.load(std::memory_order_relaxed);
+        std::uint64_t next;
+        do {
+            slot->next_free.store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+            next = pack_head((head >> 32) + 1, slot->index);
+        } while (!free_head.compare_exchange_weak(head, next, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+    }
+
+    FrameSlot* pop_free() noexcept
+    {
+        std::uint64_t head = free_head.load(std::memory_order_acquire);
+        for (;;) {
+            const auto index = static_cast<std::uint32_t>(head);
+            if (index == kNoSlot)
+                return nullptr;
+            const std::uint32_t after = slots[index].next_free.load(std::memory_order_relaxed);
+            const std::uint64_t next = pack_head((head >> 32) + 1, after);
+            if (free_head.compare_exchange_weak(head, next, std::memory_order_acquire,
+                                                std::memory_order_acquire))
+                return &slots[index];
+        }
+    }
+
+    void drop_reference() noexcept
+    {
+        if (lifetime.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete this;
+    }
+};
+
+void release_slot(FrameSlot* slot) noexcept
+{
+    PoolState* state = slot->state;
+    state->available.fetch_add(1, std::memory_order_relaxed);
+    if (state->external) {
+        if (state->on_release && !state->orphaned.load(std::memory_order_acquire))
+            state->on_release(slot->index);
+    } else {
+        state->push_free(slot);
+    }
+    state->drop_reference();
+}
+
+} // namespace detail
+
+namespace {
+
+std::size_t round_up(std::size_t value, std::size_t multiple) noexcept
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+/// Maps `size` bytes whose pages are preferably placed on `node`; they fall back to other
+/// nodes rather than failing when it runs out of memory. Null without NUMA support.
+#if defined(CAMERA_INTERFACE_HAVE_LIBNUMA)
+std::byte* map_on_node(detail::PoolState& state, std::size_t size, std::size_t alignment, int node)
+{
+    if (node < 0 || !numa_supported())
+        return nullptr;
+    if (node >= numa_node_count())
+        throw std::invalid_argument("FrameBufferPool: no such NUMA node");
+    const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t slack = alignment > page ? alignment : 0;
+    const std::size_t length = round_up(size, page) + slack;
+    void* mapping = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED)
+        throw std::bad_alloc();
+    constexpr std::size_t kMaskBits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(static_cast<std::size_t>(node) / kMaskBits + 1);
+    mask[static_cast<std::size_t>(node) / kMaskBits] = 1ul << (static_cast<std::size_t>(node) % kMaskBits);
+    if (::mbind(mapping, length, MPOL_PREFERRED, mask.data(), mask.size() * kMaskBits, 0) != 0) {
+        ::munmap(mapping, length);
+        return nullptr;
+    }
+    state.mapping = mapping;
+    state.mapping_size = length;
+    state.numa_node = node;
+    return reinterpret_cast<std::byte*>(round_up(reinterpret_cast<std::uintptr_t>(mapping), alignment));
+}
+#else
+std::byte* map_on_node(detail::PoolState&, std::size_t, std::size_t, int)
+{
+    return nullptr;
+}
+#endif
+
+} // namespace
+
+FrameBufferPool::FrameBufferPool(const Config& config) : state_(new detail::PoolState)
+{
+    std::unique_ptr<detail::PoolState> guard(state_);
+    if (config.capacity == 0 || config.capacity >= detail::kNoSlot)
+        throw std::invalid_argument("FrameBufferPool: capacity out of range");
+    if (config.buffer_size == 0)
+        throw std::invalid_argument("FrameBufferPool: buffer_size must be non-zero");
+    if (config.alignment == 0 || (config.alignment & (config.alignment - 1)) != 0)
+        throw std::invalid_argument("FrameBufferPool: alignment must be a power of two");
+
+    const std::size_t pitch = round_up(config.buffer_size, config.alignment);
+    state_->alignment = config.alignment;
+    state_->storage = map_on_node(*state_, pitch * config.capacity, config.alignment, config.numa_node);
+    if (!state_->storage)
+        state_->storage = static_cast<std::byte*>(
+            ::operator new(pitch * config.capacity, std::align_val_t{config.alignment}));
+    if (config.prefault)
+        std::memset(state_->storage, 0, pitch * config.capacity);
+
+    state_->capacity = config.capacity;
+    state_->buffer_size = config.buffer_size;
+    state_->slots = std::make_unique<detail::FrameSlot[]>(config.capacity);
+    for (std::size_t i = config.capacity; i-- > 0;) {
+        detail::FrameSlot& slot = state_->slots[i];
+        slot.index = static_cast<std::uint32_t>(i);
+        slot.data = state_->storage + i * pitch;
+        slot.capacity = config.buffer_size;
+        slot.state = state_;
+        state_->push_free(&slot);
+    }
+    state_->available.store(config.capacity, std::memory_order_relaxed);
+    guard.release();
+}
+
+FrameBufferPool::FrameBufferPool(std::vector<BufferRegion> buffers, ReleaseHook on_release)
+    : state_(new detail::PoolState)
+{
+    std::unique_ptr<detail::PoolState> guard(state_);
+    if (buffers.empty() || buffers.size() >= detail::kNoSlot)
+        throw std::invalid_argument("FrameBufferPool: buffer count out of range");
+
+    state_->external = true;
+    state_->on_release = std::move(on_release);
+    state_->capacity = buffers.size();
+    state_->slots = std::make_unique<detail::FrameSlot[]>(buffers.size());
+    for (std::size_t i = 0; i < buffers.size(); ++i) {
+        detail::FrameSlot& slot = state_->slots[i];
+        slot.index = static_cast<std::uint32_t>(i);
+        slot.data = buffers[i].data;
+        slot.capacity = buffers[i].size;
+        slot.state = state_;
+        if (i == 0 || buffers[i].size < state_->buffer_size)
+            state_->buffer_size = buffers[i].size;
+    }
+    state_->available.store(buffers.size(), std::memory_order_relaxed);
+    guard.release();
+}
+
+FrameBufferPool::~FrameBufferPool()
+{
+    state_->orphaned.store(true, std::memory_order_release);
+    state_->drop_reference();
+}
+
+FrameHandle FrameBufferPool::acquire() noexcept
+{
+    if (state_->external)
+        return {};
+    detail::FrameSlot* slot = state_->pop_free();
+    if (!slot)
+        return {};
+    state_->lifetime.fetch_add(1, std::memory_order_relaxed);
+    state_->available.fetch_sub(1, std::memory_order_relaxed);
+    slot->info = FrameInfo{};
+    slot->refs.store(1, std::memory_order_relaxed);
+    return FrameHandle(slot);
+}
+
+FrameHandle FrameBufferPool::claim(std::uint32_t index) noexcept
+{
+    if (!state_->external || index >= state_->capacity)
+        return {};
+    detail::FrameSlot& slot = state_->slots[index];
+    std::uint32_t expected = 0;
+    if (!slot.refs.compare_exchange_strong(expected, 1, std::memory_order_acquire,
+                                           std::memory_order_relaxed))
+        return {};
+    state_->lifetime.fetch_add(1, std::memory_order_relaxed);
+    state_->available.fetch_sub(1, std::memory_order_relaxed);
+    slot.info = FrameInfo{};
+    return FrameHandle(&slot);
+}
+
+std::size_t FrameBufferPool::capacity() const noexcept
+{
+    return state_->capacity;
+}
+
+std::size_t FrameBufferPool::buffer_size() const noexcept
+{
+    return state_->buffer_size;
+}
+
+std::size_t FrameBufferPool::available() const noexcept
+{
+    return state_->available.load(std::memory_order_relaxed);
+}
+
+bool FrameBufferPool::is_external() const noexcept
+{
+    return state_->external;
+}
+
+int FrameBufferPool::numa_node() const noexcept
+{
+    return state_->numa_node;
+}
+
+} // namespace camera_interface
@@ -0,0 +1,475 @@
+#include "camera_interface/frame_codec.hpp"
+
+#include "camera_interface/thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace camera_interface {
+
+namespace {
+
+// Encoded frame:
+//
+//   EncodedFrameHeader | std::uint32_t band_size[band_count] | band 0 | band 1 | ...
+//
+// Band i holds bytes [i * band_bytes, min((i + 1) * band_bytes, bytes_used)) of the
+// predicted frame as an LZ4 block, or verbatim when its size equals that range's length.
+
+constexpr std::uint32_t kEncodedMagic = 0x345a4c44; // "DLZ4"
+
+struct EncodedFrameHeader {
+    std::uint32_t magic;
+    std::uint8_t predictor; ///< DeltaPredictor.
+    std::uint8_t sample_bytes;
+    std::uint8_t left; ///< Distance to the left neighbour, in samples.
+    std::uint8_t up;   ///< Distance to the upper neighbour, in rows.
+    std::uint32_t row_bytes;
+    std::uint32_t band_bytes;
+    std::uint32_t band_count;
+    std::uint32_t reserved;
+};
+static_assert(sizeof(EncodedFrameHeader) == 24);
+
+using Byte = unsigned char;
+
+template <typename F>
+void for_each_band(ThreadPool* pool, std::size_t count, F&& body)
+{
+    if (pool && count > 1) {
+        pool->parallel_for(count, body);
+    } else {
+        for (std::size_t i = 0; i < count; ++i)
+            body(i);
+    }
+}
+
+// --- Prediction -------------------------------------------------------------------------
+
+template <typename T>
+T load(const Byte* p, std::size_t i) noexcept
+{
+    T v;
+    std::memcpy(&v, p + i * sizeof(T), sizeof(T));
+    return v;
+}
+
+template <typename T>
+void store(Byte* p, std::size_t i, T v) noexcept
+{
+    std::memcpy(p + i * sizeof(T), &v, sizeof(T));
+}
+
+struct Prediction {
+    DeltaPredictor predictor = DeltaPredictor::none;
+    unsigned sample_bytes = 1;
+    unsigned left = 1;
+    unsigned up = 1;
+    std::size_t row_bytes = 0;
+};
+
+template <typename T>
+void predict_rows(const Byte* in, Byte* out, std::size_t rows, const Prediction& p) noexcept
+{
+    const std::size_t samples = p.row_bytes / sizeof(T);
+    for (std::size_t r = 0; r < rows; ++r) {
+        const Byte* row = in + r * p.row_bytes;
+        Byte* dst = out + r * p.row_bytes;
+        if (p.predictor == DeltaPredictor::up && r >= p.up) {
+            const Byte* above = row - p.up * p.row_bytes;
+            for (std::size_t i = 0; i < samples; ++i)
+                store<T>(dst, i, static_cast<T>(load<T>(row, i) - load<T>(above, i)));
+            continue;
+        }
+        const std::size_t head = std::min<std::size_t>(p.left, samples);
+        std::memcpy(dst, row, head * sizeof(T));
+        for (std::size_t i = head; i < samples; ++i)
+            store<T>(dst, i, static_cast<T>(load<T>(row, i) - load<T>(row, i - p.left)));
+    }
+}
+
+template <typename T>
+void unpredict_rows(Byte* data, std::size_t rows, const Prediction& p) noexcept
+{
+    const std::size_t samples = p.row_bytes / sizeof(T);
+    for (std::size_t r = 0; r < rows; ++r) {
+        Byte* row = data + r * p.row_bytes;
+        if (p.predictor == DeltaPredictor::up && r >= p.up) {
+            const Byte* above = row - p.up * p.row_bytes;
+            for (std::size_t i = 0; i < samples; ++i)
+                store<T>(row, i, static_cast<T>(load<T>(row, i) + load<T>(above, i)));
+            continue;
+        }
+        for (std::size_t i = p.left; i < samples; ++i)
+            store<T>(row, i, static_cast<T>(load<T>(row, i) + load<T>(row, i - p.left)));
+    }
+}
+
+void predict(const Byte* in, Byte* out, std::size_t rows, const Prediction& p) noexcept
+{
+    if (p.sample_bytes == 2)
+        predict_rows<std::uint16_t>(in, out, rows, p);
+    else
+        predict_rows<std::uint8_t>(in, out, rows, p);
+}
+
+void unpredict(Byte* data, std::size_t rows, const Prediction& p) noexcept
+{
+    if (p.sample_bytes == 2)
+        unpredict_rows<std::uint16_t>(data, rows, p);
+    else
+        unpredict_rows<std::uint8_t>(data, rows, p);
+}
+
+Prediction prediction_for(const StreamFormat& format, DeltaPredictor predictor) noexcept
+{
+    Prediction p;
+    p.row_bytes = format.stride;
+    if (format.format == PixelFormat::mono16)
+        p.sample_bytes = 2;
+    else if (is_bayer(format.format))
+        p.left = p.up = 2;
+    else if (format.format != PixelFormat::mono8)
+        return p;
+    if (format.stride % p.sample_bytes == 0)
+        p.predictor = predictor;
+    return p;
+}
+
+// --- LZ4 block format -------------------------------------------------------------------
+//
+// Sequences of (token, literal length, literals, 16-bit offset, match length), as specified
+// by the LZ4 block format, so bands can also be inspected with stock LZ4 tooling. The
+// compressor is the single-probe greedy matcher of LZ4's fast mode.
+
+constexpr unsigned kHashLog = 12;
+constexpr std::size_t kMinMatch = 4;
+constexpr std::size_t kLastLiterals = 5; ///< The format ends with at least this many literals.
+constexpr std::size_t kMatchLimit = 12;  ///< No match may start within this many bytes of the end.
+constexpr std::size_t kMaxOffset = 65535;
+
+constexpr std::size_t lz4_bound(std::size_t bytes) noexcept
+{
+    return bytes + bytes / 255 + 16;
+}
+
+std::uint32_t read32(const Byte* p) noexcept
+{
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof v);
+    return v;
+}
+
+std::uint32_t hash4(std::uint32_t v) noexcept
+{
+    return (v * 2654435761u) >> (32 - kHashLog);
+}
+
+Byte* put_length(Byte* op, std::size_t length) noexcept
+{
+    for (; length >= 255; length -= 255)
+        *op++ = 255;
+    *op++ = static_cast<Byte>(length);
+    return op;
+}
+
+/// Writes literals [anchor, anchor + literals) and, unless `match` is 0, a match.
+Byte* put_sequence(Byte* op, const Byte* anchor, std::size_t literals, std::size_t match,
+                   std::size_t offset) noexcept
+{
+    const std::size_t match_code = match == 0 ? 0 : match - kMinMatch;
+    *op++ = static_cast<Byte>((std::min<std::size_t>(literals, 15) << 4) | std::min<std::size_t>(match_code, 15));
+    if (literals >= 15)
+        op = put_length(op, literals - 15);
+    std::memcpy(op, anchor, literals);
+    op += literals;
+    if (match == 0)
+        return op;
+    *op++ = static_cast<Byte>(offset);
+    *op++ = static_cast<Byte>(offset >> 8);
+    if (match_code >= 15)
+        op = put_length(op, match_code - 15);
+    return op;
+}
+
+/// Length of the common prefix of `a` and `b`, stopping at `a_end`.
+std::size_t common_length(const Byte* a, const Byte* b, const Byte* a_end) noexcept
+{
+    const Byte* start = a;
+    if constexpr (std::endian::native == std::endian::little) {
+        while (a + 8 <= a_end) {
+            std::uint64_t x, y;
+            std::memcpy(&x, a, 8);
+            std::memcpy(&y, b, 8);
+            if (x != y)
+                return static_cast<std::size_t>(a - start) + static_cast<std::size_t>(std::countr_zero(x ^ y) / 8);
+            a += 8;
+            b += 8;
+        }
+    }
+    while (a < a_end && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return static_cast<std::size_t>(a - start);
+}
+
+/// Compresses `bytes` bytes into at most `lz4_bound(bytes)`; returns the compressed size.
+std::size_t lz4_compress(const Byte* src, std::size_t bytes, Byte* dst) noexcept
+{
+    Byte* op = dst;
+    const Byte* anchor = src;
+    if (bytes > kMatchLimit) {
+        std::uint32_t table[1u << kHashLog] = {};
+        const Byte* const match_start_limit = src + bytes - kMatchLimit;
+        const Byte* const match_end_limit = src + bytes - kLastLiterals;
+        const Byte* ip = src + 1;
+        unsigned misses = 0;
+        while (ip < match_start_limit) {
+            const std::uint32_t sequence = read32(ip);
+            std::uint32_t& slot = table[hash4(sequence)];
+            const Byte* ref = src + slot;
+            slot = static_cast<std::uint32_t>(ip - src);
+            if (static_cast<std::size_t>(ip - ref) > kMaxOffset || read32(ref) != sequence) {
+                // Skip ahead faster through data that does not compress.
+                ip += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+            while (ip > anchor && ref > src && ip[-1] == ref[-1]) {
+                --ip;
+                --ref;
+            }
+            const std::size_t match = kMinMatch + common_length(ip + kMinMatch, ref + kMinMatch, match_end_limit);
+            op = put_sequence(op, anchor, static_cast<std::size_t>(ip - anchor), match,
+                              static_cast<std::size_t>(ip - ref));
+            ip += match;
+            anchor = ip;
+            if (ip < match_start_limit)
+                table[hash4(read32(ip - 2))] = static_cast<std::uint32_t>(ip - 2 - src);
+        }
+    }
+    op = put_sequence(op, anchor, static_cast<std::size_t>(src + bytes - anchor), 0, 0);
+    return static_cast<std::size_t>(op - dst);
+}
+
+bool get_length(const Byte*& ip, const Byte* end, std::size_t& length) noexcept
+{
+    Byte b;
+    do {
+        if (ip == end)
+            return false;
+        b = *ip++;
+        length += b;
+    } while (b == 255);
+    return true;
+}
+
+/// Decompresses exactly `bytes` bytes; false on malformed or mis-sized input.
+bool lz4_decompress(const Byte* src, std::size_t size, Byte* dst, std::size_t bytes) noexcept
+{
+    const Byte* ip = src;
+    const Byte* const end = src + size;
+    Byte* op = dst;
+    Byte* const out_end = dst + bytes;
+    for (;;) {
+        if (ip == end)
+            return false;
+        const unsigned token = *ip++;
+        std::size_t literals = token >> 4;
+        if (literals == 15 && !get_length(ip, end, literals))
+            return false;
+        if (literals > static_cast<std::size_t>(end - ip) || literals > static_cast<std::size_t>(out_end - op))
+            return false;
+        // Short runs are copied as one fixed-size block when both sides have room for it;
+        // bytes past the run are overwritten by what follows.
+        if (literals <= 16 && end - ip >= 16 && out_end - op >= 16)
+            std::memcpy(op, ip, 16);
+        else
+            std::memcpy(op, ip, literals);
+        op += literals;
+        ip += literals;
+        if (ip == end)
+            return op == out_end;
+
+        if (end - ip < 2)
+            return false;
+        const std::size_t offset = ip[0] | static_cast<std::size_t>(ip[1]) << 8;
+        ip += 2;
+        std::size_t match = token & 15;
+        if (match == 15 && !get_length(ip, end, match))
+            return false;
+        match += kMinMatch;
+        if (offset == 0 || offset > static_cast<std::size_t>(op - dst)
+            || match > static_cast<std::size_t>(out_end - op))
+            return false;
+        const Byte* ref = op - offset;
+        // A pattern repeating every `offset` bytes also repeats every multiple of it; short
+        // offsets seed one such multiple of at least 8 bytes, then copy in 8-byte blocks. The
+        // seed alone can write up to 14 bytes, so both it and the last block must fit.
+        const std::size_t seed = offset < 8 ? (8 + offset - 1) / offset * offset : 0;
+        const std::size_t period = offset < 8 ? seed : offset;
+        if (static_cast<std::size_t>(out_end - op) >= std::max(match, seed) + 8) {
+            std::size_t i = 0;
+            for (; i < seed; ++i)
+                op[i] = ref[i];
+            for (; i < match; i += 8)
+                std::memcpy(op + i, op + i - period, 8);
+        } else if (offset >= match) {
+            std::memcpy(op, ref, match);
+        } else {
+            // Overlapping copy: repeats the last `offset` bytes.
+            for (std::size_t i = 0; i < match; ++i)
+                op[i] = ref[i];
+        }
+        op += match;
+    }
+}
+
+std::size_t band_count(std::size_t bytes, std::size_t band_bytes) noexcept
+{
+    return (bytes + band_bytes - 1) / band_bytes;
+}
+
+} // namespace
+
+struct FrameEncoder::Band {
+    Byte* predicted = nullptr;  ///< Scratch for the predicted samples.
+    Byte* compressed = nullptr; ///< Scratch for the LZ4 block.
+    const Byte* stored = nullptr;
+    std::size_t size = 0;
+    std::size_t at = 0; ///< Offset in the encoded frame.
+};
+
+FrameEncoder::FrameEncoder(const StreamFormat& format, const FrameCodecConfig& config, ThreadPool* pool)
+    : format_(format), config_(config), pool_(pool)
+{
+    if (format.width == 0 || format.height == 0 || format.stride == 0)
+        throw std::invalid_argument("FrameEncoder: empty frame format");
+    if (config.band_rows == 0)
+        throw std::invalid_argument("FrameEncoder: band_rows must be positive");
+    const std::size_t frame_bytes = format.frame_size();
+    const std::size_t band_bytes = std::min(frame_bytes, std::size_t{config.band_rows} * format.stride);
+    const std::size_t bands = band_count(frame_bytes, band_bytes);
+    max_encoded_size_ = sizeof(EncodedFrameHeader) + bands * sizeof(std::uint32_t) + frame_bytes;
+
+    const std::size_t band_scratch = band_bytes + lz4_bound(band_bytes);
+    bands_ = std::make_unique<Band[]>(bands);
+    scratch_ = std::make_unique<std::byte[]>(bands * band_scratch);
+    for (std::size_t i = 0; i < bands; ++i) {
+        bands_[i].predicted = reinterpret_cast<Byte*>(scratch_.get()) + i * band_scratch;
+        bands_[i].compressed = bands_[i].predicted + band_bytes;
+    }
+}
+
+FrameEncoder::~FrameEncoder() = default;
+
+std::size_t FrameEncoder::encode(const std::byte* src, std::size_t bytes, std::byte* dst) noexcept
+{
+    bytes = std::min(bytes, format_.frame_size());
+    Prediction prediction = prediction_for(format_, config_.predictor);
+    if (bytes != format_.frame_size() || bytes % prediction.row_bytes != 0)
+        prediction.predictor = DeltaPredictor::none;
+    const std::size_t band_bytes = std::max<std::size_t>(
+        1, std::min(bytes, std::size_t{config_.band_rows} * format_.stride));
+    const std::size_t bands = band_count(bytes, band_bytes);
+    const auto* in = reinterpret_cast<const Byte*>(src);
+
+    for_each_band(pool_, bands, [&](std::size_t i) {
+        Band& band = bands_[i];
+        const std::size_t offset = i * band_bytes;
+        const std::size_t length = std::min(band_bytes, bytes - offset);
+        const Byte* raw = in + offset;
+        if (prediction.predictor != DeltaPredictor::none) {
+            predict(raw, band.predicted, length / prediction.row_bytes, prediction);
+            raw = band.predicted;
+        }
+        const std::size_t size = lz4_compress(raw, length, band.compressed);
+        band.stored = size < length ? band.compressed : raw;
+        band.size = std::min(size, length);
+    });
+
+    EncodedFrameHeader header{};
+    header.magic = kEncodedMagic;
+    header.predictor = static_cast<std::uint8_t>(prediction.predictor);
+    header.sample_bytes = static_cast<std::uint8_t>(prediction.sample_bytes);
+    header.left = static_cast<std::uint8_t>(prediction.left);
+    header.up = static_cast<std::uint8_t>(prediction.up);
+    header.row_bytes = static_cast<std::uint32_t>(prediction.row_bytes);
+    header.band_bytes = static_cast<std::uint32_t>(band_bytes);
+    header.band_count = static_cast<std::uint32_t>(bands);
+    auto* out = reinterpret_cast<Byte*>(dst);
+    std::memcpy(out, &header, sizeof header);
+    std::size_t end = sizeof header + bands * sizeof(std::uint32_t);
+    for (std::size_t i = 0; i < bands; ++i) {
+        const auto size = static_cast<std::uint32_t>(bands_[i].size);
+        std::memcpy(out + sizeof header + i * sizeof size, &size, sizeof size);
+        bands_[i].at = end;
+        end += size;
+    }
+    for_each_band(pool_, bands,
+                  [&](std::size_t i) { std::memcpy(out + bands_[i].at, bands_[i].stored, bands_[i].size); });
+    return end;
+}
+
+bool decode_frame(std::span<const std::byte> src, std::byte* dst, std::size_t bytes, ThreadPool* pool) noexcept
+{
+    EncodedFrameHeader header;
+    if (src.size() < sizeof header)
+        return false;
+    std::memcpy(&header, src.data(), sizeof header);
+    if (header.magic != kEncodedMagic || header.band_bytes == 0
+        || header.predictor > static_cast<std::uint8_t>(DeltaPredictor::up))
+        return false;
+    Prediction prediction;
+    prediction.predictor = static_cast<DeltaPredictor>(header.predictor);
+    prediction.sample_bytes = header.sample_bytes;
+    prediction.left = header.left;
+    prediction.up = header.up;
+    prediction.row_bytes = header.row_bytes;
+    if (prediction.predictor != DeltaPredictor::none
+        && ((prediction.sample_bytes != 1 && prediction.sample_bytes != 2) || prediction.left == 0
+            || prediction.up == 0 || prediction.row_bytes == 0 || prediction.row_bytes % prediction.sample_bytes != 0
+            || header.band_bytes % prediction.row_bytes != 0 || bytes % prediction.row_bytes != 0))
+        return false;
+
+    const std::size_t bands = band_count(bytes, header.band_bytes);
+    const std::size_t table_end = sizeof header + bands * sizeof(std::uint32_t);
+    if (header.band_count != bands || src.size() < table_end)
+        return false;
+    const auto* in = reinterpret_cast<const Byte*>(src.data());
+    std::unique_ptr<std::size_t[]> offsets(new (std::nothrow) std::size_t[bands + 1]);
+    if (!offsets)
+        return false;
+    offsets[0] = table_end;
+    for (std::size_t i = 0; i < bands; ++i) {
+        std::uint32_t size;
+        std::memcpy(&size, in + sizeof header + i * sizeof size, sizeof size);
+        offsets[i + 1] = offsets[i] + size;
+    }
+    if (offsets[bands] != src.size())
+        return false;
+
+    std::atomic<bool> ok{true};
+    auto* out = reinterpret_cast<Byte*>(dst);
+    for_each_band(pool, bands, [&](std::size_t i) {
+        const std::size_t offset = i * header.band_bytes;
+        const std::size_t length = std::min<std::size_t>(header.band_bytes, bytes - offset);
+        const std::size_t size = offsets[i + 1] - offsets[i];
+        if (size == length) {
+            std::memcpy(out + offset, in + offsets[i], length);
+        } else if (!lz4_decompress(in + offsets[i], size, out + offset, length)) {
+            ok.store(false, std::memory_order_relaxed);
+            return;
+        }
+        if (prediction.predictor != DeltaPredictor::none)
+            unpredict(out + offset, length / prediction.row_bytes, prediction);
+    });
+    return ok.load(std::memory_order_relaxed);
+}
+
+} // namespace camera_interface
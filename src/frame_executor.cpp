@@ -0,0 +1,199 @@
+#include "camera_interface/frame_executor.hpp"
+
+#include "camera_interface/clock.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <utility>
+
+namespace camera_interface {
+
+namespace {
+
+/// Frames are split into this many bands per worker in latency mode, so that a worker that
+/// finishes early can steal a share of a slower one's rows.
+constexpr std::uint32_t kBandsPerWorker = 4;
+
+std::uint32_t div_ceil(std::uint32_t a, std::uint32_t b) noexcept
+{
+    return (a + b - 1) / b;
+}
+
+} // namespace
+
+FrameExecutor::FrameExecutor(std::shared_ptr<ThreadPool> threads, const FrameExecutorConfig& config)
+    : threads_(threads ? std::move(threads) : std::make_shared<ThreadPool>()),
+      config_(config),
+      roi_(config.transform.crop.value_or(Rect{0, 0, config.input.width, config.input.height})),
+      pool_(FrameBufferPool::Config{
+          config.pool_capacity,
+          downscaled_format(StreamFormat::packed(roi_.width, roi_.height, config.transform.output),
+                            config.transform.downscale)
+              .frame_size()}),
+      results_(std::bit_ceil(std::max<std::size_t>(config.results_depth, 1)))
+{
+    const FrameTransform& t = config_.transform;
+    if (t.downscale == 0)
+        throw std::invalid_argument("FrameExecutor: downscale factor must be at least 1");
+    const StreamFormat converted = StreamFormat::packed(roi_.width, roi_.height, t.output);
+    output_ = downscaled_format(converted, t.downscale);
+    if (output_.width == 0 || output_.height == 0)
+        throw std::invalid_argument("FrameExecutor: output would be empty");
+
+    // Validation only: empty row ranges check the geometry without touching pixels.
+    convert_rows(ConstImageView{nullptr, config_.input}, roi_, ImageView{nullptr, converted}, 0, 0, t.convert);
+    if (t.downscale > 1)
+        downscale_rows(ConstImageView{nullptr, converted}, ImageView{nullptr, output_}, t.downscale, 0, 0);
+    convert_then_scale_ = t.downscale > 1 && t.output != config_.input.format;
+    strip_stride_ = converted.stride;
+
+    band_rows_ = config_.band_rows;
+    if (band_rows_ == 0)
+        band_rows_ = config_.mode == ExecutionMode::throughput
+                         ? output_.height
+                         : div_ceil(output_.height, threads_->size() * kBandsPerWorker);
+    band_rows_ = std::clamp(band_rows_, 1u, output_.height);
+    bands_ = div_ceil(output_.height, band_rows_);
+
+    jobs_.reserve(pool_.capacity());
+    for (std::size_t i = 0; i < pool_.capacity(); ++i) {
+        auto job = std::make_unique<Job>();
+        job->owner = this;
+        if (convert_then_scale_)
+            job->strips.resize(std::size_t{bands_} * t.downscale * strip_stride_);
+        jobs_.push_back(std::move(job));
+    }
+}
+
+FrameExecutor::~FrameExecutor()
+{
+    wait_idle();
+}
+
+void FrameExecutor::check_input(const FrameHandle& input) const
+{
+    if (!input)
+        throw std::invalid_argument("FrameExecutor: empty input frame");
+    const StreamFormat& f = input.info().format;
+    if (f.format != config_.input.format || f.width != config_.input.width || f.height != config_.input.height
+        || f.stride < min_stride(f.format, f.width))
+        throw std::invalid_argument("FrameExecutor: input frame does not match the configured format");
+}
+
+FrameExecutor::Job& FrameExecutor::start_job(const FrameHandle& input, FrameHandle output)
+{
+    FrameInfo& info = output.info();
+    info.format = output_;
+    info.sequence = input.info().sequence;
+    info.timestamp_ns = input.info().timestamp_ns;
+    info.host_timestamp_ns = input.info().host_timestamp_ns;
+    info.bytes_used = output_.frame_size();
+
+    Job& job = *jobs_[output.index()];
+    job.input = input;
+    job.output = std::move(output);
+    job.remaining.store(bands_, std::memory_order_relaxed);
+    job.started_ns = monotonic_now_ns();
+    return job;
+}
+
+FrameHandle FrameExecutor::process(const FrameHandle& input)
+{
+    check_input(input);
+    FrameHandle output = pool_.acquire();
+    if (!output)
+        return {};
+    Job& job = start_job(input, std::move(output));
+    threads_->parallel_for(bands_, [this, &job](std::size_t band) { run_band(job, band); });
+    job.input.reset();
+    record(job);
+    return std::move(job.output);
+}
+
+bool FrameExecutor::submit(FrameHandle input)
+{
+    check_input(input);
+    FrameHandle output = pool_.acquire();
+    if (!output) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    Job& job = start_job(input, std::move(output));
+    {
+        std::lock_guard lock(mutex_);
+        ++in_flight_;
+    }
+    for (std::uint32_t band = 0; band < bands_; ++band)
+        threads_->post(&FrameExecutor::run_submitted, &job, band);
+    return true;
+}
+
+void FrameExecutor::wait_idle()
+{
+    std::unique_lock lock(mutex_);
+    idle_.wait(lock, [this] { return in_flight_ == 0; });
+}
+
+void FrameExecutor::run_submitted(void* context, std::size_t band) noexcept
+{
+    auto& job = *static_cast<Job*>(context);
+    job.owner->run_band(job, band);
+    if (job.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        job.owner->finish(job);
+}
+
+void FrameExecutor::finish(Job& job) noexcept
+{
+    job.input.reset();
+    record(job);
+    results_.push(std::move(job.output));
+    // Notify under the lock: the destructor may run as soon as it sees the count drop.
+    std::lock_guard lock(mutex_);
+    --in_flight_;
+    idle_.notify_all();
+}
+
+void FrameExecutor::record(const Job& job) noexcept
+{
+    metrics_.conversion.record(monotonic_now_ns() - job.started_ns);
+    metrics_.frames.fetch_add(1, std::memory_order_relaxed);
+}
+
+ExecutorStats FrameExecutor::stats() const
+{
+    return ExecutorStats{metrics_.conversion.snapshot(), metrics_.frames.load(std::memory_order_relaxed),
+                         dropped_.load(std::memory_order_relaxed)};
+}
+
+void FrameExecutor::run_band(Job& job, std::size_t band) const noexcept
+{
+    const FrameTransform& t = config_.transform;
+    const std::uint32_t first = static_cast<std::uint32_t>(band) * band_rows_;
+    const std::uint32_t last = std::min(first + band_rows_, output_.height);
+    const ConstImageView src = image_view(std::as_const(job.input));
+    const ImageView dst = image_view(job.output);
+
+    if (t.downscale == 1) {
+        convert_rows(src, roi_, dst, first, last, t.convert);
+    } else if (!convert_then_scale_) {
+        const std::size_t offset = roi_.y * src.format.stride + roi_.x * bytes_per_pixel(src.format.format);
+        const ConstImageView cropped{src.data + offset,
+                                     StreamFormat{roi_.width, roi_.height, src.format.format, src.format.stride}};
+        downscale_rows(cropped, dst, t.downscale, first, last);
+    } else {
+        std::byte* strip = job.strips.data() + band * t.downscale * strip_stride_;
+        const ImageView strip_view{strip, StreamFormat{roi_.width, t.downscale, t.output, strip_stride_}};
+        for (std::uint32_t row = first; row < last; ++row) {
+            // Rows of the whole region, so Bayer interpolation reflects only at its edges.
+            const std::uint32_t begin = row * t.downscale;
+            detail::convert_region_rows(src, roi_, t.output, strip, strip_stride_, begin, begin + t.downscale,
+                                        t.convert);
+            const ImageView out_row{dst.data + row * output_.stride,
+                                    StreamFormat{output_.width, 1, output_.format, output_.stride}};
+            downscale_rows(strip_view, out_row, t.downscale, 0, 1);
+        }
+    }
+}
+
+} // namespace camera_interface
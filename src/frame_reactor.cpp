@@ -0,0 +1,141 @@
+#include "camera_interface/frame_reactor.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace camera_interface {
+
+FrameReactor::FrameReactor() = default;
+
+FrameReactor::~FrameReactor()
+{
+    while (!cameras_.empty())
+        detach(*cameras_.back());
+    for (Task::Handle handle : running_)
+        handle.destroy();
+    for (Task::Handle handle : spawned_)
+        handle.destroy();
+}
+
+void FrameReactor::attach(Camera& camera)
+{
+    if (camera.reactor_ == this)
+        return;
+    if (camera.reactor_)
+        throw std::logic_error("FrameReactor::attach: camera is attached to another reactor");
+    const int fd = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), "eventfd");
+    try {
+        poller_.add(fd, EPOLLIN, [this, &camera](std::uint32_t) { wake(camera); });
+        cameras_.push_back(&camera);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    camera.signal_fd_ = fd;
+    camera.reactor_ = this;
+}
+
+void FrameReactor::detach(Camera& camera) noexcept
+{
+    if (camera.reactor_ != this)
+        return;
+    poller_.remove(camera.signal_fd_);
+    ::close(camera.signal_fd_);
+    camera.signal_fd_ = -1;
+    camera.signal_armed_.store(false, std::memory_order_relaxed);
+    camera.waiter_ = {};
+    camera.reactor_ = nullptr;
+    cameras_.erase(std::find(cameras_.begin(), cameras_.end(), &camera));
+}
+
+void FrameReactor::spawn(Task task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        spawned_.push_back(std::exchange(task.handle_, {}));
+    }
+    poller_.wake();
+}
+
+void FrameReactor::run()
+{
+    stop_requested_.store(false, std::memory_order_relaxed);
+    while (!stop_requested_.load(std::memory_order_relaxed) && tasks() != 0)
+        poll(std::chrono::milliseconds(-1));
+}
+
+std::size_t FrameReactor::poll(std::chrono::milliseconds timeout)
+{
+    resumed_ = start_spawned();
+    if (resumed_ != 0)
+        timeout = std::chrono::milliseconds(0);
+    poller_.poll_once(timeout);
+    resumed_ += start_spawned();
+    reap();
+    return resumed_;
+}
+
+void FrameReactor::stop() noexcept
+{
+    stop_requested_.store(true, std::memory_order_relaxed);
+    poller_.wake();
+}
+
+std::size_t FrameReactor::tasks() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_.size() + spawned_.size();
+}
+
+void FrameReactor::wake(Camera& camera) noexcept
+{
+    std::uint64_t count;
+    [[maybe_unused]] const auto n = ::read(camera.signal_fd_, &count, sizeof count);
+    // The signal may be stale: a waiter that found its frame while arming resumes without
+    // suspending, and the wake-up it had armed still arrives later.
+    if (!camera.waiter_ || !camera.arm_waiter())
+        return;
+    ++resumed_;
+    std::exchange(camera.waiter_, {}).resume();
+}
+
+std::size_t FrameReactor::start_spawned()
+{
+    std::vector<Task::Handle> starting;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        starting.swap(spawned_);
+        running_.insert(running_.end(), starting.begin(), starting.end());
+    }
+    for (Task::Handle handle : starting)
+        handle.resume();
+    return starting.size();
+}
+
+void FrameReactor::reap()
+{
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto finished = std::partition(running_.begin(), running_.end(),
+                                             [](Task::Handle handle) { return !handle.done(); });
+        for (auto it = finished; it != running_.end(); ++it) {
+            if (!error)
+                error = it->promise().error;
+            it->destroy();
+        }
+        running_.erase(finished, running_.end());
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+} // namespace camera_interface
@@ -0,0 +1,250 @@
+#include "camera_interface/frame_stats.hpp"
+
+#include "frame_stats_kernels.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace camera_interface {
+
+namespace detail {
+
+void gather_span_scalar(const std::uint8_t* src, std::size_t byte_step, std::uint32_t begin, std::uint32_t count,
+                        std::uint8_t* dst) noexcept
+{
+    for (std::uint32_t i = begin; i < count; ++i)
+        dst[i] = src[i * byte_step];
+}
+
+void cell_span_scalar(const std::uint8_t* top, const std::uint8_t* bottom, std::uint32_t cell_step,
+                      std::uint32_t begin, std::uint32_t count, std::uint8_t* dst) noexcept
+{
+    for (std::uint32_t i = begin; i < count; ++i) {
+        const std::size_t x = std::size_t{i} * cell_step * 2;
+        dst[i] = static_cast<std::uint8_t>((top[x] + top[x + 1] + bottom[x] + bottom[x + 1] + 2) >> 2);
+    }
+}
+
+void laplacian_span_scalar(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                           std::uint32_t begin, std::uint32_t count, LaplacianSums& sums) noexcept
+{
+    for (std::uint32_t i = begin; i + 1 < count; ++i) {
+        const int value = 4 * row[i] - row[i - 1] - row[i + 1] - above[i] - below[i];
+        sums.sum += value;
+        sums.squares += static_cast<std::uint64_t>(value * value);
+    }
+}
+
+namespace {
+
+void gather_row_scalar(const std::uint8_t* src, std::size_t byte_step, std::uint32_t count, std::uint8_t* dst)
+{
+    gather_span_scalar(src, byte_step, 0, count, dst);
+}
+
+void cell_row_scalar(const std::uint8_t* top, const std::uint8_t* bottom, std::uint32_t cell_step,
+                     std::uint32_t count, std::uint8_t* dst)
+{
+    cell_span_scalar(top, bottom, cell_step, 0, count, dst);
+}
+
+void laplacian_row_scalar(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                          std::uint32_t count, LaplacianSums& sums)
+{
+    laplacian_span_scalar(above, row, below, 1, count, sums);
+}
+
+} // namespace
+
+const StatsKernels scalar_stats_kernels = {
+    gather_row_scalar,
+    cell_row_scalar,
+    laplacian_row_scalar,
+};
+
+} // namespace detail
+
+namespace {
+
+const detail::StatsKernels& active_stats_kernels() noexcept
+{
+    switch (active_simd_level()) {
+#if defined(CAMERA_INTERFACE_X86_SIMD)
+    case SimdLevel::avx2: return detail::avx2_stats_kernels;
+    case SimdLevel::sse42: return detail::sse42_stats_kernels;
+#endif
+    default: return detail::scalar_stats_kernels;
+    }
+}
+
+/// Luma of grid row `y`, either straight from the image or gathered into `line`.
+const std::uint8_t* luma_row(const detail::StatsKernels& kernels, const ConstImageView& image,
+                             const FrameStatsConfig& config, std::uint32_t step, std::uint32_t y,
+                             std::uint32_t count, std::uint8_t* line) noexcept
+{
+    const StreamFormat& format = image.format;
+    const auto* row = reinterpret_cast<const std::uint8_t*>(image.data) + std::size_t{y} * format.stride;
+    switch (format.format) {
+    case PixelFormat::mono8:
+    case PixelFormat::nv12:
+    case PixelFormat::i420:
+        if (step == 1)
+            return row;
+        kernels.gather_row(row, step, count, line);
+        return line;
+    case PixelFormat::yuyv:
+    case PixelFormat::uyvy:
+        kernels.gather_row(row + (format.format == PixelFormat::uyvy ? 1 : 0), std::size_t{step} * 2, count, line);
+        return line;
+    case PixelFormat::bayer_rggb8:
+    case PixelFormat::bayer_bggr8:
+    case PixelFormat::bayer_grbg8:
+    case PixelFormat::bayer_gbrg8:
+        kernels.cell_row(row, row + format.stride, step / 2, count, line);
+        return line;
+    case PixelFormat::mono16:
+        for (std::uint32_t i = 0; i < count; ++i) {
+            std::uint16_t value;
+            std::memcpy(&value, row + std::size_t{i} * step * 2, sizeof value);
+            line[i] = static_cast<std::uint8_t>(std::min(value >> config.mono16_shift, 255));
+        }
+        return line;
+    case PixelFormat::rgb8:
+    case PixelFormat::bgr8: {
+        const bool rgb = format.format == PixelFormat::rgb8;
+        for (std::uint32_t i = 0; i < count; ++i) {
+            const std::uint8_t* p = row + std::size_t{i} * step * 3;
+            const int r = rgb ? p[0] : p[2];
+            const int b = rgb ? p[2] : p[0];
+            line[i] = static_cast<std::uint8_t>((77 * r + 150 * p[1] + 29 * b + 128) >> 8);
+        }
+        return line;
+    }
+    }
+    return line;
+}
+
+} // namespace
+
+FrameStatsCollector::FrameStatsCollector(const FrameStatsConfig& config) : config_(config)
+{
+    if (config.step == 0)
+        throw std::invalid_argument("FrameStatsCollector: step must be positive");
+    if (config.mono16_shift > 15)
+        throw std::invalid_argument("FrameStatsCollector: mono16_shift must be at most 15");
+}
+
+bool FrameStatsCollector::collect(const ConstImageView& image, FrameStats& out) noexcept
+{
+    const StreamFormat& format = image.format;
+    const bool bayer = is_bayer(format.format);
+    const std::uint32_t footprint = bayer ? 2 : 1;
+    const std::uint32_t step = bayer ? std::max<std::uint32_t>(2, (config_.step + 1) & ~1u) : config_.step;
+    if (!image.data || format.width < footprint || format.height < footprint)
+        return false;
+    const std::uint32_t cols = (format.width - footprint) / step + 1;
+    const std::uint32_t rows = (format.height - footprint) / step + 1;
+    if (lines_.size() < std::size_t{cols} * 3) {
+        try {
+            lines_.resize(std::size_t{cols} * 3);
+        } catch (...) {
+            return false;
+        }
+    }
+
+    const detail::StatsKernels& kernels = active_stats_kernels();
+    // Four interleaved histograms so consecutive equal samples do not serialise on one counter.
+    std::uint32_t histograms[4][256] = {};
+    detail::LaplacianSums laplacian;
+    const std::uint8_t* window[3] = {}; // Grid rows gy - 2, gy - 1 and gy.
+    for (std::uint32_t gy = 0; gy < rows; ++gy) {
+        std::uint8_t* line = lines_.data() + std::size_t{gy % 3} * cols;
+        const std::uint8_t* luma = luma_row(kernels, image, config_, step, gy * step, cols, line);
+        std::uint32_t i = 0;
+        for (; i + 4 <= cols; i += 4) {
+            ++histograms[0][luma[i]];
+            ++histograms[1][luma[i + 1]];
+            ++histograms[2][luma[i + 2]];
+            ++histograms[3][luma[i + 3]];
+        }
+        for (; i < cols; ++i)
+            ++histograms[0][luma[i]];
+
+        window[0] = window[1];
+        window[1] = window[2];
+        window[2] = luma;
+        if (gy >= 2 && cols >= 3)
+            kernels.laplacian_row(window[0], window[1], window[2], cols, laplacian);
+    }
+
+    // Moments and saturation follow exactly from the histogram.
+    std::uint64_t sum = 0;
+    std::uint64_t squares = 0;
+    std::uint64_t saturated = 0;
+    for (unsigned value = 0; value < 256; ++value) {
+        const std::uint32_t n =
+            histograms[0][value] + histograms[1][value] + histograms[2][value] + histograms[3][value];
+        out.histogram[value] = n;
+        sum += std::uint64_t{n} * value;
+        squares += std::uint64_t{n} * value * value;
+        if (value >= config_.saturation_level)
+            saturated += n;
+    }
+    const std::uint64_t samples = std::uint64_t{cols} * rows;
+    const double mean = static_cast<double>(sum) / static_cast<double>(samples);
+    out.samples = static_cast<std::uint32_t>(samples);
+    out.luma.mean = static_cast<float>(mean);
+    out.luma.variance = static_cast<float>(std::max(0.0, static_cast<double>(squares) / samples - mean * mean));
+    out.luma.saturated = static_cast<float>(100.0 * static_cast<double>(saturated) / static_cast<double>(samples));
+    out.luma.focus = 0.0f;
+    if (cols >= 3 && rows >= 3) {
+        const double interior = static_cast<double>(cols - 2) * (rows - 2);
+        const double laplacian_mean = static_cast<double>(laplacian.sum) / interior;
+        out.luma.focus = static_cast<float>(
+            std::max(0.0, static_cast<double>(laplacian.squares) / interior - laplacian_mean * laplacian_mean));
+    }
+    return true;
+}
+
+FrameStats compute_frame_stats(const ConstImageView& image, const FrameStatsConfig& config)
+{
+    FrameStatsCollector collector(config);
+    FrameStats stats;
+    if (!collector.collect(image, stats))
+        throw std::invalid_argument("compute_frame_stats: image too small to sample");
+    return stats;
+}
+
+void LatestFrameStats::publish(const FrameStats& stats) noexcept
+{
+    std::uint64_t raw[kWords] = {};
+    std::memcpy(raw, &stats, sizeof stats);
+    const std::uint64_t version = version_.load(std::memory_order_relaxed);
+    version_.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < kWords; ++i)
+        words_[i].store(raw[i], std::memory_order_relaxed);
+    version_.store(version + 2, std::memory_order_release);
+}
+
+bool LatestFrameStats::read(FrameStats& out) const noexcept
+{
+    std::uint64_t raw[kWords];
+    for (;;) {
+        const std::uint64_t before = version_.load(std::memory_order_acquire);
+        if (before == 0)
+            return false;
+        if (before & 1)
+            continue;
+        for (std::size_t i = 0; i < kWords; ++i)
+            raw[i] = words_[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (version_.load(std::memory_order_relaxed) == before)
+            break;
+    }
+    std::memcpy(&out, raw, sizeof out);
+    return true;
+}
+
+} // namespace camera_interface
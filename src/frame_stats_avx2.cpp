@@ -0,0 +1,125 @@
+// Compiled with -mavx2; only reached when the CPU and OS report AVX2.
+
+#include "frame_stats_kernels.hpp"
+
+#include <immintrin.h>
+
+namespace camera_interface::detail {
+
+namespace {
+
+__m256i load(const std::uint8_t* p)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+void gather_row(const std::uint8_t* src, std::size_t byte_step, std::uint32_t count, std::uint8_t* dst)
+{
+    // Every load stays below the last sample's byte, so nothing past the row is read.
+    std::uint32_t i = 0;
+    if (byte_step == 2) {
+        const __m256i low = _mm256_set1_epi16(0x00ff);
+        for (; i + 33 <= count; i += 32) {
+            const std::uint8_t* p = src + std::size_t{i} * 2;
+            const __m256i a = _mm256_and_si256(load(p), low);
+            const __m256i b = _mm256_and_si256(load(p + 32), low);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                                _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8));
+        }
+    } else if (byte_step == 4) {
+        const __m256i low = _mm256_set1_epi32(0xff);
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        for (; i + 33 <= count; i += 32) {
+            const std::uint8_t* p = src + std::size_t{i} * 4;
+            const __m256i ab =
+                _mm256_packus_epi32(_mm256_and_si256(load(p), low), _mm256_and_si256(load(p + 32), low));
+            const __m256i cd =
+                _mm256_packus_epi32(_mm256_and_si256(load(p + 64), low), _mm256_and_si256(load(p + 96), low));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                                _mm256_permutevar8x32_epi32(_mm256_packus_epi16(ab, cd), order));
+        }
+    }
+    gather_span_scalar(src, byte_step, i, count, dst);
+}
+
+/// Rounded 2x2 means of 16 adjacent cells, one per 16-bit lane.
+__m256i cell_means(const std::uint8_t* top, const std::uint8_t* bottom)
+{
+    const __m256i ones = _mm256_set1_epi8(1);
+    const __m256i sums =
+        _mm256_add_epi16(_mm256_maddubs_epi16(load(top), ones), _mm256_maddubs_epi16(load(bottom), ones));
+    return _mm256_srli_epi16(_mm256_add_epi16(sums, _mm256_set1_epi16(2)), 2);
+}
+
+void cell_row(const std::uint8_t* top, const std::uint8_t* bottom, std::uint32_t cell_step, std::uint32_t count,
+              std::uint8_t* dst)
+{
+    std::uint32_t i = 0;
+    if (cell_step == 1) {
+        for (; i + 32 <= count; i += 32) {
+            const std::size_t x = std::size_t{i} * 2;
+            const __m256i a = cell_means(top + x, bottom + x);
+            const __m256i b = cell_means(top + x + 32, bottom + x + 32);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                                _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8));
+        }
+    } else if (cell_step == 2) {
+        // Every other cell: keep the even 16-bit lanes.
+        const __m256i even = _mm256_set1_epi32(0xffff);
+        const auto every_other = [&](std::size_t x) {
+            const __m256i a = _mm256_and_si256(cell_means(top + x, bottom + x), even);
+            const __m256i b = _mm256_and_si256(cell_means(top + x + 32, bottom + x + 32), even);
+            return _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xd8);
+        };
+        for (; i + 33 <= count; i += 32) {
+            const std::size_t x = std::size_t{i} * 4;
+            const __m256i packed = _mm256_packus_epi16(every_other(x), every_other(x + 64));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_permute4x64_epi64(packed, 0xd8));
+        }
+    }
+    cell_span_scalar(top, bottom, cell_step, i, count, dst);
+}
+
+__m256i widen(const std::uint8_t* p)
+{
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+
+void laplacian_row(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                   std::uint32_t count, LaplacianSums& sums)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    std::uint32_t i = 1;
+    while (i + 17 <= count) {
+        // Each 32-bit lane gains at most 2 * 1020^2 per step; flush well before it can wrap.
+        __m256i sum = _mm256_setzero_si256();
+        __m256i squares = _mm256_setzero_si256();
+        for (int n = 0; n < 512 && i + 17 <= count; ++n, i += 16) {
+            const __m256i centre = _mm256_slli_epi16(widen(row + i), 2);
+            const __m256i neighbours = _mm256_add_epi16(_mm256_add_epi16(widen(row + i - 1), widen(row + i + 1)),
+                                                        _mm256_add_epi16(widen(above + i), widen(below + i)));
+            const __m256i value = _mm256_sub_epi16(centre, neighbours);
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(value, ones));
+            squares = _mm256_add_epi32(squares, _mm256_madd_epi16(value, value));
+        }
+        alignas(32) std::int32_t signed_lanes[8];
+        alignas(32) std::uint32_t unsigned_lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(signed_lanes), sum);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(unsigned_lanes), squares);
+        for (int lane = 0; lane < 8; ++lane) {
+            sums.sum += signed_lanes[lane];
+            sums.squares += unsigned_lanes[lane];
+        }
+    }
+    laplacian_span_scalar(above, row, below, i, count, sums);
+}
+
+} // namespace
+
+const StatsKernels avx2_stats_kernels = {
+    gather_row,
+    cell_row,
+    laplacian_row,
+};
+
+} // namespace camera_interface::detail
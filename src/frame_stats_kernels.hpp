@@ -0,0 +1,48 @@
+#pragma once
+
+// Row kernels behind FrameStatsCollector, one table per instruction set, following the same
+// rules as convert_kernels.hpp: the scalar span functions are the reference and handle the
+// tails of the SIMD versions, which must produce identical results.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace camera_interface::detail {
+
+/// Laplacian sums over the interior of a frame's sample grid.
+struct LaplacianSums {
+    std::int64_t sum = 0;
+    std::uint64_t squares = 0;
+};
+
+/// dst[i] = src[i * byte_step] for i in [0, count).
+using GatherRowFn = void (*)(const std::uint8_t* src, std::size_t byte_step, std::uint32_t count,
+                             std::uint8_t* dst);
+/// dst[i] = rounded mean of the 2x2 cell at column i * cell_step * 2 of rows `top` and `bottom`.
+using CellRowFn = void (*)(const std::uint8_t* top, const std::uint8_t* bottom, std::uint32_t cell_step,
+                           std::uint32_t count, std::uint8_t* dst);
+/// Accumulates 4 * row[i] - row[i - 1] - row[i + 1] - above[i] - below[i] for i in [1, count - 1).
+using LaplacianRowFn = void (*)(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                                std::uint32_t count, LaplacianSums& sums);
+
+struct StatsKernels {
+    GatherRowFn gather_row;
+    CellRowFn cell_row;
+    LaplacianRowFn laplacian_row;
+};
+
+extern const StatsKernels scalar_stats_kernels;
+#if defined(CAMERA_INTERFACE_X86_SIMD)
+extern const StatsKernels sse42_stats_kernels;
+extern const StatsKernels avx2_stats_kernels;
+#endif
+
+void gather_span_scalar(const std::uint8_t* src, std::size_t byte_step, std::uint32_t begin, std::uint32_t count,
+                        std::uint8_t* dst) noexcept;
+void cell_span_scalar(const std::uint8_t* top, const std::uint8_t* bottom, std::uint32_t cell_step,
+                      std::uint32_t begin, std::uint32_t count, std::uint8_t* dst) noexcept;
+/// `begin` must be at least 1.
+void laplacian_span_scalar(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                           std::uint32_t begin, std::uint32_t count, LaplacianSums& sums) noexcept;
+
+} // namespace camera_interface::detail
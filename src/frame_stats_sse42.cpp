@@ -0,0 +1,116 @@
+// Compiled with -msse4.2; only reached when the CPU reports SSE4.2.
+
+#include "frame_stats_kernels.hpp"
+
+#include <immintrin.h>
+
+namespace camera_interface::detail {
+
+namespace {
+
+__m128i load(const std::uint8_t* p)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+void gather_row(const std::uint8_t* src, std::size_t byte_step, std::uint32_t count, std::uint8_t* dst)
+{
+    // Every load stays below the last sample's byte, so nothing past the row is read.
+    std::uint32_t i = 0;
+    if (byte_step == 2) {
+        const __m128i low = _mm_set1_epi16(0x00ff);
+        for (; i + 17 <= count; i += 16) {
+            const std::uint8_t* p = src + std::size_t{i} * 2;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                             _mm_packus_epi16(_mm_and_si128(load(p), low), _mm_and_si128(load(p + 16), low)));
+        }
+    } else if (byte_step == 4) {
+        const __m128i low = _mm_set1_epi32(0xff);
+        for (; i + 17 <= count; i += 16) {
+            const std::uint8_t* p = src + std::size_t{i} * 4;
+            const __m128i ab = _mm_packus_epi32(_mm_and_si128(load(p), low), _mm_and_si128(load(p + 16), low));
+            const __m128i cd = _mm_packus_epi32(_mm_and_si128(load(p + 32), low), _mm_and_si128(load(p + 48), low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(ab, cd));
+        }
+    }
+    gather_span_scalar(src, byte_step, i, count, dst);
+}
+
+/// Rounded 2x2 means of 8 adjacent cells, one per 16-bit lane.
+__m128i cell_means(const std::uint8_t* top, const std::uint8_t* bottom)
+{
+    const __m128i ones = _mm_set1_epi8(1);
+    const __m128i sums = _mm_add_epi16(_mm_maddubs_epi16(load(top), ones), _mm_maddubs_epi16(load(bottom), ones));
+    return _mm_srli_epi16(_mm_add_epi16(sums, _mm_set1_epi16(2)), 2);
+}
+
+void cell_row(const std::uint8_t* top, const std::uint8_t* bottom, std::uint32_t cell_step, std::uint32_t count,
+              std::uint8_t* dst)
+{
+    std::uint32_t i = 0;
+    if (cell_step == 1) {
+        for (; i + 16 <= count; i += 16) {
+            const std::size_t x = std::size_t{i} * 2;
+            const __m128i packed =
+                _mm_packus_epi16(cell_means(top + x, bottom + x), cell_means(top + x + 16, bottom + x + 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), packed);
+        }
+    } else if (cell_step == 2) {
+        // Every other cell: keep the even 16-bit lanes.
+        const __m128i even = _mm_set1_epi32(0xffff);
+        const auto every_other = [&](std::size_t x) {
+            return _mm_packus_epi32(_mm_and_si128(cell_means(top + x, bottom + x), even),
+                                    _mm_and_si128(cell_means(top + x + 16, bottom + x + 16), even));
+        };
+        for (; i + 17 <= count; i += 16) {
+            const std::size_t x = std::size_t{i} * 4;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                             _mm_packus_epi16(every_other(x), every_other(x + 32)));
+        }
+    }
+    cell_span_scalar(top, bottom, cell_step, i, count, dst);
+}
+
+__m128i widen(const std::uint8_t* p)
+{
+    return _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+
+void laplacian_row(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                   std::uint32_t count, LaplacianSums& sums)
+{
+    const __m128i ones = _mm_set1_epi16(1);
+    std::uint32_t i = 1;
+    while (i + 9 <= count) {
+        // Each 32-bit lane gains at most 2 * 1020^2 per step; flush well before it can wrap.
+        __m128i sum = _mm_setzero_si128();
+        __m128i squares = _mm_setzero_si128();
+        for (int n = 0; n < 512 && i + 9 <= count; ++n, i += 8) {
+            const __m128i centre = _mm_slli_epi16(widen(row + i), 2);
+            const __m128i neighbours = _mm_add_epi16(_mm_add_epi16(widen(row + i - 1), widen(row + i + 1)),
+                                                     _mm_add_epi16(widen(above + i), widen(below + i)));
+            const __m128i value = _mm_sub_epi16(centre, neighbours);
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(value, ones));
+            squares = _mm_add_epi32(squares, _mm_madd_epi16(value, value));
+        }
+        alignas(16) std::int32_t signed_lanes[4];
+        alignas(16) std::uint32_t unsigned_lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(signed_lanes), sum);
+        _mm_store_si128(reinterpret_cast<__m128i*>(unsigned_lanes), squares);
+        for (int lane = 0; lane < 4; ++lane) {
+            sums.sum += signed_lanes[lane];
+            sums.squares += unsigned_lanes[lane];
+        }
+    }
+    laplacian_span_scalar(above, row, below, i, count, sums);
+}
+
+} // namespace
+
+const StatsKernels sse42_stats_kernels = {
+    gather_row,
+    cell_row,
+    laplacian_row,
+};
+
+} // namespace camera_interface::detail
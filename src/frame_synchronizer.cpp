@@ -0,0 +1,102 @@
+#include "camera_interface/frame_synchronizer.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace camera_interface {
+
+void FrameSynchronizer::Lane::push(FrameHandle frame)
+{
+    slots[(head + size) % slots.size()] = std::move(frame);
+    ++size;
+}
+
+FrameHandle FrameSynchronizer::Lane::pop()
+{
+    FrameHandle frame = std::move(slots[head]);
+    head = (head + 1) % slots.size();
+    --size;
+    return frame;
+}
+
+FrameSynchronizer::FrameSynchronizer(const SynchronizerConfig& config)
+    : tolerance_ns_(config.tolerance.count()), lanes_(config.streams),
+      bundles_(config.output_depth, OverflowPolicy::drop_oldest)
+{
+    if (config.streams == 0 || config.streams > kMaxSyncStreams)
+        throw std::invalid_argument("FrameSynchronizer: stream count out of range");
+    if (config.stream_depth == 0)
+        throw std::invalid_argument("FrameSynchronizer: stream_depth must be non-zero");
+    if (tolerance_ns_ < 0)
+        throw std::invalid_argument("FrameSynchronizer: negative tolerance");
+    for (Lane& lane : lanes_)
+        lane.slots.resize(config.stream_depth);
+}
+
+void FrameSynchronizer::push(std::size_t stream, FrameHandle frame)
+{
+    if (!frame)
+        return;
+    Lane& lane = lanes_.at(stream);
+    if (lane.size == lane.slots.size()) {
+        lane.pop();
+        overflow_.fetch_add(1, std::memory_order_relaxed);
+    }
+    lane.push(std::move(frame));
+    match();
+}
+
+std::size_t FrameSynchronizer::drain(std::span<Camera* const> cameras)
+{
+    std::size_t taken = 0;
+    const std::size_t count = std::min(cameras.size(), lanes_.size());
+    for (std::size_t i = 0; i < count; ++i) {
+        while (FrameHandle frame = cameras[i]->try_grab()) {
+            push(i, std::move(frame));
+            ++taken;
+        }
+    }
+    return taken;
+}
+
+void FrameSynchronizer::match()
+{
+    for (;;) {
+        std::int64_t reference = std::numeric_limits<std::int64_t>::min();
+        for (Lane& lane : lanes_) {
+            if (lane.size == 0)
+                return;
+            reference = std::max(reference, lane.timestamp(0));
+        }
+
+        bool dropped = false;
+        for (Lane& lane : lanes_) {
+            while (lane.size > 0
+                   && (lane.timestamp(0) < reference - tolerance_ns_
+                       || (lane.size > 1 && lane.timestamp(1) <= reference))) {
+                lane.pop();
+                stale_.fetch_add(1, std::memory_order_relaxed);
+                dropped = true;
+            }
+        }
+        // Dropping may have exposed a newer head (and so a new reference); re-evaluate.
+        if (dropped)
+            continue;
+
+        FrameBundle bundle;
+        bundle.count = lanes_.size();
+        std::int64_t earliest = reference;
+        for (std::size_t i = 0; i < lanes_.size(); ++i) {
+            earliest = std::min(earliest, lanes_[i].timestamp(0));
+            bundle.frames[i] = lanes_[i].pop();
+        }
+        bundle.timestamp_ns = earliest;
+        bundle.spread_ns = reference - earliest;
+        bundles_.push(std::move(bundle));
+        emitted_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace camera_interface
@@ -0,0 +1,123 @@
+#include "io_uring.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace camera_interface::detail {
+
+namespace {
+
+template <typename T>
+T* at(void* base, std::uint32_t offset) noexcept
+{
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+void* map_ring(int fd, std::size_t size, std::uint64_t offset) noexcept
+{
+    void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                     static_cast<off_t>(offset));
+    return p == MAP_FAILED ? nullptr : p;
+}
+
+} // namespace
+
+std::unique_ptr<IoUring> IoUring::create(unsigned entries) noexcept
+{
+    io_uring_params params{};
+    const int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0)
+        return nullptr;
+
+    std::unique_ptr<IoUring> ring(new (std::nothrow) IoUring);
+    if (!ring) {
+        ::close(fd);
+        return nullptr;
+    }
+    ring->fd_ = fd;
+    ring->sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    ring->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sq_ring_ = map_ring(fd, ring->sq_ring_size_, IORING_OFF_SQ_RING);
+    ring->cq_ring_ = map_ring(fd, ring->cq_ring_size_, IORING_OFF_CQ_RING);
+    ring->sqes_ = static_cast<io_uring_sqe*>(map_ring(fd, ring->sqes_size_, IORING_OFF_SQES));
+    if (!ring->sq_ring_ || !ring->cq_ring_ || !ring->sqes_)
+        return nullptr;
+
+    // The kernel shares these words with us; std::atomic<unsigned> has the same layout.
+    ring->sq_head_ = at<std::atomic<unsigned>>(ring->sq_ring_, params.sq_off.head);
+    ring->sq_tail_ = at<std::atomic<unsigned>>(ring->sq_ring_, params.sq_off.tail);
+    ring->sq_mask_ = *at<unsigned>(ring->sq_ring_, params.sq_off.ring_mask);
+    ring->sq_entries_ = params.sq_entries;
+    ring->sq_array_ = at<unsigned>(ring->sq_ring_, params.sq_off.array);
+    ring->cq_head_ = at<std::atomic<unsigned>>(ring->cq_ring_, params.cq_off.head);
+    ring->cq_tail_ = at<std::atomic<unsigned>>(ring->cq_ring_, params.cq_off.tail);
+    ring->cq_mask_ = *at<unsigned>(ring->cq_ring_, params.cq_off.ring_mask);
+    ring->cqes_ = at<io_uring_cqe>(ring->cq_ring_, params.cq_off.cqes);
+    return ring;
+}
+
+IoUring::~IoUring()
+{
+    if (sqes_)
+        ::munmap(sqes_, sqes_size_);
+    if (cq_ring_)
+        ::munmap(cq_ring_, cq_ring_size_);
+    if (sq_ring_)
+        ::munmap(sq_ring_, sq_ring_size_);
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+bool IoUring::prepare_writev(int fd, const iovec* iov, unsigned count, std::uint64_t offset,
+                             std::uint64_t user_data) noexcept
+{
+    const unsigned tail = sq_tail_->load(std::memory_order_relaxed);
+    if (tail - sq_head_->load(std::memory_order_acquire) >= sq_entries_)
+        return false;
+    const unsigned index = tail & sq_mask_;
+    io_uring_sqe& sqe = sqes_[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_WRITEV;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uint64_t>(iov);
+    sqe.len = count;
+    sqe.off = offset;
+    sqe.user_data = user_data;
+    sq_array_[index] = index;
+    sq_tail_->store(tail + 1, std::memory_order_release);
+    ++pending_;
+    return true;
+}
+
+bool IoUring::submit(unsigned wait_for) noexcept
+{
+    const unsigned flags = wait_for > 0 ? IORING_ENTER_GETEVENTS : 0;
+    for (;;) {
+        const long submitted = ::syscall(__NR_io_uring_enter, fd_, pending_, wait_for, flags, nullptr, 0);
+        if (submitted >= 0) {
+            pending_ -= static_cast<unsigned>(submitted);
+            return true;
+        }
+        if (errno != EINTR)
+            return false;
+    }
+}
+
+bool IoUring::pop_completion(std::uint64_t& user_data, std::int32_t& result) noexcept
+{
+    const unsigned head = cq_head_->load(std::memory_order_relaxed);
+    if (head == cq_tail_->load(std::memory_order_acquire))
+        return false;
+    const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+    user_data = cqe.user_data;
+    result = cqe.res;
+    cq_head_->store(head + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace camera_interface::detail
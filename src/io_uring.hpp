@@ -0,0 +1,62 @@
+#pragma once
+
+// Minimal io_uring submission/completion rings on raw syscalls, enough for the recorder's
+// vectored writes. liburing is deliberately not required.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include <linux/io_uring.h>
+#include <sys/uio.h>
+
+namespace camera_interface::detail {
+
+class IoUring {
+public:
+    /// Returns null when the kernel (or a seccomp policy) does not allow io_uring.
+    static std::unique_ptr<IoUring> create(unsigned entries) noexcept;
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /// Queues a writev; false when the submission ring is full. Nothing reaches the kernel
+    /// until `submit()`.
+    bool prepare_writev(int fd, const iovec* iov, unsigned count, std::uint64_t offset,
+                        std::uint64_t user_data) noexcept;
+
+    /// Submits everything prepared and waits for at least `wait_for` completions.
+    /// Returns false with errno set on failure.
+    bool submit(unsigned wait_for) noexcept;
+
+    /// Takes one completion if available.
+    bool pop_completion(std::uint64_t& user_data, std::int32_t& result) noexcept;
+
+private:
+    IoUring() = default;
+
+    int fd_ = -1;
+    unsigned pending_ = 0;
+
+    void* sq_ring_ = nullptr;
+    std::size_t sq_ring_size_ = 0;
+    void* cq_ring_ = nullptr;
+    std::size_t cq_ring_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    std::size_t sqes_size_ = 0;
+
+    std::atomic<unsigned>* sq_head_ = nullptr;
+    std::atomic<unsigned>* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned* sq_array_ = nullptr;
+
+    std::atomic<unsigned>* cq_head_ = nullptr;
+    std::atomic<unsigned>* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+};
+
+} // namespace camera_interface::detail
@@ -0,0 +1,160 @@
+#include "camera_interface/metadata_log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace camera_interface {
+
+namespace {
+
+template <typename T>
+std::unique_ptr<std::atomic<T>[]> make_column(std::size_t capacity)
+{
+    return std::make_unique<std::atomic<T>[]>(capacity);
+}
+
+} // namespace
+
+MetadataLog::MetadataLog(std::size_t capacity)
+{
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+        throw std::invalid_argument("MetadataLog: capacity must be a power of two >= 2");
+    mask_ = capacity - 1;
+    sequence_ = make_column<std::uint64_t>(capacity);
+    sensor_ns_ = make_column<std::int64_t>(capacity);
+    host_ns_ = make_column<std::int64_t>(capacity);
+    exposure_us_ = make_column<std::uint32_t>(capacity);
+    gain_ = make_column<float>(capacity);
+    drops_ = make_column<std::uint64_t>(capacity);
+    luma_mean_ = make_column<float>(capacity);
+    saturated_ = make_column<float>(capacity);
+    focus_ = make_column<float>(capacity);
+}
+
+void MetadataLog::append(const FrameInfo& info) noexcept
+{
+    // Seqlock-style: announce the slot before overwriting it, so a reader that may have seen
+    // part of the new entry also sees the announcement and discards the old one.
+    const std::uint64_t n = head_.load(std::memory_order_relaxed);
+    writing_.store(n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const std::size_t slot = n & mask_;
+    sequence_[slot].store(info.sequence, std::memory_order_relaxed);
+    sensor_ns_[slot].store(info.timestamp_ns, std::memory_order_relaxed);
+    host_ns_[slot].store(info.host_timestamp_ns, std::memory_order_relaxed);
+    exposure_us_[slot].store(info.exposure_us, std::memory_order_relaxed);
+    gain_[slot].store(info.gain, std::memory_order_relaxed);
+    drops_[slot].store(info.drops, std::memory_order_relaxed);
+    luma_mean_[slot].store(info.luma.mean, std::memory_order_relaxed);
+    saturated_[slot].store(info.luma.saturated, std::memory_order_relaxed);
+    focus_[slot].store(info.luma.focus, std::memory_order_relaxed);
+    head_.store(n + 1, std::memory_order_release);
+}
+
+MetadataSnapshot MetadataLog::snapshot(std::size_t max_entries) const
+{
+    const std::uint64_t head = head_.load(std::memory_order_acquire);
+    const std::uint64_t available = std::min<std::uint64_t>({head, capacity(), max_entries});
+    return copy(head - available, head);
+}
+
+MetadataSnapshot MetadataLog::since(std::uint64_t from) const
+{
+    const std::uint64_t head = head_.load(std::memory_order_acquire);
+    const std::uint64_t oldest = head > capacity() ? head - capacity() : 0;
+    return copy(std::clamp(from, oldest, head), head);
+}
+
+MetadataSnapshot MetadataLog::copy(std::uint64_t from, std::uint64_t to) const
+{
+    MetadataSnapshot out;
+    const auto n = static_cast<std::size_t>(to - from);
+    out.sequence.resize(n);
+    out.sensor_ns.resize(n);
+    out.host_ns.resize(n);
+    out.exposure_us.resize(n);
+    out.gain.resize(n);
+    out.drops.resize(n);
+    out.luma_mean.resize(n);
+    out.saturated.resize(n);
+    out.focus.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t slot = (from + i) & mask_;
+        out.sequence[i] = sequence_[slot].load(std::memory_order_relaxed);
+        out.sensor_ns[i] = sensor_ns_[slot].load(std::memory_order_relaxed);
+        out.host_ns[i] = host_ns_[slot].load(std::memory_order_relaxed);
+        out.exposure_us[i] = exposure_us_[slot].load(std::memory_order_relaxed);
+        out.gain[i] = gain_[slot].load(std::memory_order_relaxed);
+        out.drops[i] = drops_[slot].load(std::memory_order_relaxed);
+        out.luma_mean[i] = luma_mean_[slot].load(std::memory_order_relaxed);
+        out.saturated[i] = saturated_[slot].load(std::memory_order_relaxed);
+        out.focus[i] = focus_[slot].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // Anything the writer started on after we read `to` may have replaced the oldest entries.
+    const std::uint64_t writing = writing_.load(std::memory_order_relaxed);
+    const std::uint64_t valid_from = writing > capacity() ? writing - capacity() : 0;
+    const auto torn = static_cast<std::size_t>(std::min<std::uint64_t>(n, valid_from > from ? valid_from - from : 0));
+    if (torn != 0) {
+        const auto trim = [torn](auto& column) { column.erase(column.begin(), column.begin() + torn); };
+        trim(out.sequence);
+        trim(out.sensor_ns);
+        trim(out.host_ns);
+        trim(out.exposure_us);
+        trim(out.gain);
+        trim(out.drops);
+        trim(out.luma_mean);
+        trim(out.saturated);
+        trim(out.focus);
+    }
+    out.first = from + torn;
+    return out;
+}
+
+JitterStats analyze_jitter(std::span<const std::int64_t> timestamps) noexcept
+{
+    JitterStats stats;
+    if (timestamps.size() < 2)
+        return stats;
+    stats.intervals = timestamps.size() - 1;
+    stats.min_ns = std::numeric_limits<std::int64_t>::max();
+    stats.max_ns = std::numeric_limits<std::int64_t>::min();
+    double sum = 0.0;
+    for (std::size_t i = 1; i < timestamps.size(); ++i) {
+        const std::int64_t interval = timestamps[i] - timestamps[i - 1];
+        stats.min_ns = std::min(stats.min_ns, interval);
+        stats.max_ns = std::max(stats.max_ns, interval);
+        sum += static_cast<double>(interval);
+    }
+    stats.mean_ns = sum / static_cast<double>(stats.intervals);
+    double squares = 0.0;
+    for (std::size_t i = 1; i < timestamps.size(); ++i) {
+        const double deviation = static_cast<double>(timestamps[i] - timestamps[i - 1]) - stats.mean_ns;
+        squares += deviation * deviation;
+        stats.max_deviation_ns = std::max(stats.max_deviation_ns, std::abs(deviation));
+    }
+    stats.stddev_ns = std::sqrt(squares / static_cast<double>(stats.intervals));
+    return stats;
+}
+
+JitterStats analyze_jitter(const MetadataSnapshot& snapshot, bool host_clock) noexcept
+{
+    JitterStats stats = analyze_jitter(host_clock ? snapshot.host_ns : snapshot.sensor_ns);
+    for (std::size_t i = 1; i < snapshot.size(); ++i)
+        if (snapshot.sequence[i] > snapshot.sequence[i - 1] + 1)
+            stats.sequence_gaps += snapshot.sequence[i] - snapshot.sequence[i - 1] - 1;
+    if (!snapshot.empty()) {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < snapshot.size(); ++i) {
+            const std::int64_t delay = snapshot.host_ns[i] - snapshot.sensor_ns[i];
+            sum += static_cast<double>(delay);
+            stats.max_host_delay_ns = i == 0 ? delay : std::max(stats.max_host_delay_ns, delay);
+        }
+        stats.mean_host_delay_ns = sum / static_cast<double>(snapshot.size());
+    }
+    return stats;
+}
+
+} // namespace camera_interface
@@ -0,0 +1,264 @@
+#include "camera_interface/metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cmath>
+
+namespace camera_interface {
+
+namespace {
+
+constexpr std::uint64_t kSubBuckets = std::uint64_t{1} << LatencyHistogram::kSubBucketBits;
+
+constexpr double kLatencyBounds[] = {
+    10e-6, 20e-6, 50e-6, 100e-6, 200e-6, 500e-6, 1e-3, 2e-3, 5e-3, 10e-3,
+    20e-3, 50e-3, 100e-3, 200e-3, 500e-3, 1.0, 2.0, 5.0, 10.0,
+};
+
+constexpr double kDepthBounds[] = {0, 1, 2, 4, 8, 16, 32, 64, 128, 256};
+
+void append_number(std::string& out, double value)
+{
+    if (std::isinf(value)) {
+        out += value > 0 ? "+Inf" : "-Inf";
+        return;
+    }
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void append_label_value(std::string& out, std::string_view value)
+{
+    for (const char c : value) {
+        switch (c) {
+        case '\\': out += "\\\\"; break;
+        case '"': out += "\\\""; break;
+        case '\n': out += "\\n"; break;
+        default: out += c; break;
+        }
+    }
+}
+
+/// `name{labels,extra}` with the label set omitted entirely when empty.
+void append_series(std::string& out, std::string_view name, std::span<const PrometheusText::Label> labels,
+                   std::string_view extra_key = {}, std::string_view extra_value = {})
+{
+    out += name;
+    if (labels.empty() && extra_key.empty())
+        return;
+    out += '{';
+    bool first = true;
+    const auto add = [&](std::string_view key, std::string_view value) {
+        if (!first)
+            out += ',';
+        first = false;
+        out += key;
+        out += "=\"";
+        append_label_value(out, value);
+        out += '"';
+    };
+    for (const auto& [key, value] : labels)
+        add(key, value);
+    if (!extra_key.empty())
+        add(extra_key, extra_value);
+    out += '}';
+}
+
+void append_sample(std::string& out, std::string_view name, std::span<const PrometheusText::Label> labels,
+                   double value, std::string_view extra_key = {}, std::string_view extra_value = {})
+{
+    append_series(out, name, labels, extra_key, extra_value);
+    out += ' ';
+    append_number(out, value);
+    out += '\n';
+}
+
+} // namespace
+
+double HistogramSnapshot::mean() const noexcept
+{
+    return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+}
+
+std::uint64_t HistogramSnapshot::percentile(double percent) const noexcept
+{
+    if (count == 0)
+        return 0;
+    const double clamped = std::clamp(percent, 0.0, 100.0);
+    const auto rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(count))));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank)
+            return std::clamp(LatencyHistogram::bucket_upper(i), min, max);
+    }
+    return max;
+}
+
+std::uint64_t HistogramSnapshot::count_at_or_below(std::uint64_t value) const noexcept
+{
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < buckets.size() && LatencyHistogram::bucket_upper(i) <= value; ++i)
+        total += buckets[i];
+    return total;
+}
+
+std::size_t LatencyHistogram::bucket_index(std::uint64_t value) noexcept
+{
+    if (value < kLinearBuckets)
+        return static_cast<std::size_t>(value);
+    const unsigned exponent = static_cast<unsigned>(std::bit_width(value)) - 1;
+    if (exponent >= kMaxExponent)
+        return kBucketCount - 1;
+    const std::uint64_t sub = (value >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+    return kLinearBuckets + (exponent - kSubBucketBits - 1) * kSubBuckets + sub;
+}
+
+std::uint64_t LatencyHistogram::bucket_upper(std::size_t index) noexcept
+{
+    if (index < kLinearBuckets)
+        return index;
+    const std::size_t group = (index - kLinearBuckets) / kSubBuckets;
+    const std::uint64_t sub = (index - kLinearBuckets) % kSubBuckets;
+    const unsigned shift = static_cast<unsigned>(group) + 1;
+    return ((kSubBuckets + sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(std::int64_t value) noexcept
+{
+    const std::uint64_t v = value > 0 ? static_cast<std::uint64_t>(value) : 0;
+    buckets_[bucket_index(v)].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(v, std::memory_order_relaxed);
+    std::uint64_t current = min_.load(std::memory_order_relaxed);
+    while (v < current && !min_.compare_exchange_weak(current, v, std::memory_order_relaxed)) {
+    }
+    current = max_.load(std::memory_order_relaxed);
+    while (v > current && !max_.compare_exchange_weak(current, v, std::memory_order_relaxed)) {
+    }
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const
+{
+    HistogramSnapshot snapshot;
+    snapshot.buckets.resize(kBucketCount);
+    // The count is summed from the copied buckets so percentiles always add up, even while
+    // other threads keep recording.
+    for (std::size_t i = 0; i < kBucketCount; ++i) {
+        snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[i];
+    }
+    snapshot.sum = sum_.load(std::memory_order_relaxed);
+    if (snapshot.count != 0) {
+        snapshot.min = min_.load(std::memory_order_relaxed);
+        snapshot.max = max_.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+void LatencyHistogram::reset() noexcept
+{
+    for (auto& bucket : buckets_)
+        bucket.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+PrometheusText::Family& PrometheusText::family(std::string_view name, std::string_view help, std::string_view type)
+{
+    for (Family& family : families_)
+        if (family.name == name)
+            return family;
+    return families_.emplace_back(Family{std::string(name), std::string(help), std::string(type), {}});
+}
+
+void PrometheusText::counter(std::string_view name, std::string_view help, std::span<const Label> labels,
+                             double value)
+{
+    append_sample(family(name, help, "counter").samples, name, labels, value);
+}
+
+void PrometheusText::gauge(std::string_view name, std::string_view help, std::span<const Label> labels, double value)
+{
+    append_sample(family(name, help, "gauge").samples, name, labels, value);
+}
+
+void PrometheusText::histogram(std::string_view name, std::string_view help, std::span<const Label> labels,
+                               const HistogramSnapshot& snapshot, std::span<const double> bounds, double scale)
+{
+    std::string& out = family(name, help, "histogram").samples;
+    const std::string bucket_name = std::string(name) + "_bucket";
+    std::string le;
+    for (const double bound : bounds) {
+        // A bucket only counts toward `le` when all of it lies at or below the bound, so
+        // cumulative counts are exact to bucket precision and never overstate.
+        const double raw = bound / scale;
+        const std::uint64_t limit = raw >= 0x1p63 ? std::numeric_limits<std::uint64_t>::max()
+                                                  : static_cast<std::uint64_t>(std::round(std::max(raw, 0.0)));
+        le.clear();
+        append_number(le, bound);
+        append_sample(out, bucket_name, labels, static_cast<double>(snapshot.count_at_or_below(limit)), "le", le);
+    }
+    append_sample(out, bucket_name, labels, static_cast<double>(snapshot.count), "le", "+Inf");
+    append_sample(out, std::string(name) + "_sum", labels, static_cast<double>(snapshot.sum) * scale);
+    append_sample(out, std::string(name) + "_count", labels, static_cast<double>(snapshot.count));
+}
+
+std::string PrometheusText::str() const
+{
+    std::string out;
+    for (const Family& family : families_) {
+        out += "# HELP ";
+        out += family.name;
+        out += ' ';
+        out += family.help;
+        out += "\n# TYPE ";
+        out += family.name;
+        out += ' ';
+        out += family.type;
+        out += '\n';
+        out += family.samples;
+    }
+    return out;
+}
+
+std::span<const double> default_latency_bounds() noexcept
+{
+    return kLatencyBounds;
+}
+
+void add_metrics(PrometheusText& text, std::string_view camera, const CameraStats& stats)
+{
+    const PrometheusText::Label labels[] = {{"camera", camera}};
+    text.histogram("camera_sensor_to_dequeue_seconds", "Time from sensor timestamp to host dequeue.", labels,
+                   stats.sensor_to_dequeue, kLatencyBounds, 1e-9);
+    text.histogram("camera_dequeue_to_consumer_seconds", "Time from host dequeue to consumer grab.", labels,
+                   stats.dequeue_to_consumer, kLatencyBounds, 1e-9);
+    text.histogram("camera_queue_depth", "Delivery queue depth seen by each delivered frame.", labels,
+                   stats.queue_depth, kDepthBounds, 1.0);
+    text.counter("camera_frames_delivered_total", "Frames published to the delivery queue.", labels,
+                 static_cast<double>(stats.frames_delivered));
+    text.counter("camera_frames_consumed_total", "Frames taken from the delivery queue.", labels,
+                 static_cast<double>(stats.frames_consumed));
+    text.counter("camera_queue_drops_total", "Frames dropped by the delivery queue.", labels,
+                 static_cast<double>(stats.queue_drops));
+    text.counter("camera_source_drops_total", "Frames lost before delivery.", labels,
+                 static_cast<double>(stats.source_drops));
+    text.gauge("camera_queue_size", "Frames waiting in the delivery queue.", labels,
+               static_cast<double>(stats.queue_size));
+}
+
+void add_metrics(PrometheusText& text, std::string_view executor, const ExecutorStats& stats)
+{
+    const PrometheusText::Label labels[] = {{"executor", executor}};
+    text.histogram("executor_conversion_seconds", "Time to transform one frame.", labels, stats.conversion,
+                   kLatencyBounds, 1e-9);
+    text.counter("executor_frames_total", "Frames transformed.", labels, static_cast<double>(stats.frames));
+    text.counter("executor_drops_total", "Frames refused for lack of an output frame.", labels,
+                 static_cast<double>(stats.drops));
+}
+
+} // namespace camera_interface
@@ -0,0 +1,88 @@
+#include "camera_interface/pixel_format.hpp"
+
+#include <algorithm>
+
+namespace camera_interface {
+
+const char* to_string(PixelFormat format) noexcept
+{
+    switch (format) {
+    case PixelFormat::mono8: return "mono8";
+    case PixelFormat::mono16: return "mono16";
+    case PixelFormat::bayer_rggb8: return "bayer_rggb8";
+    case PixelFormat::bayer_bggr8: return "bayer_bggr8";
+    case PixelFormat::bayer_grbg8: return "bayer_grbg8";
+    case PixelFormat::bayer_gbrg8: return "bayer_gbrg8";
+    case PixelFormat::yuyv: return "yuyv";
+    case PixelFormat::uyvy: return "uyvy";
+    case PixelFormat::nv12: return "nv12";
+    case PixelFormat::i420: return "i420";
+    case PixelFormat::rgb8: return "rgb8";
+    case PixelFormat::bgr8: return "bgr8";
+    }
+    return "unknown";
+}
+
+std::size_t bytes_per_pixel(PixelFormat format) noexcept
+{
+    switch (format) {
+    case PixelFormat::mono8:
+    case PixelFormat::bayer_rggb8:
+    case PixelFormat::bayer_bggr8:
+    case PixelFormat::bayer_grbg8:
+    case PixelFormat::bayer_gbrg8:
+    case PixelFormat::nv12:
+    case PixelFormat::i420:
+        return 1;
+    case PixelFormat::mono16:
+    case PixelFormat::yuyv:
+    case PixelFormat::uyvy:
+        return 2;
+    case PixelFormat::rgb8:
+    case PixelFormat::bgr8:
+        return 3;
+    }
+    return 1;
+}
+
+std::size_t min_stride(PixelFormat format, std::uint32_t width) noexcept
+{
+    switch (format) {
+    case PixelFormat::yuyv:
+    case PixelFormat::uyvy:
+        // Packed 4:2:2 macropixels cover two horizontal pixels.
+        return ((static_cast<std::size_t>(width) + 1) / 2) * 4;
+    case PixelFormat::nv12:
+        // The interleaved UV rows share the luma stride and hold a U/V pair per two pixels.
+        return (static_cast<std::size_t>(width) + 1) / 2 * 2;
+    default:
+        return static_cast<std::size_t>(width) * bytes_per_pixel(format);
+    }
+}
+
+bool is_bayer(PixelFormat format) noexcept
+{
+    return format == PixelFormat::bayer_rggb8 || format == PixelFormat::bayer_bggr8
+        || format == PixelFormat::bayer_grbg8 || format == PixelFormat::bayer_gbrg8;
+}
+
+std::size_t StreamFormat::frame_size() const noexcept
+{
+    const std::size_t luma = stride * height;
+    const std::size_t chroma_rows = (static_cast<std::size_t>(height) + 1) / 2;
+    switch (format) {
+    case PixelFormat::nv12:
+        return luma + std::max(stride, min_stride(format, width)) * chroma_rows;
+    case PixelFormat::i420:
+        return luma + 2 * ((stride + 1) / 2) * chroma_rows;
+    default:
+        return luma;
+    }
+}
+
+StreamFormat StreamFormat::packed(std::uint32_t width, std::uint32_t height, PixelFormat format) noexcept
+{
+    return StreamFormat{width, height, format, min_stride(format, width)};
+}
+
+} // namespace camera_interface
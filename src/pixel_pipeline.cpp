@@ -0,0 +1,54 @@
+#include "camera_interface/pixel_pipeline.hpp"
+
+#include "convert_kernels.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace camera_interface::detail {
+
+namespace {
+
+/// Recomputes pixel `x` of a span whose edge is not an image edge; the SIMD row kernel
+/// reflected there instead of reading the true neighbour.
+void demosaic_pixel(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                    std::uint32_t width, PixelFormat format, std::uint32_t y, std::uint32_t x_begin, std::uint32_t x,
+                    std::uint8_t* dst) noexcept
+{
+    const std::uint32_t first = x == 0 ? 0 : x - 1;
+    const std::uint32_t count = std::min(width, x + 2) - first;
+    const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(first) - static_cast<std::ptrdiff_t>(x_begin);
+    auto [even, odd] = bayer_sites(format, y);
+    if ((first & 1) != 0)
+        std::swap(even, odd);
+    std::uint8_t pixels[9];
+    bayer_span_scalar(above + offset, row + offset, below + offset, pixels, count, even, odd, x - first,
+                      x - first + 1);
+    std::memcpy(dst + 3 * static_cast<std::size_t>(x - x_begin), pixels + 3 * (x - first), 3);
+}
+
+} // namespace
+
+void demosaic_span(const std::uint8_t* above, const std::uint8_t* row, const std::uint8_t* below,
+                   std::uint32_t width, PixelFormat format, std::uint32_t y, std::uint32_t x_begin,
+                   std::uint32_t x_end, std::uint8_t* dst) noexcept
+{
+    const std::uint32_t count = x_end - x_begin;
+    if (count >= 2) {
+        auto [even, odd] = bayer_sites(format, y);
+        if ((x_begin & 1) != 0)
+            std::swap(even, odd);
+        active_kernels().bayer_row(above, row, below, dst, count, even, odd);
+    }
+    if (x_begin > 0 || count < 2)
+        demosaic_pixel(above, row, below, width, format, y, x_begin, x_begin, dst);
+    if (x_end < width && count >= 2)
+        demosaic_pixel(above, row, below, width, format, y, x_begin, x_end - 1, dst);
+}
+
+void yuv422_span(const std::uint8_t* src, PixelFormat format, std::uint32_t width, std::uint8_t* dst) noexcept
+{
+    active_kernels().yuv422_row(src, dst, width, format == PixelFormat::uyvy);
+}
+
+} // namespace camera_interface::detail
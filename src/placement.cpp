@@ -0,0 +1,166 @@
+#include "camera_interface/placement.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include <sched.h>
+#include <sys/sysinfo.h>
+
+#if defined(CAMERA_INTERFACE_HAVE_LIBNUMA)
+#include <numa.h>
+#endif
+
+namespace camera_interface {
+
+namespace {
+
+/// Reads an integer sysfs attribute; `fallback` when it is missing or unparsable.
+int read_sysfs_int(const std::string& path, int fallback)
+{
+    std::ifstream in(path);
+    int value = fallback;
+    if (!(in >> value))
+        return fallback;
+    return value;
+}
+
+std::string canonical(const std::string& path)
+{
+    char resolved[PATH_MAX];
+    return ::realpath(path.c_str(), resolved) ? std::string(resolved) : std::string();
+}
+
+} // namespace
+
+int Placement::memory_node() const noexcept
+{
+    if (numa_node >= 0)
+        return numa_node;
+    return cpu >= 0 ? numa_node_of_cpu(cpu) : -1;
+}
+
+bool numa_supported() noexcept
+{
+#if defined(CAMERA_INTERFACE_HAVE_LIBNUMA)
+    static const bool supported = ::numa_available() >= 0;
+    return supported;
+#else
+    return false;
+#endif
+}
+
+int numa_node_count() noexcept
+{
+#if defined(CAMERA_INTERFACE_HAVE_LIBNUMA)
+    if (numa_supported())
+        return std::max(1, ::numa_num_configured_nodes());
+#endif
+    return 1;
+}
+
+int numa_node_of_cpu(int cpu) noexcept
+{
+    if (cpu < 0 || cpu >= ::get_nprocs_conf())
+        return -1;
+#if defined(CAMERA_INTERFACE_HAVE_LIBNUMA)
+    if (numa_supported())
+        return std::max(0, ::numa_node_of_cpu(cpu));
+#endif
+    return 0;
+}
+
+int v4l2_device_numa_node(const std::string& device)
+{
+    const std::string node = canonical(device);
+    const std::size_t slash = node.rfind('/');
+    if (node.empty() || slash == std::string::npos)
+        return -1;
+    // The class device links to the bridge's interface; numa_node sits on the PCI device
+    // somewhere above it (a USB camera hangs off its host controller's node).
+    std::string dir = canonical("/sys/class/video4linux/" + node.substr(slash + 1) + "/device");
+    for (; dir.size() > 1 && dir.rfind("/sys/devices", 0) == 0; dir.erase(dir.rfind('/'))) {
+        const int value = read_sysfs_int(dir + "/numa_node", -1);
+        if (value >= 0)
+            return value;
+    }
+    return -1;
+}
+
+std::vector<int> allowed_cpus()
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (::sched_getaffinity(0, sizeof set, &set) != 0)
+        throw std::system_error(errno, std::generic_category(), "sched_getaffinity");
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &set))
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+bool pin_current_thread(int cpu) noexcept
+{
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        errno = EINVAL;
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return ::sched_setaffinity(0, sizeof set, &set) == 0;
+}
+
+void check_placement(const Placement& placement)
+{
+    if (placement.cpu < -1 || placement.numa_node < -1)
+        throw std::invalid_argument("Placement: negative core or node");
+    if (placement.cpu >= 0) {
+        const std::vector<int> cpus = allowed_cpus();
+        if (!std::binary_search(cpus.begin(), cpus.end(), placement.cpu))
+            throw std::invalid_argument("Placement: core " + std::to_string(placement.cpu) + " is not available");
+    }
+    if (numa_supported() && placement.numa_node >= numa_node_count())
+        throw std::invalid_argument("Placement: no NUMA node " + std::to_string(placement.numa_node));
+}
+
+PlacementPlanner::PlacementPlanner() : PlacementPlanner(allowed_cpus())
+{
+}
+
+PlacementPlanner::PlacementPlanner(std::vector<int> cpus) : cpus_(std::move(cpus))
+{
+    std::sort(cpus_.begin(), cpus_.end());
+    cpus_.erase(std::unique(cpus_.begin(), cpus_.end()), cpus_.end());
+    for (const int cpu : cpus_)
+        nodes_.push_back(std::max(0, numa_node_of_cpu(cpu)));
+    use_.assign(cpus_.size(), 0);
+}
+
+Placement PlacementPlanner::place(int node)
+{
+    if (cpus_.empty())
+        return {};
+    if (node < 0 || std::find(nodes_.begin(), nodes_.end(), node) == nodes_.end()) {
+        std::vector<int> nodes = nodes_;
+        std::sort(nodes.begin(), nodes.end());
+        nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+        node = nodes[static_cast<std::size_t>(next_node_++) % nodes.size()];
+    }
+    std::size_t best = cpus_.size();
+    for (std::size_t i = 0; i < cpus_.size(); ++i) {
+        if (nodes_[i] == node && (best == cpus_.size() || use_[i] < use_[best]))
+            best = i;
+    }
+    ++use_[best];
+    return Placement{cpus_[best], node};
+}
+
+} // namespace camera_interface
@@ -0,0 +1,137 @@
+#include "camera_interface/playback_camera.hpp"
+
+#include "camera_interface/clock.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace camera_interface {
+
+PlaybackCamera::PlaybackCamera(const PlaybackConfig& config)
+    : Camera(config.delivery), config_(config), reader_(config.path)
+{
+    if (config_.speed <= 0.0)
+        throw std::invalid_argument("PlaybackCamera: speed must be positive");
+    if (config_.start_frame >= reader_.frame_count())
+        throw std::invalid_argument("PlaybackCamera: start_frame past the end of the recording");
+    check_placement(config_.placement);
+    position_.store(config_.start_frame, std::memory_order_relaxed);
+}
+
+PlaybackCamera::~PlaybackCamera()
+{
+    stop();
+}
+
+void PlaybackCamera::start()
+{
+    if (thread_.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_.store(false, std::memory_order_relaxed);
+    }
+    finished_.store(false, std::memory_order_relaxed);
+    if (position_.load(std::memory_order_relaxed) >= reader_.frame_count())
+        position_.store(0, std::memory_order_relaxed);
+    open_delivery();
+    thread_ = std::thread([this] { run(); });
+}
+
+void PlaybackCamera::stop()
+{
+    if (!thread_.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_.store(true, std::memory_order_relaxed);
+    }
+    wake_.notify_all();
+    close_delivery();
+    thread_.join();
+}
+
+void PlaybackCamera::seek(std::size_t index) noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        seek_to_.store(std::min(index, reader_.frame_count() - 1), std::memory_order_relaxed);
+    }
+    wake_.notify_all();
+}
+
+void PlaybackCamera::seek_to_timestamp(std::int64_t timestamp_ns) noexcept
+{
+    seek(reader_.find(timestamp_ns));
+}
+
+void PlaybackCamera::run()
+{
+    if (config_.placement.cpu >= 0)
+        pin_current_thread(config_.placement.cpu);
+    const std::size_t count = reader_.frame_count();
+    std::size_t index = position_.load(std::memory_order_relaxed);
+    // Real-time pacing maps recorded time onto the steady clock from an anchor frame; the
+    // anchor moves on every seek and loop so a jump never causes a burst or a long stall.
+    bool anchored = false;
+    std::int64_t anchor_recorded = 0;
+    auto anchor_clock = std::chrono::steady_clock::now();
+
+    for (;;) {
+        const std::size_t target = seek_to_.exchange(kNoSeek, std::memory_order_relaxed);
+        if (target != kNoSeek) {
+            index = target;
+            anchored = false;
+        }
+        if (index >= count) {
+            if (!config_.loop)
+                break;
+            index = 0;
+            anchored = false;
+        }
+        position_.store(index, std::memory_order_relaxed);
+        const RecordingIndexEntry& entry = reader_.entry(index);
+        reader_.prefetch(index + 1, config_.prefetch_frames);
+
+        if (config_.realtime) {
+            if (!anchored) {
+                anchor_recorded = entry.timestamp_ns;
+                anchor_clock = std::chrono::steady_clock::now();
+                anchored = true;
+            }
+            const auto offset = static_cast<double>(entry.timestamp_ns - anchor_recorded) / config_.speed;
+            const auto deadline = anchor_clock + std::chrono::nanoseconds(static_cast<std::int64_t>(offset));
+            std::unique_lock<std::mutex> lock(mutex_);
+            const auto interrupted = [this] {
+                return stop_requested_.load(std::memory_order_relaxed)
+                    || seek_to_.load(std::memory_order_relaxed) != kNoSeek;
+            };
+            if (wake_.wait_until(lock, deadline, interrupted)) {
+                if (stop_requested_.load(std::memory_order_relaxed))
+                    return;
+                continue;
+            }
+        } else if (stop_requested_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        FrameHandle frame = reader_.frame(index);
+        ++index;
+        if (!frame) {
+            skipped_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (config_.live_timestamps) {
+            frame.info().sequence = next_sequence_++;
+            frame.info().timestamp_ns = monotonic_now_ns();
+        }
+        played_.fetch_add(1, std::memory_order_relaxed);
+        deliver(std::move(frame));
+    }
+    position_.store(count, std::memory_order_relaxed);
+    finished_.store(true, std::memory_order_release);
+    close_delivery();
+}
+
+} // namespace camera_interface
@@ -0,0 +1,152 @@
+#include "camera_interface/poller.hpp"
+
+#include "camera_interface/placement.hpp"
+
+#include <cerrno>
+#include <system_error>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace camera_interface {
+
+namespace {
+
+constexpr std::uint64_t kWakeId = 0;
+constexpr int kMaxEvents = 64;
+
+[[noreturn]] void throw_errno(const char* what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+} // namespace
+
+Poller::Poller()
+{
+    epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0)
+        throw_errno("epoll_create1");
+    wake_fd_ = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wake_fd_ < 0) {
+        ::close(epoll_fd_);
+        throw_errno("eventfd");
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = kWakeId;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event) < 0) {
+        ::close(wake_fd_);
+        ::close(epoll_fd_);
+        throw_errno("epoll_ctl");
+    }
+}
+
+Poller::~Poller()
+{
+    stop();
+    ::close(wake_fd_);
+    ::close(epoll_fd_);
+}
+
+void Poller::add(int fd, std::uint32_t events, Callback callback)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (ids_.count(fd))
+        throw std::system_error(EEXIST, std::generic_category(), "Poller::add");
+    const std::uint64_t id = next_id_++;
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = id;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0)
+        throw_errno("epoll_ctl");
+    entries_.emplace(id, std::make_shared<Entry>(Entry{id, std::move(callback)}));
+    ids_.emplace(fd, id);
+}
+
+void Poller::remove(int fd)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    const auto it = ids_.find(fd);
+    if (it == ids_.end())
+        return;
+    const std::uint64_t id = it->second;
+    ids_.erase(it);
+    entries_.erase(id);
+    ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    if (dispatch_thread_ != std::this_thread::get_id())
+        idle_.wait(lock, [&] { return dispatching_ != id; });
+}
+
+int Poller::poll_once(std::chrono::milliseconds timeout)
+{
+    epoll_event events[kMaxEvents];
+    const int ready = ::epoll_wait(epoll_fd_, events, kMaxEvents, static_cast<int>(timeout.count()));
+    if (ready < 0) {
+        if (errno == EINTR)
+            return 0;
+        throw_errno("epoll_wait");
+    }
+
+    int dispatched = 0;
+    for (int i = 0; i < ready; ++i) {
+        const std::uint64_t id = events[i].data.u64;
+        if (id == kWakeId) {
+            std::uint64_t drained;
+            [[maybe_unused]] const auto n = ::read(wake_fd_, &drained, sizeof drained);
+            continue;
+        }
+
+        std::shared_ptr<Entry> entry;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto it = entries_.find(id);
+            if (it == entries_.end())
+                continue;
+            entry = it->second;
+            dispatching_ = id;
+            dispatch_thread_ = std::this_thread::get_id();
+        }
+        entry->callback(events[i].events);
+        ++dispatched;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            dispatching_ = 0;
+            dispatch_thread_ = std::thread::id();
+        }
+        idle_.notify_all();
+    }
+    return dispatched;
+}
+
+void Poller::start(int cpu)
+{
+    if (thread_.joinable())
+        return;
+    stop_requested_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread([this, cpu] {
+        if (cpu >= 0)
+            pin_current_thread(cpu);
+        while (!stop_requested_.load(std::memory_order_relaxed))
+            poll_once(std::chrono::milliseconds(-1));
+    });
+}
+
+void Poller::stop()
+{
+    if (!thread_.joinable())
+        return;
+    stop_requested_.store(true, std::memory_order_relaxed);
+    wake();
+    thread_.join();
+}
+
+void Poller::wake() noexcept
+{
+    const std::uint64_t one = 1;
+    [[maybe_unused]] const auto n = ::write(wake_fd_, &one, sizeof one);
+}
+
+} // namespace camera_interface
@@ -0,0 +1,452 @@
+#include "camera_interface/recorder.hpp"
+
+#include "camera_interface/thread_pool.hpp"
+#include "camera_interface/v4l2_io.hpp"
+#include "io_uring.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace camera_interface {
+
+namespace {
+
+[[noreturn]] void throw_errno(const char* what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+/// Each record contributes at most a header block, the block-aligned body and a tail block.
+constexpr std::size_t kIovPerRecord = 3;
+constexpr std::size_t kMaxBatchFrames = IOV_MAX / kIovPerRecord;
+
+bool block_aligned(const void* p) noexcept
+{
+    return reinterpret_cast<std::uintptr_t>(p) % kRecordingBlock == 0;
+}
+
+std::int64_t realtime_now_ns() noexcept
+{
+    timespec ts{};
+    ::clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000'000 + ts.tv_nsec;
+}
+
+/// pwritev until everything is written, resuming after short writes.
+bool write_fully(int fd, iovec* iov, int count, std::uint64_t offset) noexcept
+{
+    while (count > 0) {
+        const ssize_t n = ::pwritev(fd, iov, count, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        if (n == 0) {
+            errno = EIO;
+            return false;
+        }
+        offset += static_cast<std::uint64_t>(n);
+        auto left = static_cast<std::size_t>(n);
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+/// Frames written by one vectored call, plus the block-aligned scratch it needs.
+struct Recorder::Batch {
+    std::vector<FrameHandle> frames;
+    std::vector<RecordingIndexEntry> entries;
+    std::vector<iovec> iov;
+    Blocks blocks;  ///< Header and tail block per frame.
+    Blocks bounce;  ///< Whole payload, for a frame whose memory O_DIRECT cannot use.
+    Blocks encoded; ///< One encoded frame per slot, with a codec.
+    bool bounce_used = false;
+    std::uint64_t offset = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t raw_bytes = 0;
+    bool busy = false;
+};
+
+void Recorder::BlockDeleter::operator()(std::byte* p) const noexcept
+{
+    ::operator delete[](p, std::align_val_t{kRecordingBlock});
+}
+
+Recorder::Blocks Recorder::allocate_blocks(std::size_t bytes)
+{
+    auto* p = static_cast<std::byte*>(::operator new[](bytes, std::align_val_t{kRecordingBlock}));
+    std::memset(p, 0, bytes);
+    return Blocks(p);
+}
+
+Recorder::Recorder(const RecorderConfig& config)
+    : config_(config), queue_(config.queue_depth, OverflowPolicy::drop_oldest)
+{
+    if (config_.format.width == 0 || config_.format.height == 0)
+        throw std::invalid_argument("Recorder: empty frame format");
+    if (config_.batch_frames == 0 || config_.max_in_flight == 0)
+        throw std::invalid_argument("Recorder: batch_frames and max_in_flight must be positive");
+    config_.batch_frames = std::min(config_.batch_frames, kMaxBatchFrames);
+    payload_size_ = round_up_to_block(config_.format.frame_size());
+    record_size_ = recording_record_size(config_.format);
+    if (config_.codec.codec != FrameCodec::none) {
+        if (config_.codec.codec != FrameCodec::delta_lz4)
+            throw std::invalid_argument("Recorder: unknown codec");
+        const unsigned threads =
+            config_.codec_threads != 0 ? config_.codec_threads : std::max(1u, std::thread::hardware_concurrency());
+        if (threads > 1)
+            codec_pool_ = std::make_unique<ThreadPool>(threads - 1);
+        encoder_ = std::make_unique<FrameEncoder>(config_.format, config_.codec, codec_pool_.get());
+        encoded_pitch_ = round_up_to_block(encoder_->max_encoded_size());
+        record_size_ = kRecordingBlock + encoded_pitch_;
+    }
+
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    if (config_.direct_io) {
+        fd_ = ::open(config_.path.c_str(), flags | O_DIRECT, 0644);
+        direct_io_ = fd_ >= 0;
+        if (fd_ < 0 && errno != EINVAL)
+            throw_errno("Recorder: open");
+    }
+    if (fd_ < 0) {
+        fd_ = ::open(config_.path.c_str(), flags, 0644);
+        if (fd_ < 0)
+            throw_errno("Recorder: open");
+    }
+    if (config_.preallocate_bytes > 0)
+        ::fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(config_.preallocate_bytes));
+
+    if (config_.io != RecorderIo::pwritev) {
+        ring_ = detail::IoUring::create(static_cast<unsigned>(config_.max_in_flight));
+        if (!ring_ && config_.io == RecorderIo::io_uring) {
+            ::close(fd_);
+            throw std::system_error(ENOSYS, std::generic_category(), "Recorder: io_uring unavailable");
+        }
+    }
+    const std::size_t batches = ring_ ? config_.max_in_flight : 1;
+    batches_.resize(batches);
+    for (Batch& batch : batches_) {
+        batch.frames.reserve(config_.batch_frames);
+        batch.entries.reserve(config_.batch_frames);
+        batch.iov.reserve(config_.batch_frames * kIovPerRecord);
+        batch.blocks = allocate_blocks(config_.batch_frames * 2 * kRecordingBlock);
+        if (encoder_)
+            batch.encoded = allocate_blocks(config_.batch_frames * encoded_pitch_);
+    }
+
+    header_block_ = allocate_blocks(kRecordingBlock);
+    RecordingHeader header{};
+    std::memcpy(header.magic, kRecordingMagic, sizeof(header.magic));
+    header.version = kRecordingVersion;
+    header.width = config_.format.width;
+    header.height = config_.format.height;
+    header.fourcc = to_v4l2_fourcc(config_.format.format);
+    header.stride = config_.format.stride;
+    header.frame_bytes = config_.format.frame_size();
+    header.record_size = record_size_;
+    header.data_offset = kRecordingBlock;
+    header.created_realtime_ns = realtime_now_ns();
+    header.codec = static_cast<std::uint32_t>(config_.codec.codec);
+    std::memcpy(header_block_.get(), &header, sizeof(header));
+    if (::pwrite(fd_, header_block_.get(), kRecordingBlock, 0) != static_cast<ssize_t>(kRecordingBlock)) {
+        const int error = errno;
+        ::close(fd_);
+        throw std::system_error(error, std::generic_category(), "Recorder: write header");
+    }
+    next_offset_ = kRecordingBlock;
+
+    queue_.reopen();
+    writer_ = std::thread([this] { run(); });
+}
+
+Recorder::~Recorder()
+{
+    try {
+        close();
+    } catch (...) {
+    }
+    if (fd_ >= 0)
+        ::close(fd_);
+}
+
+bool Recorder::write(FrameHandle frame) noexcept
+{
+    const bool accepted = frame && error_.load(std::memory_order_relaxed) == 0
+                       && frame.info().bytes_used <= config_.format.frame_size()
+                       && frame.info().format.format == config_.format.format
+                       && frame.info().format.width == config_.format.width
+                       && frame.info().format.height == config_.format.height && !queue_.closed()
+                       && queue_.try_push(frame);
+    if (!accepted)
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    return accepted;
+}
+
+std::error_code Recorder::error() const noexcept
+{
+    const int e = error_.load(std::memory_order_acquire);
+    return e == 0 ? std::error_code{} : std::error_code(e, std::generic_category());
+}
+
+void Recorder::close()
+{
+    if (!writer_.joinable())
+        return;
+    queue_.close();
+    writer_.join();
+    finalize();
+    ::close(fd_);
+    fd_ = -1;
+    if (const std::error_code e = error())
+        throw std::system_error(e, "Recorder: write");
+}
+
+void Recorder::run() noexcept
+{
+    for (;;) {
+        auto free = std::find_if(batches_.begin(), batches_.end(), [](const Batch& b) { return !b.busy; });
+        if (free == batches_.end()) {
+            if (!reap(1))
+                break;
+            continue;
+        }
+
+        std::optional<FrameHandle> frame;
+        if (in_flight_ == 0) {
+            frame = queue_.pop(FrameQueue::forever);
+            if (!frame)
+                break; // closed and drained
+        } else if (!(frame = queue_.try_pop())) {
+            if (!reap(1))
+                break;
+            continue;
+        }
+
+        Batch& batch = *free;
+        batch.offset = next_offset_;
+        bool more = append(batch, *frame);
+        while (more && batch.entries.size() < config_.batch_frames) {
+            frame = queue_.try_pop();
+            if (!frame)
+                break;
+            more = append(batch, *frame);
+        }
+        issue(batch);
+        if (error_.load(std::memory_order_relaxed) != 0)
+            break;
+    }
+    while (in_flight_ > 0 && reap(1)) {
+    }
+    // Whatever is still queued after a failure is released unwritten.
+    queue_.clear();
+}
+
+bool Recorder::append(Batch& batch, FrameHandle& frame) noexcept
+{
+    const FrameInfo& info = frame.info();
+    const std::size_t bytes = info.bytes_used;
+    const std::size_t slot = batch.entries.size();
+    std::byte* header_block = batch.blocks.get() + slot * 2 * kRecordingBlock;
+    std::byte* tail_block = header_block + kRecordingBlock;
+
+    RecordHeader record{kRecordMagic, 0, info.sequence, info.timestamp_ns, bytes};
+    batch.iov.push_back(iovec{header_block, kRecordingBlock});
+    batch.entries.push_back(RecordingIndexEntry{info.sequence, info.timestamp_ns,
+                                                next_offset_ + kRecordingBlock, bytes});
+    batch.raw_bytes += bytes;
+
+    if (encoder_) {
+        // Records are packed, so an encoded frame always continues the batch, and the frame
+        // buffer can go back to the camera at once.
+        std::byte* encoded = batch.encoded.get() + slot * encoded_pitch_;
+        const std::size_t size = encoder_->encode(frame.data(), bytes, encoded);
+        const std::uint64_t padded = round_up_to_block(size);
+        std::memset(encoded + size, 0, padded - size);
+        record.stored_bytes = static_cast<std::uint32_t>(size);
+        std::memcpy(header_block, &record, sizeof(record));
+        batch.iov.push_back(iovec{encoded, padded});
+        frame.reset();
+        batch.bytes += kRecordingBlock + padded;
+        next_offset_ += kRecordingBlock + padded;
+        return true;
+    }
+    std::memcpy(header_block, &record, sizeof(record));
+
+    const std::byte* data = frame.data();
+    if (direct_io_ && !block_aligned(data) && !batch.bounce_used) {
+        if (!batch.bounce) {
+            try {
+                batch.bounce = allocate_blocks(payload_size_);
+            } catch (const std::bad_alloc&) {
+                fail(ENOMEM);
+            }
+        }
+        if (batch.bounce) {
+            std::memcpy(batch.bounce.get(), data, bytes);
+            data = batch.bounce.get();
+            batch.bounce_used = true;
+        }
+    }
+    const std::size_t body = bytes / kRecordingBlock * kRecordingBlock;
+    if (body > 0)
+        batch.iov.push_back(iovec{const_cast<std::byte*>(data), body});
+    const std::size_t tail = bytes - body;
+    if (tail > 0) {
+        std::memcpy(tail_block, data + body, tail);
+        std::memset(tail_block + tail, 0, kRecordingBlock - tail);
+        batch.iov.push_back(iovec{tail_block, kRecordingBlock});
+    }
+    const std::uint64_t written = kRecordingBlock + round_up_to_block(bytes);
+
+    batch.frames.push_back(std::move(frame));
+    batch.bytes += written;
+    next_offset_ += record_size_;
+    // The next record continues this write only if this one filled its slot, and a second
+    // unaligned frame would need a second bounce buffer.
+    const bool next_unaligned_ok = !direct_io_ || !batch.bounce_used;
+    return written == record_size_ && next_unaligned_ok;
+}
+
+void Recorder::issue(Batch& batch) noexcept
+{
+    batch.busy = true;
+    ++in_flight_;
+    const auto index = static_cast<std::uint64_t>(&batch - batches_.data());
+    if (ring_) {
+        if (ring_->prepare_writev(fd_, batch.iov.data(), static_cast<unsigned>(batch.iov.size()), batch.offset,
+                                  index)
+            && ring_->submit(0))
+            return;
+        fail(errno);
+        complete(batch, -1);
+        return;
+    }
+    const bool ok = write_fully(fd_, batch.iov.data(), static_cast<int>(batch.iov.size()), batch.offset);
+    if (!ok)
+        fail(errno);
+    complete(batch, ok ? static_cast<std::int64_t>(batch.bytes) : -1);
+}
+
+bool Recorder::reap(unsigned wait_for) noexcept
+{
+    if (!ring_ || in_flight_ == 0)
+        return in_flight_ == 0;
+    if (!ring_->submit(wait_for)) {
+        fail(errno);
+        return false;
+    }
+    std::uint64_t index;
+    std::int32_t result;
+    while (ring_->pop_completion(index, result)) {
+        Batch& batch = batches_[index];
+        if (result < 0) {
+            fail(-result);
+        } else if (static_cast<std::uint64_t>(result) < batch.bytes) {
+            // Short write: finish the rest synchronously.
+            std::size_t done = static_cast<std::size_t>(result);
+            std::size_t i = 0;
+            while (i < batch.iov.size() && done >= batch.iov[i].iov_len)
+                done -= batch.iov[i++].iov_len;
+            batch.iov[i].iov_base = static_cast<char*>(batch.iov[i].iov_base) + done;
+            batch.iov[i].iov_len -= done;
+            if (!write_fully(fd_, batch.iov.data() + i, static_cast<int>(batch.iov.size() - i),
+                             batch.offset + static_cast<std::uint64_t>(result)))
+                fail(errno);
+        }
+        complete(batch, result);
+    }
+    return true;
+}
+
+void Recorder::complete(Batch& batch, std::int64_t result) noexcept
+{
+    if (result >= 0 && error_.load(std::memory_order_relaxed) == 0) {
+        index_.insert(index_.end(), batch.entries.begin(), batch.entries.end());
+        written_.fetch_add(batch.entries.size(), std::memory_order_relaxed);
+        bytes_.fetch_add(batch.bytes, std::memory_order_relaxed);
+        raw_bytes_.fetch_add(batch.raw_bytes, std::memory_order_relaxed);
+        if (!direct_io_)
+            write_behind(batch.offset, batch.bytes);
+    }
+    batch.frames.clear();
+    batch.entries.clear();
+    batch.iov.clear();
+    batch.bounce_used = false;
+    batch.bytes = 0;
+    batch.raw_bytes = 0;
+    batch.busy = false;
+    --in_flight_;
+}
+
+void Recorder::write_behind(std::uint64_t offset, std::uint64_t bytes) noexcept
+{
+    // Start writeback of this batch now; wait for the previous one and drop it from the page
+    // cache, so buffered recording does not push the rest of the system's cache out.
+    ::sync_file_range(fd_, static_cast<off_t>(offset), static_cast<off_t>(bytes), SYNC_FILE_RANGE_WRITE);
+    if (behind_bytes_ > 0) {
+        ::sync_file_range(fd_, static_cast<off_t>(behind_offset_), static_cast<off_t>(behind_bytes_),
+                          SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        ::posix_fadvise(fd_, static_cast<off_t>(behind_offset_), static_cast<off_t>(behind_bytes_),
+                        POSIX_FADV_DONTNEED);
+    }
+    behind_offset_ = offset;
+    behind_bytes_ = bytes;
+}
+
+void Recorder::fail(int error) noexcept
+{
+    int expected = 0;
+    error_.compare_exchange_strong(expected, error != 0 ? error : EIO, std::memory_order_acq_rel);
+}
+
+void Recorder::finalize()
+{
+    // io_uring completions arrive in any order; the index is kept in file order.
+    std::sort(index_.begin(), index_.end(),
+              [](const RecordingIndexEntry& a, const RecordingIndexEntry& b) { return a.offset < b.offset; });
+    const std::uint64_t index_offset = next_offset_;
+    const std::size_t index_bytes = round_up_to_block(index_.size() * sizeof(RecordingIndexEntry));
+    if (index_bytes > 0) {
+        Blocks index = allocate_blocks(index_bytes);
+        std::memcpy(index.get(), index_.data(), index_.size() * sizeof(RecordingIndexEntry));
+        iovec iov{index.get(), index_bytes};
+        if (!write_fully(fd_, &iov, 1, index_offset))
+            fail(errno);
+    }
+
+    RecordingHeader header;
+    std::memcpy(&header, header_block_.get(), sizeof(header));
+    header.frame_count = index_.size();
+    header.index_offset = index_offset;
+    header.flags |= kRecordingFinalized;
+    std::memcpy(header_block_.get(), &header, sizeof(header));
+    iovec iov{header_block_.get(), kRecordingBlock};
+    if (!write_fully(fd_, &iov, 1, 0))
+        fail(errno);
+    // Give back preallocated space past the end.
+    if (::ftruncate(fd_, static_cast<off_t>(index_offset + index_bytes)) != 0 || ::fdatasync(fd_) != 0)
+        fail(errno);
+}
+
+} // namespace camera_interface
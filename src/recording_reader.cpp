@@ -0,0 +1,203 @@
+#include "camera_interface/recording_reader.hpp"
+
+#include "camera_interface/v4l2_io.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace camera_interface {
+
+namespace {
+
+[[noreturn]] void throw_errno(const char* what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+[[noreturn]] void throw_corrupt(const std::string& path, const char* what)
+{
+    throw std::runtime_error("RecordingReader: " + path + ": " + what);
+}
+
+} // namespace
+
+struct RecordingReader::Mapping {
+    std::byte* data = nullptr;
+    std::size_t size = 0;
+
+    ~Mapping()
+    {
+        if (data)
+            ::munmap(data, size);
+    }
+};
+
+RecordingReader::RecordingReader(const std::string& path, std::size_t decode_buffers)
+    : mapping_(std::make_shared<Mapping>())
+{
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw_errno("RecordingReader: open");
+    struct stat st{};
+    if (::fstat(fd, &st) != 0) {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "RecordingReader: fstat");
+    }
+    if (static_cast<std::size_t>(st.st_size) < kRecordingBlock) {
+        ::close(fd);
+        throw_corrupt(path, "too short");
+    }
+    mapping_->size = static_cast<std::size_t>(st.st_size);
+    // Private and writable: consumers may scribble on frames without touching the file.
+    void* p = ::mmap(nullptr, mapping_->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    const int error = errno;
+    ::close(fd);
+    if (p == MAP_FAILED)
+        throw std::system_error(error, std::generic_category(), "RecordingReader: mmap");
+    mapping_->data = static_cast<std::byte*>(p);
+
+    std::memcpy(&header_, mapping_->data, sizeof(header_));
+    if (std::memcmp(header_.magic, kRecordingMagic, sizeof(header_.magic)) != 0)
+        throw_corrupt(path, "not a recording");
+    if (header_.version == 1)
+        header_.codec = 0; // Reserved space, zero in every version 1 file.
+    else if (header_.version != kRecordingVersion)
+        throw_corrupt(path, "unsupported version");
+    if (codec() != FrameCodec::none && codec() != FrameCodec::delta_lz4)
+        throw_corrupt(path, "unsupported codec");
+    const auto pixel_format = from_v4l2_fourcc(header_.fourcc);
+    if (!pixel_format)
+        throw_corrupt(path, "unknown pixel format");
+    format_ = StreamFormat{header_.width, header_.height, *pixel_format, header_.stride};
+    if (format_.frame_size() != header_.frame_bytes
+        || header_.record_size < kRecordingBlock + header_.frame_bytes || header_.data_offset < kRecordingBlock)
+        throw_corrupt(path, "inconsistent header");
+
+    load_index();
+    if (index_.empty())
+        throw_corrupt(path, "recording holds no frames");
+
+    if (codec() != FrameCodec::none) {
+        // The stored sizes live in the record headers, just before each payload.
+        stored_bytes_.reserve(index_.size());
+        for (const RecordingIndexEntry& entry : index_) {
+            RecordHeader record{};
+            if (entry.offset < header_.data_offset + kRecordingBlock || entry.offset > mapping_->size)
+                throw_corrupt(path, "index points outside the file");
+            std::memcpy(&record, mapping_->data + entry.offset - kRecordingBlock, sizeof(record));
+            if (record.magic != kRecordMagic || record.stored_bytes > mapping_->size - entry.offset
+                || entry.bytes_used > header_.frame_bytes)
+                throw_corrupt(path, "index points outside the file");
+            stored_bytes_.push_back(record.stored_bytes);
+        }
+        if (decode_buffers == 0)
+            throw std::invalid_argument("RecordingReader: decode_buffers must be positive");
+        FrameBufferPool::Config pool;
+        pool.capacity = decode_buffers;
+        pool.buffer_size = static_cast<std::size_t>(header_.frame_bytes);
+        pool_ = std::make_unique<FrameBufferPool>(pool);
+        ::madvise(mapping_->data, mapping_->size, MADV_SEQUENTIAL);
+        return;
+    }
+
+    std::vector<BufferRegion> regions;
+    regions.reserve(index_.size());
+    for (const RecordingIndexEntry& entry : index_) {
+        if (entry.offset > mapping_->size || header_.frame_bytes > mapping_->size - entry.offset
+            || entry.bytes_used > header_.frame_bytes)
+            throw_corrupt(path, "index points outside the file");
+        regions.push_back(BufferRegion{mapping_->data + entry.offset, static_cast<std::size_t>(header_.frame_bytes)});
+    }
+    // The hook owns a reference to the mapping, so outstanding handles keep it mapped.
+    pool_ = std::make_unique<FrameBufferPool>(std::move(regions), [mapping = mapping_](std::uint32_t) {});
+    ::madvise(mapping_->data, mapping_->size, MADV_SEQUENTIAL);
+}
+
+RecordingReader::~RecordingReader() = default;
+
+void RecordingReader::load_index()
+{
+    const std::size_t size = mapping_->size;
+    if (finalized() && header_.index_offset <= size
+        && header_.frame_count <= (size - header_.index_offset) / sizeof(RecordingIndexEntry)) {
+        index_.resize(header_.frame_count);
+        std::memcpy(index_.data(), mapping_->data + header_.index_offset,
+                    index_.size() * sizeof(RecordingIndexEntry));
+        return;
+    }
+    // Unfinished recording: walk the records until the first hole. They are fixed-size
+    // without a codec and packed with one.
+    header_.flags &= ~kRecordingFinalized;
+    const bool packed = codec() != FrameCodec::none;
+    for (std::uint64_t offset = header_.data_offset; offset + kRecordingBlock <= size;) {
+        RecordHeader record;
+        std::memcpy(&record, mapping_->data + offset, sizeof(record));
+        const std::uint64_t record_size =
+            packed ? kRecordingBlock + round_up_to_block(record.stored_bytes) : header_.record_size;
+        if (record.magic != kRecordMagic || record.bytes_used > header_.frame_bytes || record_size > size - offset
+            || (packed && record.stored_bytes == 0))
+            break;
+        index_.push_back(
+            RecordingIndexEntry{record.sequence, record.timestamp_ns, offset + kRecordingBlock, record.bytes_used});
+        offset += record_size;
+    }
+}
+
+std::size_t RecordingReader::find(std::int64_t timestamp_ns) const noexcept
+{
+    const auto it = std::lower_bound(
+        index_.begin(), index_.end(), timestamp_ns,
+        [](const RecordingIndexEntry& entry, std::int64_t t) { return entry.timestamp_ns < t; });
+    return static_cast<std::size_t>(it - index_.begin());
+}
+
+FrameHandle RecordingReader::frame(std::size_t index) noexcept
+{
+    if (index >= index_.size())
+        return {};
+    const RecordingIndexEntry& entry = index_[index];
+    const bool compressed = codec() != FrameCodec::none;
+    FrameHandle handle = compressed ? pool_->acquire() : pool_->claim(static_cast<std::uint32_t>(index));
+    if (!handle)
+        return {};
+    if (compressed && !decode_frame(payload(index), handle.data(), static_cast<std::size_t>(entry.bytes_used)))
+        return {};
+    FrameInfo& info = handle.info();
+    info.format = format_;
+    info.sequence = entry.sequence;
+    info.timestamp_ns = entry.timestamp_ns;
+    info.bytes_used = entry.bytes_used;
+    return handle;
+}
+
+std::span<const std::byte> RecordingReader::payload(std::size_t index) const noexcept
+{
+    if (index >= index_.size())
+        return {};
+    const std::uint64_t bytes = codec() != FrameCodec::none ? stored_bytes_[index] : index_[index].bytes_used;
+    return {mapping_->data + index_[index].offset, static_cast<std::size_t>(bytes)};
+}
+
+void RecordingReader::prefetch(std::size_t index, std::size_t count) const noexcept
+{
+    const std::size_t end = std::min(index_.size(), index + count);
+    if (index >= end)
+        return;
+    // madvise wants a page-aligned start; records are block-aligned, which is a page multiple
+    // on every mainstream configuration, but round down anyway.
+    const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t begin = index_[index].offset / page * page;
+    const std::size_t last = index_[end - 1].offset + payload(end - 1).size();
+    ::madvise(mapping_->data + begin, std::min(last, mapping_->size) - begin, MADV_WILLNEED);
+}
+
+} // namespace camera_interface
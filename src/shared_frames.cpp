@@ -0,0 +1,586 @@
+#include "camera_interface/shared_frames.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace camera_interface {
+
+namespace detail {
+
+constexpr std::uint64_t kSharedMagic = 0x53454d4152464943ull; // "CIFRAMES", little-endian
+constexpr std::uint32_t kSharedVersion = 2; // 2: FrameInfo gained `luma`.
+/// Ring entries pack the publish position above the slot index.
+constexpr unsigned kSlotBits = 16;
+constexpr std::uint64_t kSlotMask = (std::uint64_t{1} << kSlotBits) - 1;
+constexpr std::uint32_t kEntryFree = 0;
+constexpr std::uint32_t kEntryActive = 1;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free,
+              "shared-memory atomics must be address-free");
+static_assert(std::is_trivially_copyable_v<FrameInfo>);
+
+struct SharedHeader {
+    std::uint64_t magic = 0; ///< Written last, with release, once the region is initialised.
+    std::uint32_t version = kSharedVersion;
+    std::uint32_t slot_count = 0;
+    std::uint64_t slot_size = 0;
+    std::uint64_t slot_pitch = 0;
+    std::uint32_t ring_capacity = 0;
+    std::uint32_t max_subscribers = 0;
+    std::uint64_t data_offset = 0;
+    std::uint64_t size = 0;
+
+    alignas(64) std::atomic<std::uint64_t> head{0}; ///< Frames published so far.
+    std::atomic<std::uint64_t> active{0};           ///< Bit per subscriber receiving new frames.
+    std::atomic<std::uint32_t> closed{0};
+
+    alignas(64) std::atomic<std::uint32_t> wake_seq{0}; ///< Futex word, bumped per publish.
+    std::atomic<std::uint32_t> waiters{0};
+};
+
+struct alignas(64) SharedSubscriberEntry {
+    std::atomic<std::uint32_t> state{kEntryFree};
+    std::atomic<std::int32_t> pid{0};
+    /// Head when the subscriber joined; bits on frames published before that are stale.
+    std::atomic<std::uint64_t> joined_at{0};
+    /// Next position to read. Advanced by the subscriber, or by the publisher when evicting.
+    std::atomic<std::uint64_t> cursor{0};
+    std::atomic<std::uint64_t> dropped{0};
+};
+
+struct alignas(64) SharedSlot {
+    /// Subscribers still referencing the buffer; it is free when no bit is set.
+    std::atomic<std::uint64_t> readers{0};
+    std::atomic<std::uint64_t> position{0};
+    FrameInfo info; ///< Written before `readers` is published.
+};
+
+namespace {
+
+std::size_t round_up(std::size_t value, std::size_t multiple) noexcept
+{
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+} // namespace
+
+struct SharedRegion {
+    std::byte* base = nullptr;
+    std::size_t size = 0;
+    std::size_t subscribers_offset = 0;
+    std::size_t slots_offset = 0;
+    std::size_t ring_offset = 0;
+
+    ~SharedRegion()
+    {
+        if (base)
+            ::munmap(base, size);
+    }
+
+    /// Offsets of the tables for `header`'s geometry; returns the offset of the frame data.
+    std::size_t lay_out(const SharedHeader& header) noexcept
+    {
+        subscribers_offset = round_up(sizeof(SharedHeader), alignof(SharedSubscriberEntry));
+        slots_offset = subscribers_offset + header.max_subscribers * sizeof(SharedSubscriberEntry);
+        ring_offset = slots_offset + header.slot_count * sizeof(SharedSlot);
+        return round_up(ring_offset + header.ring_capacity * sizeof(std::atomic<std::uint64_t>), 4096);
+    }
+
+    SharedHeader& header() const noexcept { return *std::launder(reinterpret_cast<SharedHeader*>(base)); }
+    SharedSubscriberEntry& subscriber(std::size_t i) const noexcept
+    {
+        return std::launder(reinterpret_cast<SharedSubscriberEntry*>(base + subscribers_offset))[i];
+    }
+    SharedSlot& slot(std::size_t i) const noexcept
+    {
+        return std::launder(reinterpret_cast<SharedSlot*>(base + slots_offset))[i];
+    }
+    std::atomic<std::uint64_t>& ring(std::uint64_t position) const noexcept
+    {
+        auto* ring = std::launder(reinterpret_cast<std::atomic<std::uint64_t>*>(base + ring_offset));
+        return ring[position & (header().ring_capacity - 1)];
+    }
+
+    std::vector<BufferRegion> buffers() const
+    {
+        const SharedHeader& h = header();
+        std::vector<BufferRegion> buffers(h.slot_count);
+        for (std::size_t i = 0; i < buffers.size(); ++i)
+            buffers[i] = BufferRegion{base + h.data_offset + i * h.slot_pitch, h.slot_size};
+        return buffers;
+    }
+
+    /// Drops subscriber `index`'s reference from every buffer.
+    void release_all(unsigned index) const noexcept
+    {
+        const std::uint64_t bit = std::uint64_t{1} << index;
+        for (std::size_t i = 0; i < header().slot_count; ++i)
+            slot(i).readers.fetch_and(~bit, std::memory_order_acq_rel);
+    }
+
+    /// True when subscriber `index` cannot hold the frame published at `position`: its entry was
+    /// freed, or taken by a subscriber that joined later. A publish that races with a detach
+    /// leaves such bits behind.
+    bool departed(unsigned index, std::uint64_t position) const noexcept
+    {
+        const SharedSubscriberEntry& entry = subscriber(index);
+        return entry.state.load(std::memory_order_acquire) != kEntryActive
+               || entry.joined_at.load(std::memory_order_relaxed) > position;
+    }
+};
+
+/// One subscriber's hold on its entry; outlives the `FrameSubscriber` while its frames do.
+struct SharedAttachment {
+    std::shared_ptr<SharedRegion> region;
+    unsigned index = 0;
+    std::uint64_t bit = 0;
+
+    ~SharedAttachment()
+    {
+        SharedHeader& header = region->header();
+        header.active.fetch_and(~bit, std::memory_order_seq_cst);
+        region->release_all(index);
+        region->subscriber(index).state.store(kEntryFree, std::memory_order_release);
+    }
+};
+
+} // namespace detail
+
+namespace {
+
+using detail::SharedHeader;
+using detail::SharedRegion;
+using detail::SharedSlot;
+using detail::SharedSubscriberEntry;
+
+[[noreturn]] void throw_errno(const char* what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+std::uint64_t magic_of(SharedHeader& header) noexcept
+{
+    return std::atomic_ref<std::uint64_t>(header.magic).load(std::memory_order_acquire);
+}
+
+void futex_wake(std::atomic<std::uint32_t>& word) noexcept
+{
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected, std::chrono::nanoseconds timeout) noexcept
+{
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    timespec ts{static_cast<time_t>(seconds.count()), static_cast<long>((timeout - seconds).count())};
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, &ts, nullptr, 0);
+}
+
+bool process_gone(std::int32_t pid) noexcept
+{
+    return pid > 0 && ::kill(pid, 0) != 0 && errno == ESRCH;
+}
+
+} // namespace
+
+FramePublisher::FramePublisher(const FramePublisherConfig& config)
+    : name_(config.name), evict_lagging_(config.evict_lagging), region_(std::make_shared<SharedRegion>())
+{
+    if (config.slot_count == 0 || config.slot_count >= detail::kSlotMask)
+        throw std::invalid_argument("FramePublisher: slot_count out of range");
+    if (config.slot_size == 0)
+        throw std::invalid_argument("FramePublisher: slot_size must be non-zero");
+    if (config.max_subscribers == 0 || config.max_subscribers > 64)
+        throw std::invalid_argument("FramePublisher: max_subscribers must be in [1, 64]");
+
+    SharedHeader geometry;
+    geometry.slot_count = static_cast<std::uint32_t>(config.slot_count);
+    geometry.slot_size = config.slot_size;
+    geometry.slot_pitch = detail::round_up(config.slot_size, 4096);
+    // Pending frames pin their buffers, so a subscriber never lags by more than slot_count.
+    geometry.ring_capacity = static_cast<std::uint32_t>(std::bit_ceil(std::max<std::size_t>(16, 2 * config.slot_count)));
+    geometry.max_subscribers = static_cast<std::uint32_t>(config.max_subscribers);
+    geometry.data_offset = region_->lay_out(geometry);
+    geometry.size = geometry.data_offset + geometry.slot_pitch * geometry.slot_count;
+
+    if (name_.empty()) {
+        fd_ = ::memfd_create("camera_interface_frames", MFD_CLOEXEC);
+        if (fd_ < 0)
+            throw_errno("FramePublisher: memfd_create");
+    } else {
+        ::shm_unlink(name_.c_str());
+        fd_ = ::shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0660);
+        if (fd_ < 0)
+            throw_errno("FramePublisher: shm_open");
+    }
+    try {
+        if (::ftruncate(fd_, static_cast<off_t>(geometry.size)) != 0)
+            throw_errno("FramePublisher: ftruncate");
+        // Populated up front so neither side faults in buffers at frame rate.
+        void* p = ::mmap(nullptr, geometry.size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, 0);
+        if (p == MAP_FAILED)
+            throw_errno("FramePublisher: mmap");
+        region_->base = static_cast<std::byte*>(p);
+        region_->size = geometry.size;
+
+        SharedHeader* header = new (region_->base) SharedHeader;
+        header->version = geometry.version;
+        header->slot_count = geometry.slot_count;
+        header->slot_size = geometry.slot_size;
+        header->slot_pitch = geometry.slot_pitch;
+        header->ring_capacity = geometry.ring_capacity;
+        header->max_subscribers = geometry.max_subscribers;
+        header->data_offset = geometry.data_offset;
+        header->size = geometry.size;
+        for (std::size_t i = 0; i < geometry.max_subscribers; ++i)
+            new (&region_->subscriber(i)) SharedSubscriberEntry;
+        for (std::size_t i = 0; i < geometry.slot_count; ++i)
+            new (&region_->slot(i)) SharedSlot;
+        for (std::size_t i = 0; i < geometry.ring_capacity; ++i)
+            new (&region_->ring(i)) std::atomic<std::uint64_t>(0);
+
+        // The hook owns a reference to the region, so handles from acquire() keep it mapped.
+        pool_ = std::make_unique<FrameBufferPool>(region_->buffers(), [region = region_](std::uint32_t) {});
+        std::atomic_ref<std::uint64_t>(header->magic).store(detail::kSharedMagic, std::memory_order_release);
+    } catch (...) {
+        ::close(fd_);
+        if (!name_.empty())
+            ::shm_unlink(name_.c_str());
+        throw;
+    }
+}
+
+FramePublisher::~FramePublisher()
+{
+    region_->header().closed.store(1, std::memory_order_seq_cst);
+    wake();
+    pool_.reset();
+    region_.reset();
+    ::close(fd_);
+    if (!name_.empty())
+        ::shm_unlink(name_.c_str());
+}
+
+FrameHandle FramePublisher::acquire() noexcept
+{
+    if (FrameHandle buffer = claim_free())
+        return buffer;
+    if (reap() != 0) {
+        if (FrameHandle buffer = claim_free())
+            return buffer;
+    }
+    if (evict_lagging_ && evict())
+        return claim_free();
+    return {};
+}
+
+bool FramePublisher::publish(const FrameHandle& frame) noexcept
+{
+    SharedHeader& header = region_->header();
+    if (!frame || header.active.load(std::memory_order_seq_cst) == 0)
+        return false;
+
+    const std::byte* begin = region_->base + header.data_offset;
+    const bool in_place = frame.data() >= begin && frame.data() < begin + header.slot_pitch * header.slot_count;
+    FrameHandle buffer;
+    if (in_place) {
+        // Already published and not yet released by every subscriber.
+        if (region_->slot(frame.index()).readers.load(std::memory_order_acquire) != 0)
+            return false;
+        buffer = frame;
+    } else {
+        if (frame.info().bytes_used > header.slot_size)
+            return false;
+        buffer = acquire();
+        if (!buffer) {
+            ++dropped_;
+            return false;
+        }
+        std::memcpy(buffer.data(), frame.data(), frame.info().bytes_used);
+    }
+
+    SharedSlot& slot = region_->slot(buffer.index());
+    const std::uint64_t position = header.head.load(std::memory_order_relaxed);
+    slot.info = frame.info();
+    slot.position.store(position, std::memory_order_relaxed);
+    // Re-read so that subscribers which joined since the check above are included.
+    slot.readers.store(header.active.load(std::memory_order_seq_cst), std::memory_order_release);
+    region_->ring(position).store(position << detail::kSlotBits | buffer.index(), std::memory_order_release);
+    header.head.store(position + 1, std::memory_order_seq_cst);
+    ++published_;
+    wake();
+    return true;
+}
+
+std::size_t FramePublisher::reap() noexcept
+{
+    SharedHeader& header = region_->header();
+    std::size_t reaped = 0;
+    for (unsigned i = 0; i < header.max_subscribers; ++i) {
+        SharedSubscriberEntry& entry = region_->subscriber(i);
+        if (entry.state.load(std::memory_order_acquire) != detail::kEntryActive
+            || !process_gone(entry.pid.load(std::memory_order_relaxed)))
+            continue;
+        header.active.fetch_and(~(std::uint64_t{1} << i), std::memory_order_seq_cst);
+        region_->release_all(i);
+        entry.state.store(detail::kEntryFree, std::memory_order_release);
+        ++reaped;
+    }
+    return reaped;
+}
+
+std::size_t FramePublisher::subscribers() const noexcept
+{
+    return static_cast<std::size_t>(std::popcount(region_->header().active.load(std::memory_order_relaxed)));
+}
+
+FrameHandle FramePublisher::claim_free() noexcept
+{
+    const std::size_t count = region_->header().slot_count;
+    for (std::size_t i = 0; i < count; ++i) {
+        SharedSlot& slot = region_->slot(i);
+        const std::uint64_t readers = slot.readers.load(std::memory_order_acquire);
+        if (readers != 0) {
+            // Whatever the eviction policy, bits of departed subscribers would pin the buffer forever.
+            const std::uint64_t position = slot.position.load(std::memory_order_relaxed);
+            for (std::uint64_t left = readers; left != 0; left &= left - 1) {
+                const unsigned index = static_cast<unsigned>(std::countr_zero(left));
+                if (region_->departed(index, position))
+                    slot.readers.fetch_and(~(std::uint64_t{1} << index), std::memory_order_acq_rel);
+            }
+            if (slot.readers.load(std::memory_order_acquire) != 0)
+                continue;
+        }
+        if (FrameHandle buffer = pool_->claim(static_cast<std::uint32_t>(i)))
+            return buffer;
+    }
+    return {};
+}
+
+bool FramePublisher::evict() noexcept
+{
+    const SharedHeader& header = region_->header();
+    // Visit pinned buffers oldest first, so that moving a subscriber's cursor past a frame
+    // never skips an older frame it still has pending.
+    std::uint64_t after = 0;
+    bool first = true;
+    for (;;) {
+        std::size_t oldest = header.slot_count;
+        std::uint64_t oldest_position = 0;
+        for (std::size_t i = 0; i < header.slot_count; ++i) {
+            const SharedSlot& slot = region_->slot(i);
+            const std::uint64_t position = slot.position.load(std::memory_order_relaxed);
+            if (slot.readers.load(std::memory_order_acquire) == 0 || (!first && position <= after))
+                continue;
+            if (oldest == header.slot_count || position < oldest_position) {
+                oldest = i;
+                oldest_position = position;
+            }
+        }
+        if (oldest == header.slot_count)
+            return false;
+
+        SharedSlot& slot = region_->slot(oldest);
+        std::uint64_t readers = slot.readers.load(std::memory_order_acquire);
+        while (readers != 0) {
+            const unsigned index = static_cast<unsigned>(std::countr_zero(readers));
+            const std::uint64_t bit = std::uint64_t{1} << index;
+            readers &= ~bit;
+            if (region_->departed(index, oldest_position)) {
+                slot.readers.fetch_and(~bit, std::memory_order_acq_rel);
+                continue;
+            }
+            SharedSubscriberEntry& entry = region_->subscriber(index);
+            std::uint64_t cursor = entry.cursor.load(std::memory_order_acquire);
+            while (cursor <= oldest_position) {
+                if (entry.cursor.compare_exchange_weak(cursor, oldest_position + 1, std::memory_order_acq_rel)) {
+                    slot.readers.fetch_and(~bit, std::memory_order_acq_rel);
+                    entry.dropped.fetch_add(1, std::memory_order_relaxed);
+                    ++evicted_;
+                    break;
+                }
+            }
+        }
+        if (slot.readers.load(std::memory_order_acquire) == 0)
+            return true;
+        after = oldest_position;
+        first = false;
+    }
+}
+
+void FramePublisher::wake() noexcept
+{
+    SharedHeader& header = region_->header();
+    header.wake_seq.fetch_add(1, std::memory_order_seq_cst);
+    if (header.waiters.load(std::memory_order_seq_cst) != 0)
+        futex_wake(header.wake_seq);
+}
+
+FrameSubscriber::FrameSubscriber(const std::string& name)
+{
+    const int fd = ::shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+    if (fd < 0)
+        throw_errno("FrameSubscriber: shm_open");
+    try {
+        attach(fd);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+}
+
+FrameSubscriber::FrameSubscriber(int fd)
+{
+    attach(fd);
+}
+
+FrameSubscriber::~FrameSubscriber()
+{
+    // Stop receiving now; buffers still held through handles are released with them.
+    attachment_->region->header().active.fetch_and(~attachment_->bit, std::memory_order_seq_cst);
+    pool_.reset();
+    attachment_.reset();
+}
+
+void FrameSubscriber::attach(int fd)
+{
+    struct stat st{};
+    if (::fstat(fd, &st) != 0)
+        throw_errno("FrameSubscriber: fstat");
+    auto region = std::make_shared<SharedRegion>();
+    if (static_cast<std::size_t>(st.st_size) < sizeof(SharedHeader))
+        throw std::runtime_error("FrameSubscriber: not a frame region");
+    region->size = static_cast<std::size_t>(st.st_size);
+    void* p = ::mmap(nullptr, region->size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    if (p == MAP_FAILED)
+        throw_errno("FrameSubscriber: mmap");
+    region->base = static_cast<std::byte*>(p);
+
+    SharedHeader& header = region->header();
+    if (magic_of(header) != detail::kSharedMagic)
+        throw std::runtime_error("FrameSubscriber: not a frame region");
+    if (header.version != detail::kSharedVersion)
+        throw std::runtime_error("FrameSubscriber: unsupported region version");
+    if (header.size > region->size || region->lay_out(header) != header.data_offset)
+        throw std::runtime_error("FrameSubscriber: inconsistent region header");
+
+    unsigned index = 0;
+    for (;; ++index) {
+        if (index == header.max_subscribers)
+            throw std::runtime_error("FrameSubscriber: no free subscriber entry");
+        std::uint32_t expected = detail::kEntryFree;
+        if (region->subscriber(index).state.compare_exchange_strong(expected, detail::kEntryActive,
+                                                                    std::memory_order_acq_rel))
+            break;
+    }
+    auto attachment = std::make_shared<detail::SharedAttachment>();
+    attachment->region = region;
+    attachment->index = index;
+    attachment->bit = std::uint64_t{1} << index;
+
+    SharedSubscriberEntry& entry = region->subscriber(index);
+    entry.pid.store(static_cast<std::int32_t>(::getpid()), std::memory_order_relaxed);
+    entry.dropped.store(0, std::memory_order_relaxed);
+    // Cursor first: a frame being published concurrently either carries our bit or is
+    // recognised as not ours and skipped.
+    const std::uint64_t head = header.head.load(std::memory_order_seq_cst);
+    entry.joined_at.store(head, std::memory_order_relaxed);
+    entry.cursor.store(head, std::memory_order_seq_cst);
+    header.active.fetch_or(attachment->bit, std::memory_order_seq_cst);
+
+    pool_ = std::make_unique<FrameBufferPool>(region->buffers(), [attachment](std::uint32_t slot) {
+        attachment->region->slot(slot).readers.fetch_and(~attachment->bit, std::memory_order_acq_rel);
+    });
+    attachment_ = std::move(attachment);
+}
+
+FrameHandle FrameSubscriber::try_next() noexcept
+{
+    const SharedRegion& region = *attachment_->region;
+    const SharedHeader& header = region.header();
+    SharedSubscriberEntry& entry = region.subscriber(attachment_->index);
+    for (;;) {
+        std::uint64_t cursor = entry.cursor.load(std::memory_order_acquire);
+        if (cursor >= header.head.load(std::memory_order_acquire))
+            return {};
+        const std::uint64_t value = region.ring(cursor).load(std::memory_order_acquire);
+        const std::uint32_t index = static_cast<std::uint32_t>(value & detail::kSlotMask);
+        // Losing the race means the publisher evicted the frame; start over from the new cursor.
+        if (!entry.cursor.compare_exchange_strong(cursor, cursor + 1, std::memory_order_acq_rel))
+            continue;
+        SharedSlot& slot = region.slot(index);
+        if ((value >> detail::kSlotBits) != cursor) {
+            // Overwritten before we got to it; give back the frame if it was ours.
+            entry.dropped.fetch_add(1, std::memory_order_relaxed);
+            for (std::size_t i = 0; i < header.slot_count; ++i) {
+                SharedSlot& lost = region.slot(i);
+                if ((lost.readers.load(std::memory_order_acquire) & attachment_->bit) != 0
+                    && lost.position.load(std::memory_order_relaxed) == cursor)
+                    lost.readers.fetch_and(~attachment_->bit, std::memory_order_acq_rel);
+            }
+            continue;
+        }
+        // Frames published while we were joining do not carry our bit.
+        if ((slot.readers.load(std::memory_order_acquire) & attachment_->bit) == 0
+            || slot.position.load(std::memory_order_relaxed) != cursor)
+            continue;
+        FrameHandle frame = pool_->claim(index);
+        if (!frame)
+            continue;
+        frame.info() = slot.info;
+        ++received_;
+        return frame;
+    }
+}
+
+FrameHandle FrameSubscriber::next(std::chrono::nanoseconds timeout)
+{
+    SharedHeader& header = attachment_->region->header();
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        if (FrameHandle frame = try_next())
+            return frame;
+        // The final frames are published before the close flag is set.
+        if (closed())
+            return try_next();
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::nanoseconds::zero())
+            return {};
+        const std::uint32_t seq = header.wake_seq.load(std::memory_order_seq_cst);
+        header.waiters.fetch_add(1, std::memory_order_seq_cst);
+        FrameHandle frame = try_next();
+        if (!frame && !closed())
+            futex_wait(header.wake_seq, seq, std::chrono::duration_cast<std::chrono::nanoseconds>(remaining));
+        header.waiters.fetch_sub(1, std::memory_order_relaxed);
+        if (frame)
+            return frame;
+    }
+}
+
+bool FrameSubscriber::closed() const noexcept
+{
+    return attachment_->region->header().closed.load(std::memory_order_acquire) != 0;
+}
+
+std::uint64_t FrameSubscriber::dropped() const noexcept
+{
+    return attachment_->region->subscriber(attachment_->index).dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace camera_interface
@@ -0,0 +1,203 @@
+#include "camera_interface/simulated_camera.hpp"
+
+#include "camera_interface/clock.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace camera_interface {
+
+namespace {
+
+std::uint64_t splitmix64(std::uint64_t x) noexcept
+{
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+/// Uniform in [0, 1), a pure function of (seed, sequence, stream) so timing is reproducible.
+double unit_random(std::uint64_t seed, std::uint64_t sequence, std::uint64_t stream) noexcept
+{
+    const std::uint64_t bits = splitmix64(seed ^ splitmix64(sequence * 2 + stream));
+    return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+FrameBufferPool::Config pool_config(const SimulatedCameraConfig& config)
+{
+    if (config.frame_rate <= 0.0)
+        throw std::invalid_argument("SimulatedCamera: frame_rate must be positive");
+    if (config.format.width == 0 || config.format.height == 0 || config.format.stride == 0)
+        throw std::invalid_argument("SimulatedCamera: empty frame format");
+    check_placement(config.placement);
+    FrameBufferPool::Config pool;
+    pool.capacity = config.pool_capacity;
+    pool.buffer_size = config.format.frame_size();
+    pool.numa_node = config.placement.memory_node();
+    return pool;
+}
+
+} // namespace
+
+SimulatedCamera::SimulatedCamera(const SimulatedCameraConfig& config)
+    : Camera(config.delivery), config_(config), pool_(pool_config(config)), frame_rate_(config.frame_rate),
+      format_(config.format)
+{
+    if (config_.pattern == TestPattern::gradient) {
+        // One row plus a full period of offsets, so every row of every frame is a single memcpy.
+        ramp_.resize(config_.format.stride + 256);
+        for (std::size_t i = 0; i < ramp_.size(); ++i)
+            ramp_[i] = static_cast<std::byte>(i);
+    }
+}
+
+SimulatedCamera::~SimulatedCamera()
+{
+    stop();
+}
+
+void SimulatedCamera::start()
+{
+    if (thread_.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_.store(false, std::memory_order_relaxed);
+    }
+    open_delivery();
+    thread_ = std::thread([this] { run(); });
+}
+
+void SimulatedCamera::stop()
+{
+    if (!thread_.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_requested_.store(true, std::memory_order_relaxed);
+    }
+    wake_.notify_all();
+    close_delivery();
+    thread_.join();
+}
+
+StreamFormat SimulatedCamera::format() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return format_;
+}
+
+bool SimulatedCamera::set_frame_rate(double frame_rate) noexcept
+{
+    if (!(frame_rate > 0.0))
+        return false;
+    frame_rate_.store(frame_rate, std::memory_order_relaxed);
+    return true;
+}
+
+bool SimulatedCamera::set_window(const SensorWindow& window) noexcept
+{
+    const StreamFormat& full = config_.format;
+    const Rect roi = window.roi.value_or(Rect{0, 0, full.width, full.height});
+    if (window.binning == 0 || roi.x > full.width || roi.width > full.width - roi.x || roi.y > full.height
+        || roi.height > full.height - roi.y)
+        return false;
+    std::uint32_t width = roi.width / window.binning;
+    std::uint32_t height = roi.height / window.binning;
+    const PixelFormat f = full.format;
+    if (is_bayer(f) || f == PixelFormat::yuyv || f == PixelFormat::uyvy || f == PixelFormat::nv12
+        || f == PixelFormat::i420) {
+        width &= ~1u;
+        height &= ~1u;
+    }
+    if (width == 0 || height == 0)
+        return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    format_ = StreamFormat::packed(width, height, full.format);
+    return true;
+}
+
+void SimulatedCamera::run()
+{
+    if (config_.placement.cpu >= 0)
+        pin_current_thread(config_.placement.cpu);
+    std::int64_t period = static_cast<std::int64_t>(1e9 / frame_rate_.load(std::memory_order_relaxed));
+    const std::int64_t jitter = config_.jitter.count();
+    const std::int64_t origin = monotonic_now_ns() + period;
+    const auto clock_origin = std::chrono::steady_clock::now() + std::chrono::nanoseconds(period);
+    std::int64_t previous = origin - period;
+    // The nominal schedule restarts from here whenever the frame rate changes.
+    std::int64_t schedule_origin = origin;
+    std::uint64_t schedule_sequence = 0;
+
+    for (std::uint64_t sequence = 0;; ++sequence) {
+        const auto wanted = static_cast<std::int64_t>(1e9 / frame_rate_.load(std::memory_order_relaxed));
+        if (wanted != period) {
+            schedule_origin += static_cast<std::int64_t>(sequence - schedule_sequence) * period - period + wanted;
+            schedule_sequence = sequence;
+            period = wanted;
+        }
+        const double deviation = unit_random(config_.seed, sequence, 0) * 2.0 - 1.0;
+        const std::int64_t nominal = schedule_origin + static_cast<std::int64_t>(sequence - schedule_sequence) * period;
+        const std::int64_t timestamp =
+            std::max(nominal + static_cast<std::int64_t>(deviation * static_cast<double>(jitter)), previous + 1);
+        previous = timestamp;
+
+        if (config_.realtime) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            const auto deadline = clock_origin + std::chrono::nanoseconds(timestamp - origin);
+            const auto stopping = [this] { return stop_requested_.load(std::memory_order_relaxed); };
+            if (wake_.wait_until(lock, deadline, stopping))
+                return;
+        } else if (stop_requested_.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        if (unit_random(config_.seed, sequence, 1) < config_.drop_probability) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        FrameHandle frame = pool_.acquire();
+        while (!frame && !config_.realtime) {
+            std::this_thread::yield();
+            if (stop_requested_.load(std::memory_order_relaxed))
+                return;
+            frame = pool_.acquire();
+        }
+        if (!frame) {
+            starved_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        const StreamFormat format = this->format();
+        fill(frame, format, sequence);
+        FrameInfo& info = frame.info();
+        info.format = format;
+        info.sequence = sequence;
+        info.timestamp_ns = timestamp;
+        info.bytes_used = format.frame_size();
+        info.exposure_us = static_cast<std::uint32_t>(
+            config_.exposure.count() != 0 ? config_.exposure.count() : period / 1000);
+        info.gain = config_.gain;
+        produced_.fetch_add(1, std::memory_order_relaxed);
+        deliver(std::move(frame));
+    }
+}
+
+void SimulatedCamera::fill(FrameHandle& frame, const StreamFormat& format, std::uint64_t sequence) noexcept
+{
+    if (config_.pattern != TestPattern::gradient)
+        return;
+    const std::size_t size = format.frame_size();
+    const std::size_t rows = (size + format.stride - 1) / format.stride;
+    for (std::size_t y = 0; y < rows; ++y) {
+        const std::size_t begin = y * format.stride;
+        const std::size_t length = std::min(format.stride, size - begin);
+        std::memcpy(frame.data() + begin, ramp_.data() + ((y + sequence) & 0xff), length);
+    }
+}
+
+} // namespace camera_interface
@@ -0,0 +1,137 @@
+#include "camera_interface/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace camera_interface {
+
+namespace {
+
+/// Pool and deque index of the calling thread when it is a worker.
+struct CurrentWorker {
+    const ThreadPool* pool = nullptr;
+    unsigned index = 0;
+};
+
+thread_local CurrentWorker current_worker;
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i)
+        workers_.push_back(std::make_unique<Worker>());
+    for (unsigned i = 0; i < threads; ++i)
+        workers_[i]->thread = std::thread([this, i] { run_worker(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    stopping_.store(true, std::memory_order_seq_cst);
+    work_epoch_.fetch_add(1, std::memory_order_seq_cst);
+    work_epoch_.notify_all();
+    for (auto& worker : workers_)
+        worker->thread.join();
+    // Tasks posted while the workers were exiting.
+    while (run_one()) {
+    }
+}
+
+void ThreadPool::post(TaskFn fn, void* context, std::size_t index)
+{
+    const unsigned target = current_worker.pool == this ? current_worker.index
+                                                        : next_.fetch_add(1, std::memory_order_relaxed) % size();
+    {
+        std::lock_guard lock(workers_[target]->mutex);
+        workers_[target]->tasks.push_back(Task{fn, context, index});
+    }
+    work_epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) != 0)
+        work_epoch_.notify_one();
+}
+
+bool ThreadPool::run_one() noexcept
+{
+    Task task;
+    const bool local = current_worker.pool == this;
+    if (local ? pop_local(current_worker.index, task) || steal(current_worker.index + 1, task) : steal(0, task)) {
+        task.fn(task.context, task.index);
+        return true;
+    }
+    return false;
+}
+
+bool ThreadPool::pop_local(unsigned self, Task& task) noexcept
+{
+    Worker& worker = *workers_[self];
+    std::lock_guard lock(worker.mutex);
+    if (worker.tasks.empty())
+        return false;
+    task = worker.tasks.back();
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(unsigned start, Task& task) noexcept
+{
+    const unsigned n = size();
+    for (unsigned k = 0; k < n; ++k) {
+        const unsigned victim = (start + k) % n;
+        Worker& worker = *workers_[victim];
+        std::lock_guard lock(worker.mutex);
+        if (worker.tasks.empty())
+            continue;
+        task = worker.tasks.front();
+        worker.tasks.pop_front();
+        if (current_worker.pool == this && victim != current_worker.index)
+            steals_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void ThreadPool::run_worker(unsigned self)
+{
+    current_worker = CurrentWorker{this, self};
+    for (;;) {
+        if (run_one())
+            continue;
+        // Announce the sleep before sampling the epoch: a poster that bumps the epoch after
+        // this point is guaranteed to see the sleeper and notify.
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        const std::uint32_t epoch = work_epoch_.load(std::memory_order_seq_cst);
+        if (run_one()) {
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            continue;
+        }
+        if (stopping_.load(std::memory_order_seq_cst)) {
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+            break;
+        }
+        work_epoch_.wait(epoch, std::memory_order_seq_cst);
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    current_worker = CurrentWorker{};
+}
+
+void ThreadPool::wait_for(const std::atomic<std::size_t>& remaining) noexcept
+{
+    while (remaining.load(std::memory_order_acquire) != 0) {
+        if (run_one())
+            continue;
+        const std::uint32_t epoch = completion_epoch_.load(std::memory_order_seq_cst);
+        if (remaining.load(std::memory_order_seq_cst) == 0)
+            break;
+        completion_epoch_.wait(epoch, std::memory_order_seq_cst);
+    }
+}
+
+void ThreadPool::notify_completion() noexcept
+{
+    completion_epoch_.fetch_add(1, std::memory_order_seq_cst);
+    completion_epoch_.notify_all();
+}
+
+} // namespace camera_interface
@@ -0,0 +1,344 @@
+#include "camera_interface/v4l2_camera.hpp"
+
+#include "camera_interface/clock.hpp"
+
+#include <cerrno>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace camera_interface {
+
+namespace {
+
+[[noreturn]] void throw_errno(const char* what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+double frame_rate_of(const v4l2_streamparm& parm) noexcept
+{
+    const v4l2_fract& tpf = parm.parm.capture.timeperframe;
+    return tpf.numerator != 0 ? static_cast<double>(tpf.denominator) / tpf.numerator : 0.0;
+}
+
+/// VIDIOC_S_PARM; the driver may round to a rate it supports. Returns the rate it picked,
+/// or 0 if it does not support setting one.
+double request_frame_rate(V4l2Io& io, double frame_rate) noexcept
+{
+    v4l2_streamparm parm{};
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    parm.parm.capture.timeperframe.numerator = 1000;
+    parm.parm.capture.timeperframe.denominator = static_cast<__u32>(std::lround(frame_rate * 1000.0));
+    if (io.ioctl(VIDIOC_S_PARM, &parm) < 0 || !(parm.parm.capture.capability & V4L2_CAP_TIMEPERFRAME))
+        return 0.0;
+    return frame_rate_of(parm);
+}
+
+} // namespace
+
+/// Device state shared with the pool's release hook, so a frame released after the camera
+/// is gone still finds valid mappings (and simply is not re-queued).
+struct V4l2Camera::Device {
+    struct Mapping {
+        void* address = MAP_FAILED;
+        std::size_t length = 0;
+        int dmabuf_fd = -1;
+    };
+
+    std::unique_ptr<V4l2Io> io;
+    V4l2Memory memory = V4l2Memory::mmap;
+    std::vector<Mapping> mappings;
+
+    std::mutex mutex;
+    bool streaming = false;
+    std::vector<bool> in_driver;
+    std::vector<bool> held;
+
+    ~Device()
+    {
+        for (const Mapping& mapping : mappings) {
+            if (mapping.address == MAP_FAILED)
+                continue;
+            if (memory == V4l2Memory::mmap)
+                io->munmap(mapping.address, mapping.length);
+            else
+                ::munmap(mapping.address, mapping.length);
+        }
+        v4l2_requestbuffers req{};
+        req.count = 0;
+        req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        req.memory = memory == V4l2Memory::mmap ? V4L2_MEMORY_MMAP : V4L2_MEMORY_DMABUF;
+        io->ioctl(VIDIOC_REQBUFS, &req);
+    }
+
+    /// Requires `mutex`.
+    bool queue(std::uint32_t index) noexcept
+    {
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.index = index;
+        if (memory == V4l2Memory::mmap) {
+            buf.memory = V4L2_MEMORY_MMAP;
+        } else {
+            buf.memory = V4L2_MEMORY_DMABUF;
+            buf.m.fd = mappings[index].dmabuf_fd;
+            buf.length = static_cast<__u32>(mappings[index].length);
+        }
+        if (io->ioctl(VIDIOC_QBUF, &buf) < 0)
+            return false;
+        in_driver[index] = true;
+        return true;
+    }
+
+    void release(std::uint32_t index) noexcept
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        held[index] = false;
+        if (streaming)
+            queue(index);
+    }
+};
+
+V4l2Camera::V4l2Camera(const V4l2Config& config, std::shared_ptr<Poller> poller)
+    : V4l2Camera(open_v4l2_device(config.device), config, std::move(poller))
+{
+}
+
+V4l2Camera::V4l2Camera(std::unique_ptr<V4l2Io> io, const V4l2Config& config, std::shared_ptr<Poller> poller)
+    : Camera(config.delivery), device_(std::make_shared<Device>()), poller_(std::move(poller)),
+      poller_cpu_(config.placement.cpu)
+{
+    check_placement(config.placement);
+    device_->io = std::move(io);
+    device_->memory = config.memory;
+    if (!poller_)
+        poller_ = std::make_shared<Poller>();
+    configure(config);
+}
+
+V4l2Camera::~V4l2Camera()
+{
+    stop();
+}
+
+void V4l2Camera::configure(const V4l2Config& config)
+{
+    V4l2Io& io = *device_->io;
+
+    v4l2_capability cap{};
+    if (io.ioctl(VIDIOC_QUERYCAP, &cap) < 0)
+        throw_errno("VIDIOC_QUERYCAP");
+    const std::uint32_t caps = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+    if (!(caps & V4L2_CAP_VIDEO_CAPTURE) || !(caps & V4L2_CAP_STREAMING))
+        throw std::invalid_argument("V4l2Camera: device does not support streaming capture");
+
+    v4l2_format fmt{};
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (io.ioctl(VIDIOC_G_FMT, &fmt) < 0)
+        throw_errno("VIDIOC_G_FMT");
+    if (config.width != 0 && config.height != 0) {
+        fmt.fmt.pix.width = config.width;
+        fmt.fmt.pix.height = config.height;
+    }
+    fmt.fmt.pix.pixelformat = to_v4l2_fourcc(config.format);
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+    fmt.fmt.pix.bytesperline = 0;
+    if (io.ioctl(VIDIOC_S_FMT, &fmt) < 0)
+        throw_errno("VIDIOC_S_FMT");
+    const auto negotiated = from_v4l2_fourcc(fmt.fmt.pix.pixelformat);
+    if (!negotiated)
+        throw std::invalid_argument("V4l2Camera: driver selected an unsupported pixel format");
+    format_ = StreamFormat{fmt.fmt.pix.width, fmt.fmt.pix.height, *negotiated, fmt.fmt.pix.bytesperline};
+    if (format_.stride == 0)
+        format_.stride = min_stride(format_.format, format_.width);
+
+    // Not every driver lets the rate be set; keep streaming at whatever it runs.
+    if (config.frame_rate > 0.0)
+        request_frame_rate(io, config.frame_rate);
+    v4l2_streamparm parm{};
+    parm.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (io.ioctl(VIDIOC_G_PARM, &parm) == 0)
+        frame_rate_.store(frame_rate_of(parm), std::memory_order_relaxed);
+
+    const bool dmabuf = config.memory == V4l2Memory::dmabuf;
+    if (dmabuf && config.dmabuf_fds.size() < config.buffer_count)
+        throw std::invalid_argument("V4l2Camera: one DMABUF descriptor required per buffer");
+
+    v4l2_requestbuffers req{};
+    req.count = config.buffer_count;
+    req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    req.memory = dmabuf ? V4L2_MEMORY_DMABUF : V4L2_MEMORY_MMAP;
+    if (io.ioctl(VIDIOC_REQBUFS, &req) < 0)
+        throw_errno("VIDIOC_REQBUFS");
+    if (req.count == 0)
+        throw std::runtime_error("V4l2Camera: driver granted no buffers");
+
+    device_->mappings.resize(req.count);
+    device_->in_driver.assign(req.count, false);
+    device_->held.assign(req.count, false);
+    std::vector<BufferRegion> regions(req.count);
+    for (std::uint32_t i = 0; i < req.count; ++i) {
+        Device::Mapping& mapping = device_->mappings[i];
+        if (dmabuf) {
+            const int fd = config.dmabuf_fds[i];
+            const off_t size = ::lseek(fd, 0, SEEK_END);
+            if (size <= 0)
+                throw_errno("lseek dmabuf");
+            mapping.dmabuf_fd = fd;
+            mapping.length = static_cast<std::size_t>(size);
+            mapping.address = ::mmap(nullptr, mapping.length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        } else {
+            v4l2_buffer buf{};
+            buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            buf.memory = V4L2_MEMORY_MMAP;
+            buf.index = i;
+            if (io.ioctl(VIDIOC_QUERYBUF, &buf) < 0)
+                throw_errno("VIDIOC_QUERYBUF");
+            mapping.length = buf.length;
+            mapping.address = io.mmap(buf.length, buf.m.offset);
+        }
+        if (mapping.address == MAP_FAILED)
+            throw_errno("mmap");
+        regions[i] = BufferRegion{static_cast<std::byte*>(mapping.address), mapping.length};
+    }
+
+    pool_ = std::make_unique<FrameBufferPool>(
+        std::move(regions), [device = device_](std::uint32_t index) { device->release(index); });
+}
+
+void V4l2Camera::start()
+{
+    if (is_streaming())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(device_->mutex);
+        for (std::uint32_t i = 0; i < device_->mappings.size(); ++i) {
+            if (!device_->held[i] && !device_->in_driver[i] && !device_->queue(i))
+                throw_errno("VIDIOC_QBUF");
+        }
+        int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        if (device_->io->ioctl(VIDIOC_STREAMON, &type) < 0)
+            throw_errno("VIDIOC_STREAMON");
+        device_->streaming = true;
+    }
+    have_sequence_ = false;
+    read_controls();
+    open_delivery();
+    streaming_.store(true, std::memory_order_release);
+    poller_->add(fd(), EPOLLIN, [this](std::uint32_t) { service(); });
+    if (!poller_->running())
+        poller_->start(poller_cpu_);
+}
+
+void V4l2Camera::stop()
+{
+    if (!is_streaming())
+        return;
+    poller_->remove(fd());
+    streaming_.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(device_->mutex);
+        int type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        device_->io->ioctl(VIDIOC_STREAMOFF, &type);
+        device_->streaming = false;
+        device_->in_driver.assign(device_->in_driver.size(), false);
+    }
+    close_delivery();
+}
+
+void V4l2Camera::service()
+{
+    for (;;) {
+        v4l2_buffer buf{};
+        buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buf.memory = device_->memory == V4l2Memory::mmap ? V4L2_MEMORY_MMAP : V4L2_MEMORY_DMABUF;
+        {
+            std::lock_guard<std::mutex> lock(device_->mutex);
+            if (!device_->streaming || device_->io->ioctl(VIDIOC_DQBUF, &buf) < 0)
+                return;
+            device_->in_driver[buf.index] = false;
+            device_->held[buf.index] = true;
+        }
+        const std::int64_t dequeued_ns = monotonic_now_ns();
+
+        if (have_sequence_ && buf.sequence - last_sequence_ > 1)
+            driver_drops_.fetch_add(buf.sequence - last_sequence_ - 1, std::memory_order_relaxed);
+        have_sequence_ = true;
+        last_sequence_ = buf.sequence;
+
+        FrameHandle frame = pool_->claim(buf.index);
+        if (!frame) {
+            device_->release(buf.index);
+            continue;
+        }
+        // Errored buffers go straight back to the driver when `frame` is dropped.
+        if (buf.flags & V4L2_BUF_FLAG_ERROR)
+            continue;
+
+        FrameInfo& info = frame.info();
+        info.format = format_;
+        info.sequence = buf.sequence;
+        info.timestamp_ns = static_cast<std::int64_t>(buf.timestamp.tv_sec) * 1'000'000'000
+                          + static_cast<std::int64_t>(buf.timestamp.tv_usec) * 1000;
+        if (info.timestamp_ns == 0)
+            info.timestamp_ns = dequeued_ns;
+        info.host_timestamp_ns = dequeued_ns;
+        info.bytes_used = buf.bytesused != 0 ? buf.bytesused : format_.frame_size();
+        info.exposure_us = exposure_us_;
+        info.gain = gain_;
+        deliver(std::move(frame));
+    }
+}
+
+bool V4l2Camera::set_frame_rate(double frame_rate) noexcept
+{
+    if (!(frame_rate > 0.0))
+        return false;
+    std::lock_guard<std::mutex> lock(device_->mutex);
+    const double selected = request_frame_rate(*device_->io, frame_rate);
+    if (selected <= 0.0)
+        return false;
+    frame_rate_.store(selected, std::memory_order_relaxed);
+    return true;
+}
+
+void V4l2Camera::read_controls() noexcept
+{
+    // Drivers without these controls simply report 0 ("unknown").
+    v4l2_control control{};
+    control.id = V4L2_CID_EXPOSURE_ABSOLUTE;
+    exposure_us_ = device_->io->ioctl(VIDIOC_G_CTRL, &control) == 0 && control.value > 0
+                     ? static_cast<std::uint32_t>(control.value) * 100 // 100 us units
+                     : 0;
+    control = v4l2_control{};
+    control.id = V4L2_CID_GAIN;
+    gain_ = device_->io->ioctl(VIDIOC_G_CTRL, &control) == 0 ? static_cast<float>(control.value) : 0.0f;
+}
+
+int V4l2Camera::fd() const noexcept
+{
+    return device_->io->fd();
+}
+
+int V4l2Camera::export_dmabuf(std::uint32_t index) const
+{
+    if (device_->memory != V4l2Memory::mmap)
+        throw std::logic_error("V4l2Camera: only MMAP buffers can be exported");
+    v4l2_exportbuffer exp{};
+    exp.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    exp.index = index;
+    exp.flags = O_RDWR | O_CLOEXEC;
+    if (device_->io->ioctl(VIDIOC_EXPBUF, &exp) < 0)
+        throw_errno("VIDIOC_EXPBUF");
+    return exp.fd;
+}
+
+} // namespace camera_interface
@@ -0,0 +1,423 @@
+#include "camera_interface/v4l2_enumeration.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <dirent.h>
+#include <linux/videodev2.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace camera_interface {
+
+namespace {
+
+constexpr const char* kCacheHeader = "camera_interface v4l2 capability cache 1";
+
+[[noreturn]] void throw_errno(const char* what)
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+std::string field(const __u8* text, std::size_t size)
+{
+    const auto* begin = reinterpret_cast<const char*>(text);
+    return std::string(begin, strnlen(begin, size));
+}
+
+double rate_of(const v4l2_fract& interval) noexcept
+{
+    return interval.numerator != 0 ? static_cast<double>(interval.denominator) / interval.numerator : 0.0;
+}
+
+std::vector<double> frame_rates(V4l2Io& io, std::uint32_t fourcc, std::uint32_t width, std::uint32_t height)
+{
+    std::vector<double> rates;
+    v4l2_frmivalenum interval{};
+    interval.pixel_format = fourcc;
+    interval.width = width;
+    interval.height = height;
+    for (; io.ioctl(VIDIOC_ENUM_FRAMEINTERVALS, &interval) == 0; ++interval.index) {
+        if (interval.type == V4L2_FRMIVAL_TYPE_DISCRETE) {
+            rates.push_back(rate_of(interval.discrete));
+        } else {
+            // Longest interval is the slowest rate.
+            rates.push_back(rate_of(interval.stepwise.max));
+            rates.push_back(rate_of(interval.stepwise.min));
+            break;
+        }
+    }
+    return rates;
+}
+
+std::vector<V4l2FrameSize> frame_sizes(V4l2Io& io, std::uint32_t fourcc)
+{
+    std::vector<V4l2FrameSize> sizes;
+    v4l2_frmsizeenum size{};
+    size.pixel_format = fourcc;
+    for (; io.ioctl(VIDIOC_ENUM_FRAMESIZES, &size) == 0; ++size.index) {
+        if (size.type == V4L2_FRMSIZE_TYPE_DISCRETE) {
+            sizes.push_back(V4l2FrameSize{size.discrete.width, size.discrete.height, {}});
+        } else {
+            sizes.push_back(V4l2FrameSize{size.stepwise.min_width, size.stepwise.min_height, {}});
+            sizes.push_back(V4l2FrameSize{size.stepwise.max_width, size.stepwise.max_height, {}});
+            break;
+        }
+    }
+    for (V4l2FrameSize& s : sizes)
+        s.frame_rates = frame_rates(io, fourcc, s.width, s.height);
+    return sizes;
+}
+
+std::vector<V4l2ControlInfo> controls(V4l2Io& io)
+{
+    std::vector<V4l2ControlInfo> controls;
+    v4l2_queryctrl query{};
+    query.id = V4L2_CTRL_FLAG_NEXT_CTRL;
+    while (io.ioctl(VIDIOC_QUERYCTRL, &query) == 0) {
+        if (!(query.flags & V4L2_CTRL_FLAG_DISABLED) && query.type != V4L2_CTRL_TYPE_CTRL_CLASS)
+            controls.push_back(V4l2ControlInfo{query.id, query.type, field(query.name, sizeof query.name),
+                                               query.minimum, query.maximum, query.step, query.default_value,
+                                               query.flags});
+        query.id |= V4L2_CTRL_FLAG_NEXT_CTRL;
+    }
+    return controls;
+}
+
+// Cache file: one record per device, every field tab-separated on tagged lines:
+//
+//     device <path> <driver> <card> <bus_info> <version> <device_number> <capabilities>
+//     format <fourcc> <description>
+//     size <width> <height> <rate>...
+//     control <id> <type> <minimum> <maximum> <step> <default> <flags> <name>
+//     end
+
+std::string clean(std::string text)
+{
+    std::replace_if(text.begin(), text.end(), [](char c) { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+    return text;
+}
+
+std::vector<std::string> split(const std::string& line)
+{
+    std::vector<std::string> fields;
+    std::size_t begin = 0;
+    for (;;) {
+        const std::size_t end = line.find('\t', begin);
+        fields.push_back(line.substr(begin, end - begin));
+        if (end == std::string::npos)
+            return fields;
+        begin = end + 1;
+    }
+}
+
+template <typename T>
+T number(const std::string& text)
+{
+    std::istringstream in(text);
+    in.imbue(std::locale::classic());
+    T value{};
+    if (!(in >> value) || !in.eof())
+        throw std::runtime_error("bad number");
+    return value;
+}
+
+std::map<std::string, V4l2DeviceInfo> parse_cache(std::istream& in)
+{
+    std::map<std::string, V4l2DeviceInfo> entries;
+    std::string line;
+    if (!std::getline(in, line) || line != kCacheHeader)
+        throw std::runtime_error("not a capability cache");
+    V4l2DeviceInfo* device = nullptr;
+    while (std::getline(in, line)) {
+        const std::vector<std::string> f = split(line);
+        const std::string& tag = f[0];
+        if (tag == "device" && f.size() == 8 && !device) {
+            V4l2DeviceInfo info;
+            info.path = f[1];
+            info.identity = V4l2DeviceIdentity{f[2], f[3], f[4], number<std::uint32_t>(f[5]),
+                                               number<std::uint64_t>(f[6])};
+            info.capabilities = number<std::uint32_t>(f[7]);
+            info.cached = true;
+            device = &(entries[info.path] = std::move(info));
+        } else if (tag == "format" && f.size() == 3 && device) {
+            device->formats.push_back(V4l2FormatInfo{number<std::uint32_t>(f[1]), f[2], {}});
+        } else if (tag == "size" && f.size() >= 3 && device && !device->formats.empty()) {
+            V4l2FrameSize size{number<std::uint32_t>(f[1]), number<std::uint32_t>(f[2]), {}};
+            for (std::size_t i = 3; i < f.size(); ++i)
+                size.frame_rates.push_back(number<double>(f[i]));
+            device->formats.back().sizes.push_back(std::move(size));
+        } else if (tag == "control" && f.size() == 9 && device) {
+            device->controls.push_back(V4l2ControlInfo{
+                number<std::uint32_t>(f[1]), number<std::uint32_t>(f[2]), f[8], number<std::int64_t>(f[3]),
+                number<std::int64_t>(f[4]), number<std::int64_t>(f[5]), number<std::int64_t>(f[6]),
+                number<std::uint32_t>(f[7])});
+        } else if (tag == "end" && f.size() == 1 && device) {
+            device = nullptr;
+        } else {
+            throw std::runtime_error("malformed capability cache");
+        }
+    }
+    if (device)
+        throw std::runtime_error("truncated capability cache");
+    return entries;
+}
+
+void write_cache(std::ostream& out, const std::map<std::string, V4l2DeviceInfo>& entries)
+{
+    out.imbue(std::locale::classic());
+    out.precision(17);
+    out << kCacheHeader << '\n';
+    for (const auto& [path, info] : entries) {
+        const V4l2DeviceIdentity& id = info.identity;
+        out << "device\t" << clean(path) << '\t' << clean(id.driver) << '\t' << clean(id.card) << '\t'
+            << clean(id.bus_info) << '\t' << id.version << '\t' << id.device_number << '\t' << info.capabilities
+            << '\n';
+        for (const V4l2FormatInfo& format : info.formats) {
+            out << "format\t" << format.fourcc << '\t' << clean(format.description) << '\n';
+            for (const V4l2FrameSize& size : format.sizes) {
+                out << "size\t" << size.width << '\t' << size.height;
+                for (const double rate : size.frame_rates)
+                    out << '\t' << rate;
+                out << '\n';
+            }
+        }
+        for (const V4l2ControlInfo& c : info.controls)
+            out << "control\t" << c.id << '\t' << c.type << '\t' << c.minimum << '\t' << c.maximum << '\t' << c.step
+                << '\t' << c.default_value << '\t' << c.flags << '\t' << clean(c.name) << '\n';
+        out << "end\n";
+    }
+}
+
+std::vector<std::string> scan_directory(const std::string& directory)
+{
+    std::vector<std::string> paths;
+    DIR* dir = ::opendir(directory.c_str());
+    if (!dir)
+        return paths;
+    while (const dirent* entry = ::readdir(dir)) {
+        if (std::strncmp(entry->d_name, "video", 5) == 0)
+            paths.push_back(directory + "/" + entry->d_name);
+    }
+    ::closedir(dir);
+    return paths;
+}
+
+V4l2DeviceIdentity identity_of(const v4l2_capability& cap, const std::string& path)
+{
+    V4l2DeviceIdentity identity;
+    identity.driver = field(cap.driver, sizeof cap.driver);
+    identity.card = field(cap.card, sizeof cap.card);
+    identity.bus_info = field(cap.bus_info, sizeof cap.bus_info);
+    identity.version = cap.version;
+    struct stat st{};
+    if (::stat(path.c_str(), &st) == 0 && S_ISCHR(st.st_mode))
+        identity.device_number = st.st_rdev;
+    return identity;
+}
+
+} // namespace
+
+bool V4l2DeviceInfo::can_capture() const noexcept
+{
+    return (capabilities & V4L2_CAP_VIDEO_CAPTURE) && (capabilities & V4L2_CAP_STREAMING);
+}
+
+V4l2DeviceIdentity query_v4l2_identity(V4l2Io& io, const std::string& path)
+{
+    v4l2_capability cap{};
+    if (io.ioctl(VIDIOC_QUERYCAP, &cap) < 0)
+        throw_errno("VIDIOC_QUERYCAP");
+    return identity_of(cap, path);
+}
+
+V4l2DeviceInfo probe_v4l2_device(V4l2Io& io, const std::string& path)
+{
+    v4l2_capability cap{};
+    if (io.ioctl(VIDIOC_QUERYCAP, &cap) < 0)
+        throw_errno("VIDIOC_QUERYCAP");
+    V4l2DeviceInfo info;
+    info.path = path;
+    info.identity = identity_of(cap, path);
+    info.capabilities = (cap.capabilities & V4L2_CAP_DEVICE_CAPS) ? cap.device_caps : cap.capabilities;
+
+    v4l2_fmtdesc desc{};
+    desc.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    for (; io.ioctl(VIDIOC_ENUM_FMT, &desc) == 0; ++desc.index)
+        info.formats.push_back(V4l2FormatInfo{desc.pixelformat, field(desc.description, sizeof desc.description),
+                                              frame_sizes(io, desc.pixelformat)});
+    info.controls = controls(io);
+    return info;
+}
+
+V4l2CapabilityCache::V4l2CapabilityCache(std::string path) : path_(std::move(path))
+{
+    std::ifstream in(path_);
+    if (!in)
+        return;
+    try {
+        entries_ = parse_cache(in);
+    } catch (const std::exception&) {
+        // Rebuilt from scratch; the next save overwrites the bad file.
+        entries_.clear();
+        dirty_ = true;
+    }
+}
+
+const V4l2DeviceInfo* V4l2CapabilityCache::find(const std::string& device_path,
+                                                const V4l2DeviceIdentity& identity) const
+{
+    const auto it = entries_.find(device_path);
+    return it != entries_.end() && it->second.identity == identity ? &it->second : nullptr;
+}
+
+void V4l2CapabilityCache::store(const V4l2DeviceInfo& info)
+{
+    V4l2DeviceInfo& entry = entries_[info.path];
+    V4l2DeviceInfo stored = info;
+    stored.cached = true;
+    if (entry.path.empty() || !(entry.identity == stored.identity) || entry.capabilities != stored.capabilities
+        || entry.formats != stored.formats || entry.controls != stored.controls) {
+        entry = std::move(stored);
+        dirty_ = true;
+    }
+}
+
+void V4l2CapabilityCache::erase(const std::string& device_path)
+{
+    if (entries_.erase(device_path) != 0)
+        dirty_ = true;
+}
+
+void V4l2CapabilityCache::retain(const std::vector<std::string>& device_paths)
+{
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (std::find(device_paths.begin(), device_paths.end(), it->first) == device_paths.end()) {
+            it = entries_.erase(it);
+            dirty_ = true;
+        } else {
+            ++it;
+        }
+    }
+}
+
+void V4l2CapabilityCache::save()
+{
+    std::ostringstream text;
+    write_cache(text, entries_);
+    const std::string contents = text.str();
+
+    // A name of its own, so that enumerations running concurrently never share a temporary file.
+    std::string temporary = path_ + ".XXXXXX";
+    int fd = ::mkstemp(temporary.data());
+    if (fd < 0)
+        throw_errno("V4l2CapabilityCache: open");
+    const auto fail = [&](const char* what) {
+        const int error = errno;
+        if (fd >= 0)
+            ::close(fd);
+        ::unlink(temporary.c_str());
+        throw std::system_error(error, std::generic_category(), what);
+    };
+    if (::fchmod(fd, 0644) != 0)
+        fail("V4l2CapabilityCache: chmod");
+    for (std::size_t written = 0; written < contents.size();) {
+        const ssize_t n = ::write(fd, contents.data() + written, contents.size() - written);
+        if (n < 0 && errno != EINTR)
+            fail("V4l2CapabilityCache: write");
+        if (n > 0)
+            written += static_cast<std::size_t>(n);
+    }
+    // On disk before the rename makes it visible, so a crash cannot leave a truncated cache.
+    if (::fsync(fd) != 0)
+        fail("V4l2CapabilityCache: fsync");
+    const int closed = ::close(fd);
+    fd = -1;
+    if (closed != 0)
+        fail("V4l2CapabilityCache: close");
+    if (::rename(temporary.c_str(), path_.c_str()) != 0)
+        fail("V4l2CapabilityCache: rename");
+    dirty_ = false;
+}
+
+V4l2Enumeration enumerate_v4l2_devices(const V4l2EnumerationConfig& config)
+{
+    std::vector<std::string> paths = config.paths.empty() ? scan_directory(config.directory) : config.paths;
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+
+    std::optional<V4l2CapabilityCache> cache;
+    if (!config.cache_path.empty())
+        cache.emplace(config.cache_path);
+
+    struct Result {
+        std::optional<V4l2DeviceInfo> info;
+        std::string error;
+    };
+    std::vector<Result> results(paths.size());
+    std::atomic<std::size_t> next{0};
+    // The cache is only read while workers run, so lookups need no lock.
+    auto work = [&] {
+        for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < paths.size();) {
+            try {
+                const std::unique_ptr<V4l2Io> io = config.open(paths[i]);
+                if (cache) {
+                    if (const V4l2DeviceInfo* hit = cache->find(paths[i], query_v4l2_identity(*io, paths[i]))) {
+                        results[i].info = *hit;
+                        continue;
+                    }
+                }
+                results[i].info = probe_v4l2_device(*io, paths[i]);
+            } catch (const std::exception& e) {
+                results[i].error = e.what();
+            }
+        }
+    };
+    const std::size_t threads = std::min<std::size_t>(config.threads == 0 ? paths.size() : config.threads,
+                                                      paths.size());
+    std::vector<std::thread> workers;
+    for (std::size_t t = 1; t < threads; ++t)
+        workers.emplace_back(work);
+    work();
+    for (std::thread& worker : workers)
+        worker.join();
+
+    V4l2Enumeration enumeration;
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        Result& result = results[i];
+        if (!result.info) {
+            enumeration.failures.emplace_back(paths[i], std::move(result.error));
+            continue;
+        }
+        if (cache) {
+            if (result.info->cached)
+                ++enumeration.cache_hits;
+            else
+                cache->store(*result.info);
+        }
+        if (!config.capture_only || result.info->can_capture())
+            enumeration.devices.push_back(std::move(*result.info));
+    }
+    if (cache) {
+        // Nodes that failed to open or query (busy, no permission) still exist; keep their entries.
+        cache->retain(paths);
+        if (cache->dirty()) {
+            try {
+                cache->save();
+            } catch (const std::system_error&) {
+            }
+        }
+    }
+    return enumeration;
+}
+
+} // namespace camera_interface
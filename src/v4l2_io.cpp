@@ -0,0 +1,95 @@
+#include "camera_interface/v4l2_io.hpp"
+
+#include <cerrno>
+#include <system_error>
+
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace camera_interface {
+
+V4l2Io::~V4l2Io() = default;
+
+namespace {
+
+class SystemV4l2Io final : public V4l2Io {
+public:
+    explicit SystemV4l2Io(const std::string& path)
+        : fd_(::open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC))
+    {
+        if (fd_ < 0)
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+    }
+    ~SystemV4l2Io() override { ::close(fd_); }
+
+    int fd() const noexcept override { return fd_; }
+
+    int ioctl(unsigned long request, void* arg) noexcept override
+    {
+        int result;
+        do {
+            result = ::ioctl(fd_, request, arg);
+        } while (result < 0 && errno == EINTR);
+        return result;
+    }
+
+    void* mmap(std::size_t length, std::int64_t offset) noexcept override
+    {
+        return ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, offset);
+    }
+
+    void munmap(void* address, std::size_t length) noexcept override { ::munmap(address, length); }
+
+private:
+    int fd_;
+};
+
+} // namespace
+
+std::unique_ptr<V4l2Io> open_v4l2_device(const std::string& path)
+{
+    return std::make_unique<SystemV4l2Io>(path);
+}
+
+std::uint32_t to_v4l2_fourcc(PixelFormat format) noexcept
+{
+    switch (format) {
+    case PixelFormat::mono8: return V4L2_PIX_FMT_GREY;
+    case PixelFormat::mono16: return V4L2_PIX_FMT_Y16;
+    case PixelFormat::bayer_rggb8: return V4L2_PIX_FMT_SRGGB8;
+    case PixelFormat::bayer_bggr8: return V4L2_PIX_FMT_SBGGR8;
+    case PixelFormat::bayer_grbg8: return V4L2_PIX_FMT_SGRBG8;
+    case PixelFormat::bayer_gbrg8: return V4L2_PIX_FMT_SGBRG8;
+    case PixelFormat::yuyv: return V4L2_PIX_FMT_YUYV;
+    case PixelFormat::uyvy: return V4L2_PIX_FMT_UYVY;
+    case PixelFormat::nv12: return V4L2_PIX_FMT_NV12;
+    case PixelFormat::i420: return V4L2_PIX_FMT_YUV420;
+    case PixelFormat::rgb8: return V4L2_PIX_FMT_RGB24;
+    case PixelFormat::bgr8: return V4L2_PIX_FMT_BGR24;
+    }
+    return 0;
+}
+
+std::optional<PixelFormat> from_v4l2_fourcc(std::uint32_t fourcc) noexcept
+{
+    switch (fourcc) {
+    case V4L2_PIX_FMT_GREY: return PixelFormat::mono8;
+    case V4L2_PIX_FMT_Y16: return PixelFormat::mono16;
+    case V4L2_PIX_FMT_SRGGB8: return PixelFormat::bayer_rggb8;
+    case V4L2_PIX_FMT_SBGGR8: return PixelFormat::bayer_bggr8;
+    case V4L2_PIX_FMT_SGRBG8: return PixelFormat::bayer_grbg8;
+    case V4L2_PIX_FMT_SGBRG8: return PixelFormat::bayer_gbrg8;
+    case V4L2_PIX_FMT_YUYV: return PixelFormat::yuyv;
+    case V4L2_PIX_FMT_UYVY: return PixelFormat::uyvy;
+    case V4L2_PIX_FMT_NV12: return PixelFormat::nv12;
+    case V4L2_PIX_FMT_YUV420: return PixelFormat::i420;
+    case V4L2_PIX_FMT_RGB24: return PixelFormat::rgb8;
+    case V4L2_PIX_FMT_BGR24: return PixelFormat::bgr8;
+    default: return std::nullopt;
+    }
+}
+
+} // namespace camera_interface